@@ -0,0 +1,64 @@
+/**
+ *  @file   include/Analysis/CellEnergyHistogramReducer.hh
+ *
+ *  @brief  Header file for the CellEnergyHistogramReducer class.
+ *
+ *  $Log: $
+ */
+
+#ifndef CELL_ENERGY_HISTOGRAM_REDUCER_H
+#define CELL_ENERGY_HISTOGRAM_REDUCER_H 1
+
+#include <string>
+#include <vector>
+
+#include "Analysis/EventReducer.hh"
+
+/**
+ *  @brief CellEnergyHistogramReducer class, histograms the energy of every cell of every event, and writes the histogram to a csv file at the
+ *         end of each run.  The last row holds the cells above the last bin.
+ */
+class CellEnergyHistogramReducer : public EventReducer
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  fileName of the csv file to write
+     *  @param  nBins number of bins
+     *  @param  binWidth bin width (MeV)
+     */
+    CellEnergyHistogramReducer(const std::string &fileName, const int nBins, const double binWidth);
+
+    /**
+     *  @brief  Reset the histogram for the run
+     *
+     *  @param  runLabel label of the run
+     */
+    void BeginOfRun(const std::string &runLabel) override;
+
+    /**
+     *  @brief  Add the cells of an event to the histogram
+     *
+     *  @param  eventNumber the event number
+     *  @param  cellList the cells of the event
+     *  @param  mcParticleList the MC particles of the event
+     */
+    void ProcessEvent(const int eventNumber, const CellList &cellList, const MCParticleList &mcParticleList) override;
+
+    /**
+     *  @brief  Write the histogram to the csv file for the run
+     */
+    void EndOfRun() override;
+
+private:
+    typedef std::vector<unsigned long> ULongVector;
+
+    std::string            m_fileName;              ///< Configured csv file name
+    std::string            m_runFileName;           ///< The csv file name for the current run
+    double                 m_binWidth;              ///< Bin width (MeV)
+    ULongVector            m_nCells;                ///< Number of cells by energy, then the number above the last bin
+    unsigned int           m_nEvents;               ///< Number of events in the histogram
+};
+
+#endif // #ifndef CELL_ENERGY_HISTOGRAM_REDUCER_H
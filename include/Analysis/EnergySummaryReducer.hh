@@ -0,0 +1,57 @@
+/**
+ *  @file   include/Analysis/EnergySummaryReducer.hh
+ *
+ *  @brief  Header file for the EnergySummaryReducer class.
+ *
+ *  $Log: $
+ */
+
+#ifndef ENERGY_SUMMARY_REDUCER_H
+#define ENERGY_SUMMARY_REDUCER_H 1
+
+#include <fstream>
+#include <string>
+
+#include "Analysis/EventReducer.hh"
+
+/**
+ *  @brief EnergySummaryReducer class, writes one line of a csv file per event with the hit multiplicity, the visible energy, the primary
+ *         kinetic energy and the fraction of it contained in the detector
+ */
+class EnergySummaryReducer : public EventReducer
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  fileName of the csv file to write
+     */
+    EnergySummaryReducer(const std::string &fileName);
+
+    /**
+     *  @brief  Open the csv file for the run
+     *
+     *  @param  runLabel label of the run
+     */
+    void BeginOfRun(const std::string &runLabel) override;
+
+    /**
+     *  @brief  Write the line for an event
+     *
+     *  @param  eventNumber the event number
+     *  @param  cellList the cells of the event
+     *  @param  mcParticleList the MC particles of the event
+     */
+    void ProcessEvent(const int eventNumber, const CellList &cellList, const MCParticleList &mcParticleList) override;
+
+    /**
+     *  @brief  Close the csv file for the run
+     */
+    void EndOfRun() override;
+
+private:
+    std::string            m_fileName;              ///< Configured csv file name
+    std::ofstream          m_file;                  ///< The csv file for the current run
+};
+
+#endif // #ifndef ENERGY_SUMMARY_REDUCER_H
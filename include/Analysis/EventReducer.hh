@@ -0,0 +1,74 @@
+/**
+ *  @file   include/Analysis/EventReducer.hh
+ *
+ *  @brief  Header file for the EventReducer class.
+ *
+ *  $Log: $
+ */
+
+#ifndef EVENT_REDUCER_H
+#define EVENT_REDUCER_H 1
+
+#include <string>
+#include <vector>
+
+#include "Objects/Cell.hh"
+#include "Objects/MCParticle.hh"
+
+/**
+ *  @brief EventReducer class, interface for the in-run analysis of each event.  A reducer sees the cells and MC particles of each event once
+ *         the event has ended, before they are written out or deleted, and writes a per event table or a histogram for each run.
+ */
+class EventReducer
+{
+public:
+    /**
+     *  @brief  Destructor
+     */
+    virtual ~EventReducer();
+
+    /**
+     *  @brief  Start a run
+     *
+     *  @param  runLabel label of the run, empty unless the job has several runs, to be added to the names of the files written for the run
+     */
+    virtual void BeginOfRun(const std::string &runLabel) = 0;
+
+    /**
+     *  @brief  Reduce an event
+     *
+     *  @param  eventNumber the event number
+     *  @param  cellList the cells of the event, for the default readout
+     *  @param  mcParticleList the MC particles of the event
+     */
+    virtual void ProcessEvent(const int eventNumber, const CellList &cellList, const MCParticleList &mcParticleList) = 0;
+
+    /**
+     *  @brief  End a run, writing anything accumulated over its events
+     */
+    virtual void EndOfRun() = 0;
+
+protected:
+    /**
+     *  @brief  Get the name of a file written for a run, the configured file name with the run label added before the extension
+     *
+     *  @param  fileName the configured file name
+     *  @param  runLabel the run label
+     *
+     *  @return the file name for the run
+     */
+    static std::string GetRunFileName(const std::string &fileName, const std::string &runLabel);
+
+    /**
+     *  @brief  Get the primary MC particle with the highest energy, whose direction defines the shower axis
+     *
+     *  @param  mcParticleList the MC particles of the event
+     *
+     *  @return the leading primary MC particle, nullptr if there are no primaries
+     */
+    static const MCParticle *GetLeadingPrimary(const MCParticleList &mcParticleList);
+};
+
+typedef std::vector<EventReducer*> EventReducerVector;
+
+#endif // #ifndef EVENT_REDUCER_H
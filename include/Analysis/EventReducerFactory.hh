@@ -0,0 +1,66 @@
+/**
+ *  @file   include/Analysis/EventReducerFactory.hh
+ *
+ *  @brief  Header file for the EventReducerFactory class.
+ *
+ *  $Log: $
+ */
+
+#ifndef EVENT_REDUCER_FACTORY_H
+#define EVENT_REDUCER_FACTORY_H 1
+
+#include <map>
+#include <string>
+
+#include "ControlFlow/InputParameters.hh"
+
+class EventReducer;
+
+/**
+ *  @brief EventReducerFactory class, creates event reducers by type.  The built in EnergySummary, ShowerProfile and CellEnergyHistogram
+ *         reducers are always available, other reducers are made available by registering a creator for their type before the input
+ *         parameters are validated.
+ */
+class EventReducerFactory
+{
+public:
+    typedef EventReducer *(*Creator)(const EventReducerParameters &eventReducerParameters);
+
+    /**
+     *  @brief  Create an event reducer
+     *
+     *  @param  eventReducerParameters the event reducer parameters
+     *
+     *  @return the event reducer, owned by the caller, nullptr if the type is unknown
+     */
+    static EventReducer *Create(const EventReducerParameters &eventReducerParameters);
+
+    /**
+     *  @brief  Register a creator for an event reducer type, replacing any creator already registered for the type
+     *
+     *  @param  type the event reducer type
+     *  @param  creator the creator
+     */
+    static void Register(const std::string &type, const Creator creator);
+
+    /**
+     *  @brief  Whether a creator is registered for an event reducer type
+     *
+     *  @param  type the event reducer type
+     *
+     *  @return whether the type is registered
+     */
+    static bool IsRegistered(const std::string &type);
+
+private:
+    typedef std::map<std::string, Creator> CreatorMap;
+
+    /**
+     *  @brief  Get the registered creators, starting with the built in reducers
+     *
+     *  @return the creators, by type
+     */
+    static CreatorMap &GetCreators();
+};
+
+#endif // #ifndef EVENT_REDUCER_FACTORY_H
@@ -0,0 +1,99 @@
+/**
+ *  @file   include/Analysis/OutputComparison.hh
+ *
+ *  @brief  Header file for the OutputComparison class.
+ *
+ *  $Log: $
+ */
+
+#ifndef OUTPUT_COMPARISON_H
+#define OUTPUT_COMPARISON_H 1
+
+#include <map>
+#include <string>
+#include <vector>
+
+class TiXmlElement;
+
+/**
+ *  @brief OutputComparison class, summarises the events of two xml outputs of the same sample, such as a full simulation and a simulation
+ *         with a fast model, and prints the differences in cell energy, cell multiplicity, energy centroid and shower profiles
+ */
+class OutputComparison
+{
+public:
+    typedef std::vector<double> DoubleVector;
+
+    /**
+     *  @brief  Quantities compared between the events of two outputs
+     */
+    struct EventSummary
+    {
+        EventSummary();
+
+        unsigned int    m_nCells;           ///< Number of cells
+        double          m_energy;           ///< Summed cell energy (MeV)
+        double          m_centroidX;        ///< Energy weighted cell centroid x (mm)
+        double          m_centroidY;        ///< Energy weighted cell centroid y (mm)
+        double          m_centroidZ;        ///< Energy weighted cell centroid z (mm)
+        bool            m_hasAxis;          ///< Whether the event has a primary to define the shower axis, so has profiles
+        DoubleVector    m_longitudinal;     ///< Energy by distance along the shower axis from the primary start point (MeV)
+        DoubleVector    m_transverse;       ///< Energy by distance from the shower axis (MeV)
+    };
+
+    typedef std::map<int, EventSummary> EventSummaryMap;
+
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  nProfileBins number of bins in each shower profile
+     *  @param  profileBinWidth shower profile bin width (mm)
+     */
+    OutputComparison(const unsigned int nProfileBins, const double profileBinWidth);
+
+    /**
+     *  @brief  Summarise the default readout cells of an event xml element, the profiles are about the axis of the leading primary MC particle
+     *
+     *  @param  pEventTiXmlElement the event xml element
+     *
+     *  @return the event summary
+     */
+    EventSummary Summarise(const TiXmlElement *pEventTiXmlElement) const;
+
+    /**
+     *  @brief  Summarise each complete event in an xml output file
+     *
+     *  @param  fileName the xml output file name
+     *  @param  eventSummaries to receive the event summaries, by event number
+     *
+     *  @return whether the file was read successfully
+     */
+    bool ReadOutput(const std::string &fileName, EventSummaryMap &eventSummaries) const;
+
+    /**
+     *  @brief  Print the mean and rms of the event by event differences, and the mean shower profiles, of the events in both outputs
+     *
+     *  @param  testSummaries the event summaries of the output under test
+     *  @param  referenceSummaries the event summaries of the reference output
+     *  @param  testName the name of the output under test
+     *  @param  referenceName the name of the reference output
+     */
+    void Compare(const EventSummaryMap &testSummaries, const EventSummaryMap &referenceSummaries, const std::string &testName,
+        const std::string &referenceName) const;
+
+private:
+    /**
+     *  @brief  Get the largest difference between the cumulative distributions of two profiles, each normalised to unit area
+     *
+     *  @param  testProfile the profile of the output under test
+     *  @param  referenceProfile the profile of the reference output
+     *
+     *  @return the largest difference, zero if either profile is empty
+     */
+    static double GetMaxCumulativeDifference(const DoubleVector &testProfile, const DoubleVector &referenceProfile);
+
+    unsigned int    m_nProfileBins;         ///< Number of bins in each shower profile
+    double          m_profileBinWidth;      ///< Shower profile bin width (mm)
+};
+
+#endif // #ifndef OUTPUT_COMPARISON_H
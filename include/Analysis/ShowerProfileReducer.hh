@@ -0,0 +1,66 @@
+/**
+ *  @file   include/Analysis/ShowerProfileReducer.hh
+ *
+ *  @brief  Header file for the ShowerProfileReducer class.
+ *
+ *  $Log: $
+ */
+
+#ifndef SHOWER_PROFILE_REDUCER_H
+#define SHOWER_PROFILE_REDUCER_H 1
+
+#include <string>
+#include <vector>
+
+#include "Analysis/EventReducer.hh"
+
+/**
+ *  @brief ShowerProfileReducer class, histograms the mean energy per event along and around the shower axis, the direction of the leading
+ *         primary from its start point, and writes both profiles to a csv file at the end of each run
+ */
+class ShowerProfileReducer : public EventReducer
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  fileName of the csv file to write
+     *  @param  nBins number of bins in each profile
+     *  @param  binWidth bin width (mm)
+     */
+    ShowerProfileReducer(const std::string &fileName, const int nBins, const double binWidth);
+
+    /**
+     *  @brief  Reset the profiles for the run
+     *
+     *  @param  runLabel label of the run
+     */
+    void BeginOfRun(const std::string &runLabel) override;
+
+    /**
+     *  @brief  Add the cells of an event to the profiles, about the axis of its leading primary
+     *
+     *  @param  eventNumber the event number
+     *  @param  cellList the cells of the event
+     *  @param  mcParticleList the MC particles of the event
+     */
+    void ProcessEvent(const int eventNumber, const CellList &cellList, const MCParticleList &mcParticleList) override;
+
+    /**
+     *  @brief  Write the profiles, as the mean energy per event, to the csv file for the run
+     */
+    void EndOfRun() override;
+
+private:
+    typedef std::vector<double> DoubleVector;
+
+    std::string            m_fileName;              ///< Configured csv file name
+    std::string            m_runFileName;           ///< The csv file name for the current run
+    double                 m_binWidth;              ///< Bin width (mm)
+    DoubleVector           m_longitudinal;          ///< Energy summed over events, by distance along the shower axis (GeV)
+    DoubleVector           m_transverse;            ///< Energy summed over events, by distance from the shower axis (GeV)
+    unsigned int           m_nEvents;               ///< Number of events in the profiles
+    unsigned int           m_nSkippedEvents;        ///< Number of events without a primary to define the shower axis
+};
+
+#endif // #ifndef SHOWER_PROFILE_REDUCER_H
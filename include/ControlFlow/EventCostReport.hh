@@ -0,0 +1,154 @@
+/**
+ *  @file   include/ControlFlow/EventCostReport.hh
+ *
+ *  @brief  Header file for the EventCostReport class.
+ *
+ *  $Log: $
+ */
+
+#ifndef EVENT_COST_REPORT_H
+#define EVENT_COST_REPORT_H 1
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <string>
+
+/**
+ *  @brief EventCostReport class, records the time, step, track and output counts and memory use of each event as one line of a csv file,
+ *         and summarises the throughput of the run
+ */
+class EventCostReport
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  fileName of the csv file to write
+     */
+    EventCostReport(const std::string &fileName);
+
+    /**
+     *  @brief  Destructor
+     */
+    ~EventCostReport();
+
+    /**
+     *  @brief  Reset the counters and start timing a new event
+     */
+    void BeginOfEvent();
+
+    /**
+     *  @brief  Count a step
+     *
+     *  @param  inAbsorber whether the step is in the liquid argon
+     */
+    void AddStep(const bool inAbsorber);
+
+    /**
+     *  @brief  Count a tracked track
+     */
+    void AddTrack();
+
+    /**
+     *  @brief  Count a track killed before it was tracked
+     */
+    void AddKilledTrack();
+
+    /**
+     *  @brief  Write the cost of the current event
+     *
+     *  @param  eventNumber the event number
+     *  @param  nMCParticles number of MC particles kept
+     *  @param  nCells number of cells produced, summed over readout grids
+     *  @param  nBytes number of bytes serialised during the event
+     */
+    void EndOfEvent(const int eventNumber, const std::size_t nMCParticles, const std::size_t nCells, const std::uint64_t nBytes);
+
+    /**
+     *  @brief  Log the event and step throughput of the run
+     */
+    void PrintSummary() const;
+
+    /**
+     *  @brief  Get the number of events in the run
+     *
+     *  @return m_nEvents
+     */
+    unsigned int GetNEvents() const;
+
+    /**
+     *  @brief  Get the number of steps summed over the events in the run
+     *
+     *  @return m_totalSteps
+     */
+    std::uint64_t GetTotalSteps() const;
+
+    /**
+     *  @brief  Get the peak resident set size of the process
+     *
+     *  @return the peak resident set size (kB)
+     */
+    static long GetPeakRSS();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    std::ofstream          m_file;                  ///< The csv file
+    Clock::time_point      m_wallStart;             ///< Wall time at the start of the current event
+    std::clock_t           m_cpuStart;              ///< CPU time at the start of the current event
+    std::uint64_t          m_nAbsorberSteps;        ///< Number of steps in the liquid argon in the current event
+    std::uint64_t          m_nOtherSteps;           ///< Number of steps elsewhere in the current event
+    std::uint64_t          m_nTracks;               ///< Number of tracked tracks in the current event
+    std::uint64_t          m_nKilledTracks;         ///< Number of tracks killed before tracking in the current event
+    unsigned int           m_nEvents;               ///< Number of events in the run
+    double                 m_totalWallTime;         ///< Wall time summed over events (s)
+    double                 m_totalCPUTime;          ///< CPU time summed over events (s)
+    double                 m_maxWallTime;           ///< Largest event wall time (s)
+    std::uint64_t          m_totalSteps;            ///< Number of steps summed over events
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline void EventCostReport::AddStep(const bool inAbsorber)
+{
+    if (inAbsorber)
+    {
+        ++m_nAbsorberSteps;
+    }
+    else
+    {
+        ++m_nOtherSteps;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline void EventCostReport::AddTrack()
+{
+    ++m_nTracks;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline void EventCostReport::AddKilledTrack()
+{
+    ++m_nKilledTracks;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline unsigned int EventCostReport::GetNEvents() const
+{
+    return m_nEvents;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline std::uint64_t EventCostReport::GetTotalSteps() const
+{
+    return m_totalSteps;
+}
+
+#endif // #ifndef EVENT_COST_REPORT_H
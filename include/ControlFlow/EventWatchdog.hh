@@ -0,0 +1,83 @@
+/**
+ *  @file   include/ControlFlow/EventWatchdog.hh
+ *
+ *  @brief  Header file for the EventWatchdog class.
+ *
+ *  $Log: $
+ */
+
+#ifndef EVENT_WATCHDOG_H
+#define EVENT_WATCHDOG_H 1
+
+#include <chrono>
+#include <ctime>
+
+/**
+ *  @brief EventWatchdog class, tracks the wall and CPU time spent on the current event against a per event budget.  The clocks are only read
+ *         every few calls to Check, so it is cheap enough to call on every step.
+ */
+class EventWatchdog
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  maxWallTime wall time budget per event (s), non-positive for no wall time budget
+     *  @param  maxCPUTime CPU time budget per event (s), non-positive for no CPU time budget
+     *  @param  checkInterval number of calls to Check between reading the clocks
+     */
+    EventWatchdog(const double maxWallTime, const double maxCPUTime, const unsigned int checkInterval);
+
+    /**
+     *  @brief  Start timing a new event
+     */
+    void Start();
+
+    /**
+     *  @brief  Check whether the current event has exceeded its budget
+     *
+     *  @return whether the budget was exceeded since the last call, true only once per event
+     */
+    bool Check();
+
+    /**
+     *  @brief  Get whether the current event has exceeded its budget
+     *
+     *  @return m_expired
+     */
+    bool IsExpired() const;
+
+    /**
+     *  @brief  Get the wall time spent on the current event
+     *
+     *  @return the wall time (s)
+     */
+    double GetWallTime() const;
+
+    /**
+     *  @brief  Get the CPU time spent on the current event
+     *
+     *  @return the CPU time (s)
+     */
+    double GetCPUTime() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    double                 m_maxWallTime;           ///< Wall time budget per event (s)
+    double                 m_maxCPUTime;            ///< CPU time budget per event (s)
+    unsigned int           m_checkInterval;         ///< Number of calls to Check between reading the clocks
+    unsigned int           m_nChecks;               ///< Number of calls to Check since the clocks were last read
+    bool                   m_expired;               ///< Has the current event exceeded its budget
+    Clock::time_point      m_wallStart;             ///< Wall time at the start of the current event
+    std::clock_t           m_cpuStart;              ///< CPU time at the start of the current event
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool EventWatchdog::IsExpired() const
+{
+    return m_expired;
+}
+
+#endif // #ifndef EVENT_WATCHDOG_H
@@ -16,6 +16,74 @@
 
 typedef std::vector<GenieEvent> GenieEvents;
 
+/**
+ *  @brief ReadoutGridParameters struct, an additional readout segmentation filled from the same energy deposits as the default one
+ */
+struct ReadoutGridParameters
+{
+    std::string          m_name;                  ///< Name of the readout grid, used to label its output
+    double               m_cellSize;              ///< Cubic cell edge length (mm)
+};
+
+typedef std::vector<ReadoutGridParameters> ReadoutGridParametersVector;
+
+/**
+ *  @brief ParticleGunParameters struct, one particle gun configuration, simulated in its own run and saved to its own output file
+ */
+struct ParticleGunParameters
+{
+    std::string          m_species;               ///< Particle type to simulate
+    double               m_energy;                ///< Energy (total) of particles to simulate
+    int                  m_nParticlesPerEvent;    ///< Number of particles per event
+    std::string          m_outputFileName;        ///< Output file (xml) to write to
+    std::string          m_runLabel;              ///< Label of the run, added to the output file names when scanning
+};
+
+typedef std::vector<ParticleGunParameters> ParticleGunParametersVector;
+
+/**
+ *  @brief KillThresholdParameters struct, the kinetic energy below which new tracks of a particle species are killed and deposited locally
+ */
+struct KillThresholdParameters
+{
+    std::string          m_species;               ///< Geant4 particle name
+    double               m_energy;                ///< Kinetic energy threshold (MeV)
+};
+
+typedef std::vector<KillThresholdParameters> KillThresholdParametersVector;
+
+/**
+ *  @brief RegionParameters struct, production cuts and user limits for a detector region
+ */
+struct RegionParameters
+{
+    /**
+     *  @brief  Default constructor, production cuts fall back to the default cut and the step limit matches the historical 1 um
+     */
+    RegionParameters();
+
+    double               m_gammaCut;              ///< Gamma production range cut (mm), non-positive to use the default cut
+    double               m_electronCut;           ///< Electron production range cut (mm), non-positive to use the default cut
+    double               m_positronCut;           ///< Positron production range cut (mm), non-positive to use the default cut
+    double               m_maxStep;               ///< Maximum step length (mm)
+    double               m_minKineticEnergy;      ///< Kinetic energy below which tracks are killed (MeV)
+};
+
+/**
+ *  @brief EventReducerParameters struct, an in-run analysis of each event, writing a per event table or a histogram for each run
+ */
+struct EventReducerParameters
+{
+    std::string          m_type;                  ///< Event reducer type
+    std::string          m_fileName;              ///< Output (csv) file name
+    int                  m_nBins;                 ///< Number of histogram bins
+    double               m_binWidth;              ///< Histogram bin width, mm for shower profiles and MeV for cell energies
+};
+
+typedef std::vector<EventReducerParameters> EventReducerParametersVector;
+
+class TiXmlElement;
+
 /**
  *  @brief InputParameters class
  */
@@ -31,8 +99,9 @@ public:
      *  @brief  Constructor
      *
      *  @param  configuration xml
+     *  @param  readoutOnly whether to skip the particle gun set up and genie input, for offline tools that only need the readout
      */
-    InputParameters(const std::string &inputXmlFileName);
+    InputParameters(const std::string &inputXmlFileName, const bool readoutOnly = false);
 
     /**
      *  @brief  Destructor
@@ -46,6 +115,20 @@ public:
      */
     bool Valid() const;
 
+    /**
+     *  @brief  Check if the output file name and readout segmentation are valid, the only parameters needed to bin deposits offline
+     *
+     *  @return bool are readout parameters valid
+     */
+    bool ValidReadout() const;
+
+    /**
+     *  @brief  Check if the shower library parameters are valid, for jobs using or building the library
+     *
+     *  @return bool are shower library parameters valid
+     */
+    bool ValidShowerLibrary() const;
+
     /**
      *  @brief  Get use particle gun
      *
@@ -67,6 +150,13 @@ public:
      */
     std::string GetOutputXmlFileName() const;
 
+    /**
+     *  @brief  Get the label of the selected particle gun configuration, empty unless scanning, to add to the names of output files
+     *
+     *  @return m_runLabel
+     */
+    std::string GetRunLabel() const;
+
     /**
      *  @brief  Get particle gun energy
      *
@@ -81,6 +171,20 @@ public:
      */
     int GetParticleGunNParticlesPerEvent() const;
 
+    /**
+     *  @brief  Get the number of particle gun configurations, from the particle gun blocks and particle gun scans
+     *
+     *  @return the number of particle gun configurations
+     */
+    unsigned int GetNParticleGuns() const;
+
+    /**
+     *  @brief  Select the particle gun configuration, and its output file, returned by the particle gun getters
+     *
+     *  @param  index of the particle gun configuration
+     */
+    void SelectParticleGun(const unsigned int index);
+
     /**
      *  @brief  Get keep em shower daughter
      *
@@ -88,6 +192,34 @@ public:
      */
     bool GetKeepEMShowerDaughters() const;
 
+    /**
+     *  @brief  Whether to buffer raw energy deposits and sum them into cells at the end of each event
+     *
+     *  @return m_useBatchedDeposits
+     */
+    bool GetUseBatchedDeposits() const;
+
+    /**
+     *  @brief  Whether to write raw step deposits to a compressed archive for offline re-binning
+     *
+     *  @return m_useDepositArchive
+     */
+    bool GetUseDepositArchive() const;
+
+    /**
+     *  @brief  Get the raw step deposit archive file name
+     *
+     *  @return m_depositArchiveFileName
+     */
+    std::string GetDepositArchiveFileName() const;
+
+    /**
+     *  @brief  Get the zlib compression level for the raw step deposit archive
+     *
+     *  @return m_depositArchiveCompressionLevel
+     */
+    int GetDepositArchiveCompressionLevel() const;
+
     /**
      *  @brief  Get hit energy threshold
      *
@@ -116,6 +248,22 @@ public:
      */
     int GetGenieNEvents() const;
 
+    /**
+     *  @brief  Whether genie events are filtered before simulation
+     *
+     *  @return m_useGenieFilter
+     */
+    bool GetUseGenieFilter() const;
+
+    /**
+     *  @brief  Get the index in the genie tracker file of a simulated event, which differs from the event number once events are filtered
+     *
+     *  @param  eventNumber the simulated event number
+     *
+     *  @return the tracker file index
+     */
+    int GetGenieSourceIndex(const int eventNumber) const;
+
     /**
      *  @brief  Get the x center of the detector
      *
@@ -166,186 +314,1326 @@ public:
     int GetNLayers() const;
 
     /**
-     *  @brief  Get vector of genie events
+     *  @brief  Get the number of readout bins along x, defaults to the number of layers
      *
-     *  @return m_genieEvents
+     *  @return m_nBinsX
      */
-    GenieEvents GetGenieEvents() const;
+    int GetNBinsX() const;
 
     /**
-     *  @brief  Get maximum number of events to process
+     *  @brief  Get the number of readout bins along y, defaults to the number of layers
      *
-     *  @return m_maxNEventsToProcess
+     *  @return m_nBinsY
      */
-    int GetMaxNEventsToProcess() const;
+    int GetNBinsY() const;
 
-private:
     /**
-     *  @brief  Load input parameters via xml
+     *  @brief  Get the number of readout bins along z, defaults to the number of layers
      *
-     *  @param  inputXmlFileName
+     *  @return m_nBinsZ
      */
-    void LoadViaXml(const std::string &inputXmlFileName);
+    int GetNBinsZ() const;
 
     /**
-     *  @brief  Load events from genie tracker file
+     *  @brief  Whether to pack readout cell indices using a Morton (z-order) code rather than a linear index
+     *
+     *  @return m_useMortonCellIndex
      */
-    void LoadGenieEvents();
+    bool GetUseMortonCellIndex() const;
 
     /**
-     *  @brief  Divide string into series based on deliminator location
+     *  @brief  Get the additional readout grids, filled alongside the default readout
      *
-     *  @param  line input
-     *  @param  sep deliminator
+     *  @return m_readoutGrids
+     */
+    const ReadoutGridParametersVector &GetReadoutGrids() const;
+
+    /**
+     *  @brief  Get the event reducers, run on each event as it ends
      *
-     *  @return tokenized string
+     *  @return m_eventReducers
      */
-    static StringVector TokeniseLine(const std::string &line, const std::string &sep);
+    const EventReducerParametersVector &GetEventReducers() const;
 
-    // Particle gun setup
-    bool                 m_useParticleGun;        ///< Should generate events using G4 particle gun
-    std::string          m_species;               ///< Particle type to simulate if using particle gun
-    double               m_energy;                ///< Energy (total) of particles to simulate
-    int                  m_nParticlesPerEvent;    ///< Number of particles per event
+    /**
+     *  @brief  Get whether to write the cells and MC particles of each event to the output file
+     *
+     *  @return m_writeEventOutput
+     */
+    bool GetWriteEventOutput() const;
 
-    // Genie input
-    bool                 m_useGenieInput;         ///< Should use genie input
-    std::string          m_genieTrackerFile;      ///< Genie tracker file
-    GenieEvents          m_genieEvents;           ///< Genie events
+    /**
+     *  @brief  Get whether to write each event to a shared memory ring, for a consumer process on the same host
+     *
+     *  @return m_useSharedMemoryOutput
+     */
+    bool GetUseSharedMemoryOutput() const;
 
-    // Geant4 parameters
-    std::string          m_outputFileName;        ///< Output file (xml) to write to
-    bool                 m_keepEMShowerDaughters; ///< Should keep/discard em shower daughter mc particles
-    double               m_energyCut;             ///< Energy threshold for tracking
+    /**
+     *  @brief  Get the name of the shared memory ring, as passed to shm_open
+     *
+     *  @return m_sharedMemoryName
+     */
+    std::string GetSharedMemoryName() const;
 
-    // Detector properties
-    double               m_xCenter;               ///< X center of detector (mm)
-    double               m_yCenter;               ///< Y center of detector (mm)
-    double               m_zCenter;               ///< Z center of detector (mm)
-    double               m_xWidth;                ///< Detector width along x (mm)
-    double               m_yWidth;                ///< Detector width along y (mm)
-    double               m_zWidth;                ///< Detector width along z (mm)
-    int                  m_nLayers;               ///< Number of layers for defining 3D hit binning
-    int                  m_maxNEventsToProcess;   ///< Maximum number of events to process
-};
+    /**
+     *  @brief  Get the size of the shared memory ring
+     *
+     *  @return m_sharedMemoryCapacity (MB)
+     */
+    int GetSharedMemoryCapacity() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get the longest time to wait for the shared memory ring reader to release space for an event
+     *
+     *  @return m_sharedMemoryTimeout (s), negative to wait until it does
+     */
+    double GetSharedMemoryTimeout() const;
 
-inline bool InputParameters::GetUseParticleGun() const
-{
-    return m_useParticleGun;
-}
+    /**
+     *  @brief  Get whether to drop events the shared memory ring reader has no space for in time, rather than stop the job
+     *
+     *  @return m_sharedMemoryDropOnTimeout
+     */
+    bool GetSharedMemoryDropOnTimeout() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get whether to overlay pre-simulated background events on each event
+     *
+     *  @return m_useOverlay
+     */
+    bool GetUseOverlay() const;
 
-inline std::string InputParameters::GetParticleGunSpecies() const
-{
-    return m_species;
-}
+    /**
+     *  @brief  Get the overlay library, a raw step deposit archive
+     *
+     *  @return m_overlayLibraryFileName
+     */
+    std::string GetOverlayLibraryFileName() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get the number of background events overlaid on each event
+     *
+     *  @return m_overlayNEvents
+     */
+    int GetOverlayNEvents() const;
 
-inline std::string InputParameters::GetOutputXmlFileName() const
-{
-    return m_outputFileName;
-}
+    /**
+     *  @brief  Get the width of the time window the overlaid events are spread over, centred on the event
+     *
+     *  @return m_overlayTimeWindow (ns)
+     */
+    double GetOverlayTimeWindow() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get the drift velocity, along x, converting the time shift of an overlaid event to a shift in position
+     *
+     *  @return m_overlayDriftVelocity (mm/ns)
+     */
+    double GetOverlayDriftVelocity() const;
 
-inline double InputParameters::GetParticleGunEnergy() const
-{
-    return m_energy;
-}
+    /**
+     *  @brief  Get the largest shift of an overlaid event along y, in either direction
+     *
+     *  @return m_overlayMaxShiftY (mm)
+     */
+    double GetOverlayMaxShiftY() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get the largest shift of an overlaid event along z, in either direction
+     *
+     *  @return m_overlayMaxShiftZ (mm)
+     */
+    double GetOverlayMaxShiftZ() const;
 
-inline int InputParameters::GetParticleGunNParticlesPerEvent() const
-{
-    return m_nParticlesPerEvent;
-}
+    /**
+     *  @brief  Get the name of the reference physics list, optionally with an EM option suffix such as _EMV, _EMX or _EMZ
+     *
+     *  @return m_physicsListName
+     */
+    std::string GetPhysicsListName() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get the default production range cut
+     *
+     *  @return m_defaultProductionCut
+     */
+    double GetDefaultProductionCut() const;
 
-inline bool InputParameters::GetKeepEMShowerDaughters() const
-{
-    return m_keepEMShowerDaughters;
-}
+    /**
+     *  @brief  Get the names of the physics constructors to remove from the physics list
+     *
+     *  @return m_physicsToRemove
+     */
+    const StringVector &GetPhysicsToRemove() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get the production cuts and user limits for the world, including the non-instrumented calorimeter envelope
+     *
+     *  @return m_worldRegion
+     */
+    const RegionParameters &GetWorldRegion() const;
 
-inline double InputParameters::GetHitEnergyThreshold() const
-{
-    return m_energyCut;
-}
+    /**
+     *  @brief  Get the production cuts and user limits for the liquid argon absorber
+     *
+     *  @return m_absorberRegion
+     */
+    const RegionParameters &GetAbsorberRegion() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get whether to replace full tracking of electromagnetic showers in the absorber with a parameterisation
+     *
+     *  @return m_useEMShowerParameterisation
+     */
+    bool GetUseEMShowerParameterisation() const;
 
-inline bool InputParameters::GetUseGenieInput() const
-{
-    return m_useGenieInput;
-}
+    /**
+     *  @brief  Get the kinetic energy above which electrons, positrons and photons are parameterised
+     *
+     *  @return m_emShowerMinEnergy
+     */
+    double GetEMShowerMinEnergy() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get the energy carried by each parameterised shower spot
+     *
+     *  @return m_emShowerSpotEnergy
+     */
+    double GetEMShowerSpotEnergy() const;
 
-inline std::string InputParameters::GetGenieTrackerFile() const
-{
-    return m_genieTrackerFile;
-}
+    /**
+     *  @brief  Get the absorber radiation length used by the parameterisation
+     *
+     *  @return m_emShowerRadiationLength
+     */
+    double GetEMShowerRadiationLength() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get the absorber Moliere radius used by the parameterisation
+     *
+     *  @return m_emShowerMoliereRadius
+     */
+    double GetEMShowerMoliereRadius() const;
 
-inline int InputParameters::GetGenieNEvents() const
-{
-    return m_genieEvents.size();
-}
+    /**
+     *  @brief  Get the absorber critical energy used by the parameterisation
+     *
+     *  @return m_emShowerCriticalEnergy
+     */
+    double GetEMShowerCriticalEnergy() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get the absorber effective atomic number used by the parameterisation
+     *
+     *  @return m_emShowerEffectiveZ
+     */
+    double GetEMShowerEffectiveZ() const;
 
-inline double InputParameters::GetCenterX() const
-{
-    return m_xCenter;
-}
+    /**
+     *  @brief  Get whether to replace full tracking of low energy electromagnetic showers in the absorber with frozen library showers
+     *
+     *  @return m_useShowerLibrary
+     */
+    bool GetUseShowerLibrary() const;
 
-//------------------------------------------------------------------------------------------------------------------------------------------ 
+    /**
+     *  @brief  Get the frozen shower library file name
+     *
+     *  @return m_showerLibraryFileName
+     */
+    std::string GetShowerLibraryFileName() const;
+
+    /**
+     *  @brief  Get the kinetic energy above which electrons, positrons and photons are taken from the shower library
+     *
+     *  @return m_showerLibraryMinEnergy
+     */
+    double GetShowerLibraryMinEnergy() const;
+
+    /**
+     *  @brief  Get the kinetic energy below which electrons, positrons and photons are taken from the shower library
+     *
+     *  @return m_showerLibraryMaxEnergy
+     */
+    double GetShowerLibraryMaxEnergy() const;
+
+    /**
+     *  @brief  Get the number of (logarithmic) energy bins per particle type when building the shower library
+     *
+     *  @return m_showerLibraryNEnergyBins
+     */
+    int GetShowerLibraryNEnergyBins() const;
+
+    /**
+     *  @brief  Get the number of showers to simulate per energy bin when building the shower library
+     *
+     *  @return m_showerLibraryNShowersPerBin
+     */
+    int GetShowerLibraryNShowersPerBin() const;
+
+    /**
+     *  @brief  Get the size of the cubes in which deposits are merged into energy spots when building the shower library
+     *
+     *  @return m_showerLibrarySpotSize
+     */
+    double GetShowerLibrarySpotSize() const;
+
+    /**
+     *  @brief  Get the pdg codes of the particles simulated when building the shower library
+     *
+     *  @return m_showerLibraryPDGCodes
+     */
+    const std::vector<int> &GetShowerLibraryPDGCodes() const;
+
+    /**
+     *  @brief  Get whether to use the stacking action to kill tracks before they are tracked
+     *
+     *  @return m_useStackingAction
+     */
+    bool GetUseStackingAction() const;
+
+    /**
+     *  @brief  Get the per species kinetic energy thresholds below which new tracks are killed and deposited locally
+     *
+     *  @return m_killThresholds
+     */
+    const KillThresholdParametersVector &GetKillThresholds() const;
+
+    /**
+     *  @brief  Get the global time after which neutrons are killed, non-positive for no time window
+     *
+     *  @return m_neutronTimeWindow
+     */
+    double GetNeutronTimeWindow() const;
+
+    /**
+     *  @brief  Get whether to kill neutrinos when they are created
+     *
+     *  @return m_killNeutrinos
+     */
+    bool GetKillNeutrinos() const;
+
+    /**
+     *  @brief  Get the wall time budget per event, non-positive for no wall time budget
+     *
+     *  @return m_maxEventWallTime
+     */
+    double GetMaxEventWallTime() const;
+
+    /**
+     *  @brief  Get the CPU time budget per event, non-positive for no CPU time budget
+     *
+     *  @return m_maxEventCPUTime
+     */
+    double GetMaxEventCPUTime() const;
+
+    /**
+     *  @brief  Get the number of steps between checks of the event time budget
+     *
+     *  @return m_eventTimeBudgetCheckInterval
+     */
+    int GetEventTimeBudgetCheckInterval() const;
+
+    /**
+     *  @brief  Get whether to write the per event cost report
+     *
+     *  @return m_useEventCostReport
+     */
+    bool GetUseEventCostReport() const;
+
+    /**
+     *  @brief  Get the per event cost report file name
+     *
+     *  @return m_eventCostReportFileName
+     */
+    std::string GetEventCostReportFileName() const;
+
+    /**
+     *  @brief  Get whether to profile steps by particle type, creator process and volume
+     *
+     *  @return m_useStepProfiler
+     */
+    bool GetUseStepProfiler() const;
+
+    /**
+     *  @brief  Get the step profile file name, empty to only print the profile
+     *
+     *  @return m_stepProfilerFileName
+     */
+    std::string GetStepProfilerFileName() const;
+
+    /**
+     *  @brief  Get the number of rows of the step profile to print
+     *
+     *  @return m_stepProfilerNRows
+     */
+    int GetStepProfilerNRows() const;
+
+    /**
+     *  @brief  Get the random seed of the first event, later events use consecutive seeds.  Negative to seed each event from the clock.
+     *
+     *  @return m_randomSeed
+     */
+    long GetRandomSeed() const;
+
+    /**
+     *  @brief  Get whether to construct the visualization manager
+     *
+     *  @return m_useVisualization
+     */
+    bool GetUseVisualization() const;
+
+    /**
+     *  @brief  Get whether to store and retrieve the physics tables in the physics table cache
+     *
+     *  @return m_usePhysicsTableCache
+     */
+    bool GetUsePhysicsTableCache() const;
+
+    /**
+     *  @brief  Get the physics table cache directory, holding one subdirectory of tables per physics list and cuts
+     *
+     *  @return m_physicsTableCacheDirectory
+     */
+    std::string GetPhysicsTableCacheDirectory() const;
+
+    /**
+     *  @brief  Get the name of the lowest severity of message to log
+     *
+     *  @return m_logLevel
+     */
+    std::string GetLogLevel() const;
+
+    /**
+     *  @brief  Get the time between progress messages
+     *
+     *  @return m_progressInterval (s)
+     */
+    double GetProgressInterval() const;
+
+    /**
+     *  @brief  Get whether to write each event to the output file as it ends, rather than all events at the end of the run
+     *
+     *  @return m_streamOutput
+     */
+    bool GetStreamOutput() const;
+
+    /**
+     *  @brief  Get whether to checkpoint the streamed output, and resume from the checkpoint if there is one
+     *
+     *  @return m_useCheckpoint
+     */
+    bool GetUseCheckpoint() const;
+
+    /**
+     *  @brief  Get the checkpoint file name
+     *
+     *  @return m_checkpointFileName
+     */
+    std::string GetCheckpointFileName() const;
+
+    /**
+     *  @brief  Get the number of events between checkpoints
+     *
+     *  @return m_checkpointInterval
+     */
+    int GetCheckpointInterval() const;
+
+    /**
+     *  @brief  Get whether to record the random engine status at the start of each event
+     *
+     *  @return m_useRandomSnapshots
+     */
+    bool GetUseRandomSnapshots() const;
+
+    /**
+     *  @brief  Get the random snapshot file name
+     *
+     *  @return m_randomSnapshotFileName
+     */
+    std::string GetRandomSnapshotFileName() const;
+
+    /**
+     *  @brief  Get whether to simulate again only the replay events, from their random snapshots
+     *
+     *  @return m_useReplay
+     */
+    bool GetUseReplay() const;
+
+    /**
+     *  @brief  Get the random snapshot file to replay the events from
+     *
+     *  @return m_replaySnapshotFileName
+     */
+    std::string GetReplaySnapshotFileName() const;
+
+    /**
+     *  @brief  Get the event numbers of the events to replay
+     *
+     *  @return m_replayEvents
+     */
+    const std::vector<int> &GetReplayEvents() const;
+
+    /**
+     *  @brief  Get whether replayed events keep every MC particle and write their full trajectories
+     *
+     *  @return m_replayDetailedTrajectories
+     */
+    bool GetReplayDetailedTrajectories() const;
+
+    /**
+     *  @brief  Get vector of genie events
+     *
+     *  @return m_genieEvents
+     */
+    GenieEvents GetGenieEvents() const;
+
+    /**
+     *  @brief  Get maximum number of events to process
+     *
+     *  @return m_maxNEventsToProcess
+     */
+    int GetMaxNEventsToProcess() const;
+
+    /**
+     *  @brief  Divide string into series based on deliminator location
+     *
+     *  @param  line input
+     *  @param  sep deliminator
+     *
+     *  @return tokenized string
+     */
+    static StringVector TokeniseLine(const std::string &line, const std::string &sep);
+
+private:
+    /**
+     *  @brief  Load input parameters via xml
+     *
+     *  @param  inputXmlFileName
+     */
+    void LoadViaXml(const std::string &inputXmlFileName);
+
+    /**
+     *  @brief  Load events from genie tracker file
+     */
+    void LoadGenieEvents();
+
+    /**
+     *  @brief  Name the output file of each particle gun configuration, then select the first configuration
+     */
+    void SetUpParticleGuns();
+
+    /**
+     *  @brief  Load the production cuts and user limits for a region via xml
+     *
+     *  @param  pTiXmlElement the xml element describing the region
+     *  @param  regionParameters to receive the region parameters
+     */
+    static void LoadRegionParameters(const TiXmlElement *pTiXmlElement, RegionParameters &regionParameters);
+
+    /**
+     *  @brief  Parse a switch via xml, any text other than 0 or false (in any case) switches it on
+     *
+     *  @param  pTiXmlElement the xml element holding the switch
+     *
+     *  @return the switch value
+     */
+    static bool ParseBool(const TiXmlElement *pTiXmlElement);
+
+    /**
+     *  @brief  Check if region parameters are valid
+     *
+     *  @param  name of the region, for error messages
+     *  @param  regionParameters the region parameters
+     *
+     *  @return bool are region parameters valid
+     */
+    static bool ValidRegion(const std::string &name, const RegionParameters &regionParameters);
+
+    // Particle gun setup
+    bool                 m_useParticleGun;        ///< Should generate events using G4 particle gun
+    std::string          m_species;               ///< Particle type to simulate if using particle gun
+    double               m_energy;                ///< Energy (total) of particles to simulate
+    int                  m_nParticlesPerEvent;    ///< Number of particles per event
+    ParticleGunParametersVector m_particleGuns;   ///< Particle gun configurations, simulated in consecutive runs
+
+    // Genie input
+    bool                 m_useGenieInput;               ///< Should use genie input
+    std::string          m_genieTrackerFile;            ///< Genie tracker file
+    GenieEvents          m_genieEvents;                 ///< Genie events, only those passing the filter
+    bool                 m_useGenieFilter;              ///< Should filter genie events before simulation
+    double               m_genieFilterMinVertexX;       ///< Minimum vertex x of accepted genie events
+    double               m_genieFilterMaxVertexX;       ///< Maximum vertex x of accepted genie events
+    double               m_genieFilterMinVertexY;       ///< Minimum vertex y of accepted genie events
+    double               m_genieFilterMaxVertexY;       ///< Maximum vertex y of accepted genie events
+    double               m_genieFilterMinVertexZ;       ///< Minimum vertex z of accepted genie events
+    double               m_genieFilterMaxVertexZ;       ///< Maximum vertex z of accepted genie events
+    std::vector<int>     m_genieFilterNuanceCodes;      ///< Nuance codes of accepted genie events, all accepted if empty
+    double               m_genieFilterMinVisibleEnergy; ///< Minimum visible energy (GeV) of accepted genie events
+
+    // Geant4 parameters
+    std::string          m_outputFileName;        ///< Output file (xml) to write to
+    std::string          m_runLabel;              ///< Label of the selected particle gun configuration
+    bool                 m_keepEMShowerDaughters; ///< Should keep/discard em shower daughter mc particles
+    double               m_energyCut;             ///< Energy threshold for tracking
+    bool                 m_useBatchedDeposits;    ///< Should buffer energy deposits and sum them at the end of the event
+
+    // Raw step deposit archive
+    bool                 m_useDepositArchive;                 ///< Should write raw step deposits to an archive
+    std::string          m_depositArchiveFileName;            ///< Raw step deposit archive file name
+    int                  m_depositArchiveCompressionLevel;    ///< zlib compression level for the archive
+
+    // Physics list
+    std::string          m_physicsListName;       ///< Reference physics list name, with optional EM option suffix
+    double               m_defaultProductionCut;  ///< Default production range cut (mm)
+    StringVector         m_physicsToRemove;       ///< Physics constructors to remove from the physics list
+    RegionParameters     m_worldRegion;           ///< Production cuts and user limits for the world
+    RegionParameters     m_absorberRegion;        ///< Production cuts and user limits for the absorber
+
+    // Electromagnetic shower parameterisation
+    bool                 m_useEMShowerParameterisation;       ///< Should parameterise electromagnetic showers in the absorber
+    double               m_emShowerMinEnergy;                 ///< Kinetic energy above which showers are parameterised (MeV)
+    double               m_emShowerSpotEnergy;                ///< Energy carried by each shower spot (MeV)
+    double               m_emShowerRadiationLength;           ///< Absorber radiation length (mm)
+    double               m_emShowerMoliereRadius;             ///< Absorber Moliere radius (mm)
+    double               m_emShowerCriticalEnergy;            ///< Absorber critical energy (MeV)
+    double               m_emShowerEffectiveZ;                ///< Absorber effective atomic number
+
+    // Frozen shower library
+    bool                 m_useShowerLibrary;                  ///< Should take low energy electromagnetic showers in the absorber from a library
+    std::string          m_showerLibraryFileName;             ///< Shower library file name
+    double               m_showerLibraryMinEnergy;            ///< Kinetic energy above which showers are taken from the library (MeV)
+    double               m_showerLibraryMaxEnergy;            ///< Kinetic energy below which showers are taken from the library (MeV)
+    int                  m_showerLibraryNEnergyBins;          ///< Number of energy bins per particle type when building the library
+    int                  m_showerLibraryNShowersPerBin;       ///< Number of showers per energy bin when building the library
+    double               m_showerLibrarySpotSize;             ///< Size of the cubes merged into one energy spot when building the library (mm)
+    std::vector<int>     m_showerLibraryPDGCodes;             ///< Pdg codes of the particles simulated when building the library
+
+    // Stacking action
+    bool                 m_useStackingAction;                 ///< Should kill tracks in the stacking action before they are tracked
+    KillThresholdParametersVector m_killThresholds;           ///< Per species kinetic energy thresholds for killing new tracks
+    double               m_neutronTimeWindow;                 ///< Global time after which neutrons are killed (ns), non-positive for none
+    bool                 m_killNeutrinos;                     ///< Should kill neutrinos when they are created
+
+    // Event time budget
+    double               m_maxEventWallTime;                  ///< Wall time after which an event is aborted (s), non-positive for none
+    double               m_maxEventCPUTime;                   ///< CPU time after which an event is aborted (s), non-positive for none
+    int                  m_eventTimeBudgetCheckInterval;      ///< Number of steps between checks of the event time budget
+
+    // Event cost report
+    bool                 m_useEventCostReport;                ///< Should write the per event cost report
+    std::string          m_eventCostReportFileName;           ///< Per event cost report (csv) file name
+
+    // Step profiler
+    bool                 m_useStepProfiler;                   ///< Should profile steps by particle type, creator process and volume
+    std::string          m_stepProfilerFileName;              ///< Step profile (csv) file name, empty to only print the profile
+    int                  m_stepProfilerNRows;                 ///< Number of rows of the step profile to print
+
+    // Random numbers
+    long                 m_randomSeed;                        ///< Random seed of the job, hashed with the event number to seed each event, negative to seed from the clock
+
+    // Startup
+    bool                 m_useVisualization;                  ///< Should construct the visualization manager
+    bool                 m_usePhysicsTableCache;              ///< Should store and retrieve the physics tables in the physics table cache
+    std::string          m_physicsTableCacheDirectory;        ///< Physics table cache directory
+
+    // Logging
+    std::string          m_logLevel;                          ///< Lowest severity of message to log, debug, info, warning or error
+    double               m_progressInterval;                  ///< Time between progress messages (s), non-positive for none
+
+    // Streamed output and checkpoints
+    bool                 m_streamOutput;                      ///< Should write each event to the output file as it ends
+    bool                 m_useCheckpoint;                     ///< Should checkpoint the streamed output and resume from the checkpoint
+    std::string          m_checkpointFileName;                ///< Checkpoint file name
+    int                  m_checkpointInterval;                ///< Number of events between checkpoints
+
+    // Random snapshots and replay
+    bool                 m_useRandomSnapshots;                ///< Should record the random engine status at the start of each event
+    std::string          m_randomSnapshotFileName;            ///< Random snapshot file name
+    bool                 m_useReplay;                         ///< Should simulate again only the replay events
+    std::string          m_replaySnapshotFileName;            ///< Random snapshot file to replay the events from
+    std::vector<int>     m_replayEvents;                      ///< Event numbers of the events to replay
+    bool                 m_replayDetailedTrajectories;        ///< Should replayed events keep every MC particle and write full trajectories
+
+    // In-run analysis
+    EventReducerParametersVector m_eventReducers;             ///< Event reducers, run on each event as it ends
+    bool                 m_writeEventOutput;                  ///< Should write the cells and MC particles of each event to the output file
+
+    // Shared memory output
+    bool                 m_useSharedMemoryOutput;             ///< Should write each event to a shared memory ring
+    std::string          m_sharedMemoryName;                  ///< Name of the shared memory ring
+    int                  m_sharedMemoryCapacity;              ///< Size of the shared memory ring (MB)
+    double               m_sharedMemoryTimeout;               ///< Longest wait for space in the shared memory ring (s), negative for no limit
+    bool                 m_sharedMemoryDropOnTimeout;         ///< Should drop events on timeout, rather than stop the job
+
+    // Background overlay
+    bool                 m_useOverlay;                        ///< Should overlay pre-simulated background events on each event
+    std::string          m_overlayLibraryFileName;            ///< Overlay library, a raw step deposit archive
+    int                  m_overlayNEvents;                    ///< Number of background events overlaid on each event
+    double               m_overlayTimeWindow;                 ///< Width of the time window the overlaid events are spread over (ns)
+    double               m_overlayDriftVelocity;              ///< Drift velocity along x, converting time shifts to x shifts (mm/ns)
+    double               m_overlayMaxShiftY;                  ///< Largest shift of an overlaid event along y (mm)
+    double               m_overlayMaxShiftZ;                  ///< Largest shift of an overlaid event along z (mm)
+
+    // Detector properties
+    double               m_xCenter;               ///< X center of detector (mm)
+    double               m_yCenter;               ///< Y center of detector (mm)
+    double               m_zCenter;               ///< Z center of detector (mm)
+    double               m_xWidth;                ///< Detector width along x (mm)
+    double               m_yWidth;                ///< Detector width along y (mm)
+    double               m_zWidth;                ///< Detector width along z (mm)
+    int                  m_nLayers;               ///< Number of layers for defining 3D hit binning
+    int                  m_nBinsX;                ///< Number of readout bins along x
+    int                  m_nBinsY;                ///< Number of readout bins along y
+    int                  m_nBinsZ;                ///< Number of readout bins along z
+    bool                 m_useMortonCellIndex;    ///< Should pack cell indices using a Morton code
+    ReadoutGridParametersVector m_readoutGrids;   ///< Additional readout grids
+    int                  m_maxNEventsToProcess;   ///< Maximum number of events to process
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseParticleGun() const
+{
+    return m_useParticleGun;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline std::string InputParameters::GetParticleGunSpecies() const
+{
+    return m_species;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline std::string InputParameters::GetOutputXmlFileName() const
+{
+    return m_outputFileName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline std::string InputParameters::GetRunLabel() const
+{
+    return m_runLabel;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetParticleGunEnergy() const
+{
+    return m_energy;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetParticleGunNParticlesPerEvent() const
+{
+    return m_nParticlesPerEvent;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline unsigned int InputParameters::GetNParticleGuns() const
+{
+    return m_particleGuns.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetKeepEMShowerDaughters() const
+{
+    return m_keepEMShowerDaughters;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseBatchedDeposits() const
+{
+    return m_useBatchedDeposits;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseDepositArchive() const
+{
+    return m_useDepositArchive;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline std::string InputParameters::GetDepositArchiveFileName() const
+{
+    return m_depositArchiveFileName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetDepositArchiveCompressionLevel() const
+{
+    return m_depositArchiveCompressionLevel;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetHitEnergyThreshold() const
+{
+    return m_energyCut;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseGenieInput() const
+{
+    return m_useGenieInput;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline std::string InputParameters::GetGenieTrackerFile() const
+{
+    return m_genieTrackerFile;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetGenieNEvents() const
+{
+    return m_genieEvents.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseGenieFilter() const
+{
+    return m_useGenieFilter;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetGenieSourceIndex(const int eventNumber) const
+{
+    return m_genieEvents.at(eventNumber).GetSourceIndex();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetCenterX() const
+{
+    return m_xCenter;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetCenterY() const
+{
+    return m_yCenter;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetCenterZ() const
+{
+    return m_zCenter;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetWidthX() const
+{
+    return m_xWidth;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetWidthY() const
+{
+    return m_yWidth;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetWidthZ() const
+{
+    return m_zWidth;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetNLayers() const
+{
+    return m_nLayers;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetNBinsX() const
+{
+    return (m_nBinsX > 0 ? m_nBinsX : m_nLayers);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetNBinsY() const
+{
+    return (m_nBinsY > 0 ? m_nBinsY : m_nLayers);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetNBinsZ() const
+{
+    return (m_nBinsZ > 0 ? m_nBinsZ : m_nLayers);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseMortonCellIndex() const
+{
+    return m_useMortonCellIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline const ReadoutGridParametersVector &InputParameters::GetReadoutGrids() const
+{
+    return m_readoutGrids;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline const EventReducerParametersVector &InputParameters::GetEventReducers() const
+{
+    return m_eventReducers;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetWriteEventOutput() const
+{
+    return m_writeEventOutput;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseSharedMemoryOutput() const
+{
+    return m_useSharedMemoryOutput;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline std::string InputParameters::GetSharedMemoryName() const
+{
+    return m_sharedMemoryName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetSharedMemoryCapacity() const
+{
+    return m_sharedMemoryCapacity;
+}
 
-inline double InputParameters::GetCenterY() const
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetSharedMemoryTimeout() const
 {
-    return m_yCenter;
+    return m_sharedMemoryTimeout;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
-inline double InputParameters::GetCenterZ() const
+inline bool InputParameters::GetSharedMemoryDropOnTimeout() const
 {
-    return m_zCenter;
+    return m_sharedMemoryDropOnTimeout;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
-inline double InputParameters::GetWidthX() const
+inline bool InputParameters::GetUseOverlay() const
 {
-    return m_xWidth;
+    return m_useOverlay;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
-inline double InputParameters::GetWidthY() const
+inline std::string InputParameters::GetOverlayLibraryFileName() const
 {
-    return m_yWidth;
+    return m_overlayLibraryFileName;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
-inline double InputParameters::GetWidthZ() const
+inline int InputParameters::GetOverlayNEvents() const
 {
-    return m_zWidth;
+    return m_overlayNEvents;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
-inline int InputParameters::GetNLayers() const
+inline double InputParameters::GetOverlayTimeWindow() const
 {
-    return m_nLayers;
+    return m_overlayTimeWindow;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetOverlayDriftVelocity() const
+{
+    return m_overlayDriftVelocity;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetOverlayMaxShiftY() const
+{
+    return m_overlayMaxShiftY;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetOverlayMaxShiftZ() const
+{
+    return m_overlayMaxShiftZ;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline std::string InputParameters::GetPhysicsListName() const
+{
+    return m_physicsListName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetDefaultProductionCut() const
+{
+    return m_defaultProductionCut;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline const StringVector &InputParameters::GetPhysicsToRemove() const
+{
+    return m_physicsToRemove;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline const RegionParameters &InputParameters::GetWorldRegion() const
+{
+    return m_worldRegion;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline const RegionParameters &InputParameters::GetAbsorberRegion() const
+{
+    return m_absorberRegion;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseEMShowerParameterisation() const
+{
+    return m_useEMShowerParameterisation;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetEMShowerMinEnergy() const
+{
+    return m_emShowerMinEnergy;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetEMShowerSpotEnergy() const
+{
+    return m_emShowerSpotEnergy;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetEMShowerRadiationLength() const
+{
+    return m_emShowerRadiationLength;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetEMShowerMoliereRadius() const
+{
+    return m_emShowerMoliereRadius;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetEMShowerCriticalEnergy() const
+{
+    return m_emShowerCriticalEnergy;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetEMShowerEffectiveZ() const
+{
+    return m_emShowerEffectiveZ;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseShowerLibrary() const
+{
+    return m_useShowerLibrary;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline std::string InputParameters::GetShowerLibraryFileName() const
+{
+    return m_showerLibraryFileName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetShowerLibraryMinEnergy() const
+{
+    return m_showerLibraryMinEnergy;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetShowerLibraryMaxEnergy() const
+{
+    return m_showerLibraryMaxEnergy;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetShowerLibraryNEnergyBins() const
+{
+    return m_showerLibraryNEnergyBins;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetShowerLibraryNShowersPerBin() const
+{
+    return m_showerLibraryNShowersPerBin;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetShowerLibrarySpotSize() const
+{
+    return m_showerLibrarySpotSize;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline const std::vector<int> &InputParameters::GetShowerLibraryPDGCodes() const
+{
+    return m_showerLibraryPDGCodes;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseStackingAction() const
+{
+    return m_useStackingAction;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline const KillThresholdParametersVector &InputParameters::GetKillThresholds() const
+{
+    return m_killThresholds;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetNeutronTimeWindow() const
+{
+    return m_neutronTimeWindow;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetKillNeutrinos() const
+{
+    return m_killNeutrinos;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetMaxEventWallTime() const
+{
+    return m_maxEventWallTime;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double InputParameters::GetMaxEventCPUTime() const
+{
+    return m_maxEventCPUTime;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetEventTimeBudgetCheckInterval() const
+{
+    return m_eventTimeBudgetCheckInterval;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseEventCostReport() const
+{
+    return m_useEventCostReport;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline std::string InputParameters::GetEventCostReportFileName() const
+{
+    return m_eventCostReportFileName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline bool InputParameters::GetUseStepProfiler() const
+{
+    return m_useStepProfiler;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline std::string InputParameters::GetStepProfilerFileName() const
+{
+    return m_stepProfilerFileName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int InputParameters::GetStepProfilerNRows() const
+{
+    return m_stepProfilerNRows;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline long InputParameters::GetRandomSeed() const
+{
+    return m_randomSeed;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool InputParameters::GetUseVisualization() const
+{
+    return m_useVisualization;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool InputParameters::GetUsePhysicsTableCache() const
+{
+    return m_usePhysicsTableCache;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::string InputParameters::GetPhysicsTableCacheDirectory() const
+{
+    return m_physicsTableCacheDirectory;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::string InputParameters::GetLogLevel() const
+{
+    return m_logLevel;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double InputParameters::GetProgressInterval() const
+{
+    return m_progressInterval;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool InputParameters::GetStreamOutput() const
+{
+    return m_streamOutput;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool InputParameters::GetUseCheckpoint() const
+{
+    return m_useCheckpoint;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::string InputParameters::GetCheckpointFileName() const
+{
+    return m_checkpointFileName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline int InputParameters::GetCheckpointInterval() const
+{
+    return m_checkpointInterval;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool InputParameters::GetUseRandomSnapshots() const
+{
+    return m_useRandomSnapshots;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::string InputParameters::GetRandomSnapshotFileName() const
+{
+    return m_randomSnapshotFileName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool InputParameters::GetUseReplay() const
+{
+    return m_useReplay;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::string InputParameters::GetReplaySnapshotFileName() const
+{
+    return m_replaySnapshotFileName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const std::vector<int> &InputParameters::GetReplayEvents() const
+{
+    return m_replayEvents;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool InputParameters::GetReplayDetailedTrajectories() const
+{
+    return m_replayDetailedTrajectories;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
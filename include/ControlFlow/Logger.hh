@@ -0,0 +1,96 @@
+/**
+ *  @file   include/ControlFlow/Logger.hh
+ *
+ *  @brief  Header file for the Logger class.
+ *
+ *  $Log: $
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H 1
+
+#include <string>
+
+/**
+ *  @brief Logger class, writes messages at or above the configured severity to a buffered standard output sink.  The sink is only flushed
+ *         when the buffer fills, on warnings and errors, at each progress report and at exit, so info and debug messages never force a flush
+ *         per message.
+ */
+class Logger
+{
+public:
+    /**
+     *  @brief  Message severity, in increasing order
+     */
+    enum Severity
+    {
+        DEBUG,
+        INFO,
+        WARNING,
+        ERROR
+    };
+
+    /**
+     *  @brief  Set the lowest severity to write
+     *
+     *  @param  level the lowest severity to write
+     */
+    static void SetLevel(const Severity level);
+
+    /**
+     *  @brief  Whether messages of a severity are written, to skip building messages that would be dropped
+     *
+     *  @param  severity the message severity
+     *
+     *  @return whether messages of the severity are written
+     */
+    static bool IsEnabled(const Severity severity);
+
+    /**
+     *  @brief  Write a message
+     *
+     *  @param  severity the message severity
+     *  @param  message the message, without a trailing new line
+     */
+    static void Write(const Severity severity, const std::string &message);
+
+    /**
+     *  @brief  Flush the buffered messages to standard output
+     */
+    static void Flush();
+
+    /**
+     *  @brief  Get the severity with a name, one of debug, info, warning or error in any case
+     *
+     *  @param  name the severity name
+     *  @param  severity to receive the severity
+     *
+     *  @return whether the name is a severity
+     */
+    static bool GetSeverity(const std::string &name, Severity &severity);
+
+private:
+    /**
+     *  @brief  Constructor
+     */
+    Logger();
+
+    /**
+     *  @brief  Destructor, flushes the buffered messages
+     */
+    ~Logger();
+
+    /**
+     *  @brief  Get the logger
+     *
+     *  @return the logger
+     */
+    static Logger &GetInstance();
+
+    static const std::size_t BUFFER_SIZE = 1 << 16;   ///< Size of the buffered messages at which the sink is flushed
+
+    Severity               m_level;                 ///< Lowest severity to write
+    std::string            m_buffer;                ///< Messages not yet written to standard output
+};
+
+#endif // #ifndef LOGGER_H
@@ -0,0 +1,62 @@
+/**
+ *  @file   include/ControlFlow/ProgressReporter.hh
+ *
+ *  @brief  Header file for the ProgressReporter class.
+ *
+ *  $Log: $
+ */
+
+#ifndef PROGRESS_REPORTER_H
+#define PROGRESS_REPORTER_H 1
+
+#include <chrono>
+
+/**
+ *  @brief ProgressReporter class, logs the number of events processed, the event rate and the time remaining at a fixed time interval,
+ *         rather than once per event
+ */
+class ProgressReporter
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  interval time between progress messages (s)
+     */
+    ProgressReporter(const double interval);
+
+    /**
+     *  @brief  Start reporting the progress of a run
+     *
+     *  @param  nEventsToProcess number of events the run will process
+     */
+    void BeginOfRun(const int nEventsToProcess);
+
+    /**
+     *  @brief  Count a processed event, logging the progress if the interval has passed since the last message
+     */
+    void EndOfEvent();
+
+    /**
+     *  @brief  Log the number of events processed and the event rate of the run
+     */
+    void EndOfRun();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     *  @brief  Log the progress of the run
+     *
+     *  @param  now the current time
+     */
+    void Report(const Clock::time_point &now) const;
+
+    double                 m_interval;              ///< Time between progress messages (s)
+    int                    m_nEventsToProcess;      ///< Number of events the run will process
+    int                    m_nEvents;               ///< Number of events processed in the run
+    Clock::time_point      m_start;                 ///< Start time of the run
+    Clock::time_point      m_nextReport;            ///< Time of the next progress message
+};
+
+#endif // #ifndef PROGRESS_REPORTER_H
@@ -0,0 +1,121 @@
+/**
+ *  @file   include/ControlFlow/StepProfiler.hh
+ *
+ *  @brief  Header file for the StepProfiler class.
+ *
+ *  $Log: $
+ */
+
+#ifndef STEP_PROFILER_H
+#define STEP_PROFILER_H 1
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+class G4ParticleDefinition;
+class G4Step;
+class G4Track;
+class G4VPhysicalVolume;
+class G4VProcess;
+
+/**
+ *  @brief StepProfiler class, accumulates the number of steps, track length and stepping time per (particle type, creator process, volume).
+ *         Counters are looked up once per track and volume, and the clock is read once per step.  The user actions are built per thread, so
+ *         each thread fills its own profiler.
+ */
+class StepProfiler
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  fileName of the csv file to receive the full report, empty for no file
+     *  @param  nRows number of rows of the report to print
+     */
+    StepProfiler(const std::string &fileName, const unsigned int nRows);
+
+    /**
+     *  @brief  Start profiling a new track
+     *
+     *  @param  pG4Track the track
+     */
+    void BeginOfTrack(const G4Track *pG4Track);
+
+    /**
+     *  @brief  Add a step of the current track
+     *
+     *  @param  pG4Step the step
+     */
+    void AddStep(const G4Step *pG4Step);
+
+    /**
+     *  @brief  Finish profiling the current track
+     */
+    void EndOfTrack();
+
+    /**
+     *  @brief  Log the profile sorted by stepping time, and write the full profile to file if requested
+     */
+    void WriteReport() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     *  @brief Key struct, the categories steps are profiled by
+     */
+    struct Key
+    {
+        /**
+         *  @brief  Equality operator
+         *
+         *  @param  rhs the key to compare with
+         *
+         *  @return are the keys equal
+         */
+        bool operator==(const Key &rhs) const;
+
+        const G4ParticleDefinition *m_pParticleDefinition;    ///< Particle type
+        const G4VProcess           *m_pCreatorProcess;        ///< Creator process, nullptr for primaries
+        const G4VPhysicalVolume    *m_pVolume;                ///< Pre step point volume
+    };
+
+    /**
+     *  @brief KeyHasher struct
+     */
+    struct KeyHasher
+    {
+        /**
+         *  @brief  Hash a key
+         *
+         *  @param  key the key
+         *
+         *  @return the hash
+         */
+        std::size_t operator()(const Key &key) const;
+    };
+
+    /**
+     *  @brief Counters struct, the accumulated cost of one category
+     */
+    struct Counters
+    {
+        std::uint64_t               m_nTrackSegments;         ///< Number of track segments, a track entering the volume starts a new segment
+        std::uint64_t               m_nSteps;                 ///< Number of steps
+        double                      m_trackLength;            ///< Summed step length (mm)
+        double                      m_time;                   ///< Summed stepping time (s)
+    };
+
+    typedef std::unordered_map<Key, Counters, KeyHasher> KeyCountersMap;
+
+    std::string                     m_fileName;               ///< File to receive the full report, empty for no file
+    unsigned int                    m_nRows;                  ///< Number of rows of the report to print
+    KeyCountersMap                  m_counters;               ///< Accumulated cost per category
+    Key                             m_currentKey;             ///< Category of the current track and volume
+    Counters                       *m_pCurrentCounters;       ///< Counters for the current track and volume, nullptr if not yet looked up
+    Clock::time_point               m_lastTime;               ///< Time at the end of the previous step of the current track
+};
+
+#endif // #ifndef STEP_PROFILER_H
@@ -36,11 +36,17 @@
 
 #include "globals.hh"
 #include <math.h>
+#include <vector>
 
 class G4VPhysicalVolume;
+class G4Region;
 class G4UserLimits;
 class G4Step;
+class G4ProductionCuts;
+class G4TPCSteppingAction;
 class InputParameters;
+struct RegionParameters;
+class VoxelGrid;
 
 class G4TPCDetectorConstruction : public G4VUserDetectorConstruction
 {
@@ -64,6 +70,18 @@ public:
     */
     G4VPhysicalVolume *Construct() override;
 
+    /**
+    *  @brief  Create the fast simulation models, requires the stepping action to have been set
+    */
+    void ConstructSDandField() override;
+
+    /**
+    *  @brief  Set the stepping action, which receives the energy deposited by fast simulation models
+    *
+    *  @param  pG4TPCSteppingAction the stepping action
+    */
+    void SetSteppingAction(G4TPCSteppingAction *pG4TPCSteppingAction);
+
     /**
     *  @brief  Get the LArTPC physical volume
     *
@@ -71,6 +89,13 @@ public:
     */
     const G4VPhysicalVolume *GetLArPV() const;
 
+    /**
+    *  @brief  Get the liquid argon absorber region
+    *
+    *  @return the absorber region
+    */
+    G4Region *GetAbsorberRegion() const;
+
     /**
     *  @brief  Get the index of the cell for the given position
     *
@@ -80,6 +105,22 @@ public:
     */
     Cell GetCell(const G4Step *pG4Step) const;
 
+    /**
+    *  @brief  Get the number of readout voxel grids, the default readout followed by any additional readout grids
+    *
+    *  @return the number of voxel grids
+    */
+    unsigned int GetNVoxelGrids() const;
+
+    /**
+    *  @brief  Get a readout voxel grid
+    *
+    *  @param  gridIndex index of the grid, zero for the default readout
+    *
+    *  @return the voxel grid
+    */
+    const VoxelGrid &GetVoxelGrid(const unsigned int gridIndex = 0) const;
+
 private:
     /**
     *  @brief  Create materials used in simulation
@@ -93,18 +134,37 @@ private:
     */
     G4VPhysicalVolume *DefineVolumes();
 
-    double             m_xCenter;              ///< X center of LArTPC
-    double             m_yCenter;              ///< Y center of LArTPC
-    double             m_zCenter;              ///< Z center of LArTPC
-    double             m_xWidth;               ///< X width of LArTPC
-    double             m_yWidth;               ///< Y width of LArTPC
-    double             m_zWidth;               ///< Z width of LArTPC
-    double             m_xLow;                 ///< Low x point in detector
-    double             m_yLow;                 ///< Low y point in detector
-    double             m_zLow;                 ///< Low z point in detector
-    int                m_nLayers;              ///< Number of layers in detector
-    G4VPhysicalVolume *m_pG4LogicalVolumeLAr;  ///< The absorber physical volume
-    bool               m_checkOverlaps;        ///< Option to activate checking of volumes overlaps
+    /**
+    *  @brief  Create the production cuts for a region, falling back to the default cut for any cut not specified
+    *
+    *  @param  regionParameters the region parameters
+    *
+    *  @return the production cuts
+    */
+    G4ProductionCuts *CreateProductionCuts(const RegionParameters &regionParameters) const;
+
+    /**
+    *  @brief  Create the user limits for a region
+    *
+    *  @param  regionParameters the region parameters
+    *
+    *  @return the user limits
+    */
+    G4UserLimits *CreateUserLimits(const RegionParameters &regionParameters) const;
+
+    double                  m_xCenter;               ///< X center of LArTPC
+    double                  m_yCenter;               ///< Y center of LArTPC
+    double                  m_zCenter;               ///< Z center of LArTPC
+    double                  m_xWidth;                ///< X width of LArTPC
+    double                  m_yWidth;                ///< Y width of LArTPC
+    double                  m_zWidth;                ///< Z width of LArTPC
+    int                     m_nLayers;               ///< Number of layers in detector
+    std::vector<VoxelGrid*> m_voxelGrids;            ///< Readout voxel grids, the default readout first
+    G4VPhysicalVolume      *m_pG4LogicalVolumeLAr;   ///< The absorber physical volume
+    G4Region               *m_pAbsorberRegion;       ///< The absorber region
+    G4TPCSteppingAction    *m_pG4TPCSteppingAction;  ///< Stepping action, receives fast simulation energy deposits
+    const InputParameters  *m_pInputParameters;      ///< Input parameters
+    bool                    m_checkOverlaps;         ///< Option to activate checking of volumes overlaps
 };
 
 //------------------------------------------------------------------------------
@@ -114,5 +174,33 @@ inline const G4VPhysicalVolume *G4TPCDetectorConstruction::GetLArPV() const
     return m_pG4LogicalVolumeLAr;
 }
 
+//------------------------------------------------------------------------------
+
+inline void G4TPCDetectorConstruction::SetSteppingAction(G4TPCSteppingAction *pG4TPCSteppingAction)
+{
+    m_pG4TPCSteppingAction = pG4TPCSteppingAction;
+}
+
+//------------------------------------------------------------------------------
+
+inline G4Region *G4TPCDetectorConstruction::GetAbsorberRegion() const
+{
+    return m_pAbsorberRegion;
+}
+
+//------------------------------------------------------------------------------
+
+inline unsigned int G4TPCDetectorConstruction::GetNVoxelGrids() const
+{
+    return m_voxelGrids.size();
+}
+
+//------------------------------------------------------------------------------
+
+inline const VoxelGrid &G4TPCDetectorConstruction::GetVoxelGrid(const unsigned int gridIndex) const
+{
+    return *m_voxelGrids.at(gridIndex);
+}
+
 #endif
 
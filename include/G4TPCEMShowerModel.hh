@@ -0,0 +1,95 @@
+/**
+ *  @file   include/G4TPCEMShowerModel.hh
+ *
+ *  @brief  Header file for the geant4 parameterised electromagnetic shower fast simulation model.
+ *
+ *  $Log: $
+ */
+
+#ifndef GEANT4_EM_SHOWER_MODEL_H
+#define GEANT4_EM_SHOWER_MODEL_H 1
+
+#include "globals.hh"
+
+#include "G4ThreeVector.hh"
+#include "G4VFastSimulationModel.hh"
+
+class G4Region;
+class G4TPCDetectorConstruction;
+class G4TPCSteppingAction;
+class InputParameters;
+
+/**
+ *  @brief  G4TPCEMShowerModel class.  Replaces full tracking of electrons, positrons and photons above a threshold with energy spots
+ *          sampled from the Grindhammer longitudinal and radial profiles for homogeneous media (as used by GFlash), deposited through the
+ *          stepping action so they reach every readout grid, the deposit buffer and the deposit archive.
+ */
+class G4TPCEMShowerModel : public G4VFastSimulationModel
+{
+public:
+    /**
+    *  @brief  Constructor
+    *
+    *  @param  name of the model
+    *  @param  pG4Region the region in which to apply the model
+    *  @param  pG4TPCDetectorConstruction detector properties
+    *  @param  pG4TPCSteppingAction stepping action, receives the shower spots
+    *  @param  pInputParameters input parameters
+    */
+    G4TPCEMShowerModel(const G4String &name, G4Region *pG4Region, const G4TPCDetectorConstruction *pG4TPCDetectorConstruction,
+        G4TPCSteppingAction *pG4TPCSteppingAction, const InputParameters *pInputParameters);
+
+    /**
+    *  @brief  Destructor
+    */
+    ~G4TPCEMShowerModel() override;
+
+    /**
+    *  @brief  Whether the model applies to a particle type
+    *
+    *  @param  particleDefinition the particle type
+    *
+    *  @return is particle an electron, positron or photon
+    */
+    G4bool IsApplicable(const G4ParticleDefinition &particleDefinition) override;
+
+    /**
+    *  @brief  Whether to parameterise the current track
+    *
+    *  @param  fastTrack the current track
+    *
+    *  @return is track energetic enough to be parameterised
+    */
+    G4bool ModelTrigger(const G4FastTrack &fastTrack) override;
+
+    /**
+    *  @brief  Kill the current track and deposit its energy as parameterised shower spots, photon showers starting at a sampled conversion
+    *          point and positron showers including the annihilation energy
+    *
+    *  @param  fastTrack the current track
+    *  @param  fastStep to receive the track status
+    */
+    void DoIt(const G4FastTrack &fastTrack, G4FastStep &fastStep) override;
+
+private:
+    /**
+    *  @brief  Sample the radial distance of a spot from the shower axis
+    *
+    *  @param  tau depth of the spot in units of the shower maximum depth
+    *  @param  logEnergy natural log of the shower energy in GeV
+    *
+    *  @return radial distance in Moliere radii
+    */
+    double SampleRadius(const double tau, const double logEnergy) const;
+
+    const G4TPCDetectorConstruction    *m_pG4TPCDetectorConstruction;    ///< Detector construction class
+    G4TPCSteppingAction                *m_pG4TPCSteppingAction;          ///< Stepping action class, receives the shower spots
+    double                              m_minEnergy;                     ///< Kinetic energy above which showers are parameterised
+    double                              m_spotEnergy;                    ///< Energy carried by each shower spot
+    double                              m_radiationLength;               ///< Absorber radiation length
+    double                              m_moliereRadius;                 ///< Absorber Moliere radius
+    double                              m_criticalEnergy;                ///< Absorber critical energy
+    double                              m_effectiveZ;                    ///< Absorber effective atomic number
+};
+
+#endif // #ifndef GEANT4_EM_SHOWER_MODEL_H
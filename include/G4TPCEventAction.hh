@@ -40,6 +40,8 @@
 #include <map>
 #include <vector>
 
+class G4TPCDetectorConstruction;
+
 /**
 *  @brief  G4TPCEventAction class
 */
@@ -51,8 +53,10 @@ public:
     *
     *  @param  pEventContainer event information
     *  @param  pG4TPCMCParticleUserAction MCParticle information
+    *  @param  pG4TPCDetectorConstruction detector properties
     */
-    G4TPCEventAction(EventContainer *pEventContainer, G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction);
+    G4TPCEventAction(EventContainer *pEventContainer, G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction,
+        const G4TPCDetectorConstruction *pG4TPCDetectorConstruction);
 
     /**
     *  @brief  Destrucctor
@@ -74,8 +78,9 @@ public:
     virtual void EndOfEventAction(const G4Event *pG4Event) override;
 
 private:
-    EventContainer             *m_pEventContainer;             ///< Event information
-    G4TPCMCParticleUserAction  *m_pG4TPCMCParticleUserAction;  ///< MC particle information
+    EventContainer                    *m_pEventContainer;             ///< Event information
+    G4TPCMCParticleUserAction         *m_pG4TPCMCParticleUserAction;  ///< MC particle information
+    const G4TPCDetectorConstruction   *m_pG4TPCDetectorConstruction;  ///< Detector construction class
 };
 
 #endif
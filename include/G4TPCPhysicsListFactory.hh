@@ -0,0 +1,68 @@
+/**
+ *  @file   include/G4TPCPhysicsListFactory.hh
+ *
+ *  @brief  Header file for the geant4 physics list factory class.
+ *
+ *  $Log: $
+ */
+
+#ifndef GEANT4_PHYSICS_LIST_FACTORY_H
+#define GEANT4_PHYSICS_LIST_FACTORY_H 1
+
+#include "globals.hh"
+
+class G4VModularPhysicsList;
+class InputParameters;
+
+/**
+ *  @brief  G4TPCPhysicsListFactory class
+ */
+class G4TPCPhysicsListFactory
+{
+public:
+    /**
+    *  @brief  Create the configured reference physics list, with the step limiter, any fast simulation and the world production cuts
+    *
+    *  @param  inputParameters input parameters
+    *
+    *  @return the physics list, nullptr if the configured physics list is unknown
+    */
+    static G4VModularPhysicsList *Create(const InputParameters &inputParameters);
+
+    /**
+    *  @brief  Store the physics tables in the physics table cache, if the cache is used and holds no tables for this physics list and cuts.
+    *          Call after the first run, once geant4 has built the tables.
+    *
+    *  @param  inputParameters input parameters
+    *  @param  pG4VModularPhysicsList the physics list created from the input parameters
+    */
+    static void StorePhysicsTables(const InputParameters &inputParameters, G4VModularPhysicsList *pG4VModularPhysicsList);
+
+private:
+    /**
+    *  @brief  Get the physics table cache subdirectory for the configured physics list and cuts
+    *
+    *  @param  inputParameters input parameters
+    *
+    *  @return the physics table directory
+    */
+    static std::string GetPhysicsTableDirectory(const InputParameters &inputParameters);
+
+    /**
+    *  @brief  Whether a physics table directory holds a complete set of stored tables
+    *
+    *  @param  directory the physics table directory
+    *
+    *  @return whether the tables are complete
+    */
+    static bool IsComplete(const std::string &directory);
+
+    /**
+    *  @brief  Remove a physics table directory and the tables in it
+    *
+    *  @param  directory the physics table directory
+    */
+    static void RemoveDirectory(const std::string &directory);
+};
+
+#endif // #ifndef GEANT4_PHYSICS_LIST_FACTORY_H
@@ -31,6 +31,8 @@
 #ifndef G4TPCPrimaryGeneratorAction_h
 #define G4TPCPrimaryGeneratorAction_h 1
 
+#include <cstdint>
+
 #include "G4VUserPrimaryGeneratorAction.hh"
 #include "globals.hh"
 
@@ -52,7 +54,7 @@ public:
     *  @param  pEventContainer event container
     *  @param  pInputParameters input parameters
     */
-    G4TPCPrimaryGeneratorAction(const EventContainer *pEventContainer, const InputParameters *pInputParameters);
+    G4TPCPrimaryGeneratorAction(EventContainer *pEventContainer, const InputParameters *pInputParameters);
 
     /**
     *  @brief  Destructor
@@ -74,9 +76,35 @@ private:
      */
     void LoadNextGenieEvent(G4Event *pG4Event);
 
+    /**
+     *  @brief  Get the seed of an event in a fixed seed job, hashing the configured seed with the event number
+     *
+     *  @param  randomSeed the configured random seed
+     *  @param  eventNumber the event number
+     *
+     *  @return the event seed
+     */
+    static long GetEventSeed(const long randomSeed, const int eventNumber);
+
+    /**
+     *  @brief  Seed the random engine with two seeds derived from an event seed
+     *
+     *  @param  seed the event seed
+     */
+    static void SetEngineSeeds(const long seed);
+
+    /**
+     *  @brief  Mix the bits of a 64 bit value, the splitmix64 finaliser
+     *
+     *  @param  value the value
+     *
+     *  @return the mixed value
+     */
+    static std::uint64_t MixBits(const std::uint64_t value);
+
     G4ParticleGun          *m_pG4ParticleGun;       ///< G4 particle gun
     const InputParameters  *m_pInputParameters;     ///< Input parameters
-    const EventContainer   *m_pEventContainer;      ///< Event container
+    EventContainer         *m_pEventContainer;      ///< Event container
 };
 
 #endif
@@ -46,8 +46,9 @@ public:
     *
     *  @param  pEventContainer event information
     *  @param  pG4TPCMCParticleUserAction MCParticle user actions
+    *  @param  pInputParameters input parameters
     */
-    G4TPCRunAction(EventContainer *pEventContainer, G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction);
+    G4TPCRunAction(EventContainer *pEventContainer, G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction, const InputParameters *pInputParameters);
 
     /**
     *  @brief  Destructor
@@ -68,9 +69,24 @@ public:
     */
     void EndOfRunAction(const G4Run *pG4Run) override;
 
+    /**
+    *  @brief  Get the event information
+    *
+    *  @return the event container
+    */
+    EventContainer *GetEventContainer() const;
+
 private:
     EventContainer            *m_pEventContainer;             ///< Event information
     G4TPCMCParticleUserAction *m_pG4TPCMCParticleUserAction;  ///< MCParticle user actions
+    const InputParameters     *m_pInputParameters;            ///< Input parameters
 };
 
+//------------------------------------------------------------------------------
+
+inline EventContainer *G4TPCRunAction::GetEventContainer() const
+{
+    return m_pEventContainer;
+}
+
 #endif
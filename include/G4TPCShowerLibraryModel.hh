@@ -0,0 +1,81 @@
+/**
+ *  @file   include/G4TPCShowerLibraryModel.hh
+ *
+ *  @brief  Header file for the geant4 frozen shower library fast simulation model.
+ *
+ *  $Log: $
+ */
+
+#ifndef GEANT4_SHOWER_LIBRARY_MODEL_H
+#define GEANT4_SHOWER_LIBRARY_MODEL_H 1
+
+#include "globals.hh"
+
+#include "G4VFastSimulationModel.hh"
+
+class G4Region;
+class G4TPCDetectorConstruction;
+class G4TPCSteppingAction;
+class InputParameters;
+class ShowerLibraryReader;
+
+/**
+ *  @brief  G4TPCShowerLibraryModel class.  Replaces full tracking of low energy electrons, positrons and photons with a shower drawn from a
+ *          frozen library of full simulation showers in the same energy bin, rotated onto the track direction, translated to the track
+ *          position and scaled to the track energy.
+ */
+class G4TPCShowerLibraryModel : public G4VFastSimulationModel
+{
+public:
+    /**
+    *  @brief  Constructor
+    *
+    *  @param  name of the model
+    *  @param  pG4Region the region in which to apply the model
+    *  @param  pG4TPCDetectorConstruction detector properties
+    *  @param  pG4TPCSteppingAction stepping action, receives the shower spots
+    *  @param  pInputParameters input parameters
+    */
+    G4TPCShowerLibraryModel(const G4String &name, G4Region *pG4Region, const G4TPCDetectorConstruction *pG4TPCDetectorConstruction,
+        G4TPCSteppingAction *pG4TPCSteppingAction, const InputParameters *pInputParameters);
+
+    /**
+    *  @brief  Destructor
+    */
+    ~G4TPCShowerLibraryModel() override;
+
+    /**
+    *  @brief  Whether the model applies to a particle type
+    *
+    *  @param  particleDefinition the particle type
+    *
+    *  @return is particle an electron, positron or photon
+    */
+    G4bool IsApplicable(const G4ParticleDefinition &particleDefinition) override;
+
+    /**
+    *  @brief  Whether to take the current track from the library
+    *
+    *  @param  fastTrack the current track
+    *
+    *  @return is track within the library energy range, with library showers available
+    */
+    G4bool ModelTrigger(const G4FastTrack &fastTrack) override;
+
+    /**
+    *  @brief  Kill the current track and deposit its energy as a library shower
+    *
+    *  @param  fastTrack the current track
+    *  @param  fastStep to receive the track status
+    */
+    void DoIt(const G4FastTrack &fastTrack, G4FastStep &fastStep) override;
+
+private:
+    const G4TPCDetectorConstruction    *m_pG4TPCDetectorConstruction;    ///< Detector construction class
+    G4TPCSteppingAction                *m_pG4TPCSteppingAction;          ///< Stepping action class, receives the shower spots
+    ShowerLibraryReader                *m_pShowerLibraryReader;          ///< The memory mapped shower library
+    double                              m_minEnergy;                     ///< Kinetic energy above which showers are taken from the library
+    double                              m_maxEnergy;                     ///< Kinetic energy below which showers are taken from the library
+};
+
+#endif // #ifndef GEANT4_SHOWER_LIBRARY_MODEL_H
@@ -0,0 +1,98 @@
+/**
+ *  @file   include/G4TPCSimulation.hh
+ *
+ *  @brief  Header file for the G4TPCSimulation class.
+ *
+ *  $Log: $
+ */
+
+#ifndef G4TPC_SIMULATION_H
+#define G4TPC_SIMULATION_H 1
+
+#include "ControlFlow/InputParameters.hh"
+#include "Persistency/EventContainer.hh"
+
+class G4RunManager;
+class G4VisManager;
+class G4VModularPhysicsList;
+
+/**
+ *  @brief  G4TPCSimulation class, runs the simulation configured by a set of input parameters in process.  The G4TPC executable is a thin
+ *          wrapper around it.  A consumer may register an event callback to receive each completed event as it ends, with no output written
+ *          or read back.  Geant4 allows one run manager per process, so there can be only one simulation per process.
+ *
+ *          InputParameters inputParameters("Config.xml");
+ *          G4TPCSimulation simulation(inputParameters);
+ *          simulation.SetEventCallback([](const EventView &eventView){ ... });
+ *          if (simulation.Initialize()) simulation.Run();
+ */
+class G4TPCSimulation
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  inputParameters the validated input parameters, which must outlive the simulation
+     */
+    G4TPCSimulation(InputParameters &inputParameters);
+
+    /**
+     *  @brief  Destructor, deleting the run manager and with it the detector, physics list and user actions
+     */
+    ~G4TPCSimulation();
+
+    /**
+     *  @brief  Construct the run manager, detector, physics list and user actions, and initialize the run
+     *
+     *  @return whether the simulation was initialized
+     */
+    bool Initialize();
+
+    /**
+     *  @brief  Set the callback receiving each completed event, which may be set before or after initialization
+     *
+     *  @param  eventCallback the event callback, empty for none
+     */
+    void SetEventCallback(const EventContainer::EventCallback &eventCallback);
+
+    /**
+     *  @brief  Simulate the configured events, one run per particle gun configuration, resuming from a checkpoint or replaying events if
+     *          requested, then store the physics tables if the physics table cache is used
+     *
+     *  @return whether the events were simulated
+     */
+    bool Run();
+
+    /**
+     *  @brief  Get the event container
+     *
+     *  @return the event container, nullptr until the simulation is initialized
+     */
+    const EventContainer *GetEventContainer() const;
+
+private:
+    /**
+     *  @brief  Get the number of events each run is to process
+     *
+     *  @param  nEventsToProcess to receive the number of events
+     *
+     *  @return whether the number of events could be found, false if an event to replay has no random snapshot
+     */
+    bool GetNEventsToProcess(unsigned int &nEventsToProcess) const;
+
+    InputParameters                &m_inputParameters;          ///< Input parameters
+    G4RunManager                   *m_pG4RunManager;            ///< Run manager
+    G4VisManager                   *m_pG4VisManager;            ///< Visualization manager, nullptr unless visualization is requested
+    G4VModularPhysicsList          *m_pG4VModularPhysicsList;   ///< Physics list, owned by the run manager
+    EventContainer                 *m_pEventContainer;          ///< Event container, owned by the user actions
+    EventContainer::EventCallback   m_eventCallback;            ///< Callback receiving each completed event
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const EventContainer *G4TPCSimulation::GetEventContainer() const
+{
+    return m_pEventContainer;
+}
+
+#endif // #ifndef G4TPC_SIMULATION_H
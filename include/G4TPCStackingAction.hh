@@ -0,0 +1,84 @@
+/**
+ *  @file   include/G4TPCStackingAction.hh
+ *
+ *  @brief  Header file for the geant4 stacking action class.
+ *
+ *  $Log: $
+ */
+
+#ifndef GEANT4_STACKING_ACTION_H
+#define GEANT4_STACKING_ACTION_H 1
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "globals.hh"
+
+#include "G4UserStackingAction.hh"
+
+class EventContainer;
+class G4TPCDetectorConstruction;
+class G4TPCSteppingAction;
+class InputParameters;
+
+/**
+ *  @brief  G4TPCStackingAction class.  Kills new tracks that do not change the readout before they are tracked: secondaries below a per species
+ *          kinetic energy threshold, whose energy is deposited locally, neutrons and the products of neutron interactions created after the
+ *          neutron time window, and neutrinos.
+ */
+class G4TPCStackingAction : public G4UserStackingAction
+{
+public:
+    /**
+    *  @brief  Constructor
+    *
+    *  @param  pG4TPCDetectorConstruction detector properties
+    *  @param  pEventContainer event information
+    *  @param  pG4TPCSteppingAction stepping action, receives the energy of killed tracks
+    *  @param  pInputParameters input parameters
+    */
+    G4TPCStackingAction(const G4TPCDetectorConstruction *pG4TPCDetectorConstruction, EventContainer *pEventContainer,
+        G4TPCSteppingAction *pG4TPCSteppingAction, const InputParameters *pInputParameters);
+
+    /**
+    *  @brief  Destructor
+    */
+    ~G4TPCStackingAction() override;
+
+    /**
+    *  @brief  Classify a new track, killing it or passing it on to be tracked
+    *
+    *  @param  pG4Track the new track
+    *
+    *  @return fKill if the track is killed, fUrgent otherwise
+    */
+    G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track *pG4Track) override;
+
+    /**
+    *  @brief  Forget the neutrons of the previous event
+    */
+    void PrepareNewEvent() override;
+
+private:
+    typedef std::unordered_map<int, double> IntDoubleMap;
+    typedef std::unordered_set<int> IntSet;
+
+    /**
+    *  @brief  Apply the kill rules to a new track
+    *
+    *  @param  pG4Track the new track
+    *
+    *  @return fKill if the track is killed, fUrgent otherwise
+    */
+    G4ClassificationOfNewTrack Classify(const G4Track *pG4Track);
+
+    const G4TPCDetectorConstruction    *m_pG4TPCDetectorConstruction;    ///< Detector construction class
+    EventContainer                     *m_pEventContainer;               ///< Event information
+    G4TPCSteppingAction                *m_pG4TPCSteppingAction;          ///< Stepping action class, receives the energy of killed tracks
+    IntDoubleMap                        m_pdgKillThresholds;             ///< Map of pdg code to kinetic energy below which new tracks are killed
+    double                              m_neutronTimeWindow;             ///< Global time after which neutrons are killed, non-positive for none
+    IntSet                              m_neutronTrackIds;               ///< Track ids of the neutrons tracked in the event, when using the time window
+    bool                                m_killNeutrinos;                 ///< Should kill neutrinos
+};
+
+#endif // #ifndef GEANT4_STACKING_ACTION_H
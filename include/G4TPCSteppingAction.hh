@@ -36,9 +36,13 @@
 
 #include "globals.hh"
 
+class EventCostReport;
+class EventWatchdog;
 class G4TPCDetectorConstruction;
 class G4TPCEventAction;
 class G4VPhysicalVolume;
+class InputParameters;
+class StepProfiler;
 
 /**
 *  @brief  G4TPCSteppingAction class
@@ -52,9 +56,10 @@ public:
     *  @param  pG4TPCDetectorConstruction detector properties
     *  @param  pEventContainer event information
     *  @param  pG4TPCMCParticleUserAction MCParticle user actions
+    *  @param  pInputParameters input parameters
     */
     G4TPCSteppingAction(const G4TPCDetectorConstruction *pG4TPCDetectorConstruction, EventContainer *pEventContainer,
-        G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction);
+        G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction, const InputParameters *pInputParameters);
 
     /**
     *  @brief  Destructor
@@ -68,10 +73,44 @@ public:
     */
     void UserSteppingAction(const G4Step *pG4Step) override;
 
+    /**
+    *  @brief  Record an energy deposit in the readout, either directly in the current cell list or in the deposit buffer
+    *
+    *  @param  position of the energy deposit
+    *  @param  energy deposited
+    *  @param  trackId geant4 track id creating the deposit
+    */
+    void AddEnergyDeposition(const G4ThreeVector &position, const double energy, const int trackId);
+
+    /**
+    *  @brief  Record an energy deposit spread along a step, keeping the post step position for the deposit archive
+    *
+    *  @param  preStepPosition pre step position of the energy deposit, used for the readout
+    *  @param  postStepPosition post step position of the energy deposit
+    *  @param  energy deposited
+    *  @param  trackId geant4 track id creating the deposit
+    */
+    void AddEnergyDeposition(const G4ThreeVector &preStepPosition, const G4ThreeVector &postStepPosition, const double energy, const int trackId);
+
+    /**
+    *  @brief  Record an energy deposit at a position that may lie outside the detector, in each readout grid containing the position
+    *
+    *  @param  position of the energy deposit
+    *  @param  energy deposited
+    *  @param  trackId geant4 track id creating the deposit
+    */
+    void AddContainedEnergyDeposition(const G4ThreeVector &position, const double energy, const int trackId);
+
 private:
     const G4TPCDetectorConstruction    *m_pG4TPCDetectorConstruction;    ///< Detector construction class
     EventContainer                     *m_pEventContainer;               ///< Event information
     G4TPCMCParticleUserAction          *m_pG4TPCMCParticleUserAction;    ///< MCParticle user action class
+    bool                                m_useBatchedDeposits;            ///< Should buffer deposits rather than fill cells step by step
+    bool                                m_useDepositArchive;             ///< Should buffer deposits for the raw step deposit archive
+    double                              m_neutronTimeWindow;             ///< Global time after which neutrons are killed, non-positive for none
+    EventWatchdog                      *m_pEventWatchdog;                ///< Event time budget watchdog, nullptr if no budget is set
+    EventCostReport                    *m_pEventCostReport;              ///< Per event cost report, nullptr if not requested
+    StepProfiler                       *m_pStepProfiler;                 ///< Step profiler, nullptr if not requested
 };
 
 #endif
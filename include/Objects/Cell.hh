@@ -9,9 +9,12 @@
 #ifndef CELL_H
 #define CELL_H 1
 
+#include <cstdint>
 #include <map>
 #include <vector>
 
+typedef std::uint64_t CellIndex;
+
 /**
  *  @brief Cell class
  */
@@ -26,7 +29,7 @@ public:
      *  @param  z position of energy deposit
      *  @param  idx cell index
      */
-    Cell(const float x, const float y, const float z, const int idx);
+    Cell(const float x, const float y, const float z, const CellIndex idx);
 
     /**
      *  @brief  Destructor
@@ -38,7 +41,7 @@ public:
     *
     *  @return cell index
     */
-    int GetIdx() const;
+    CellIndex GetIdx() const;
 
     /**
     *  @brief  Get the cell x position
@@ -76,16 +79,16 @@ public:
     void AddEnergy(const float energy);
 
 private:
-    int   m_idx;    ///< Index
-    float m_x;      ///< X position
-    float m_y;      ///< Y position
-    float m_z;      ///< Z position
-    float m_energy; ///< Enegry
+    CellIndex m_idx;    ///< Index
+    float     m_x;      ///< X position
+    float     m_y;      ///< Y position
+    float     m_z;      ///< Z position
+    float     m_energy; ///< Enegry
 };
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
-inline int Cell::GetIdx() const
+inline CellIndex Cell::GetIdx() const
 {
     return m_idx;
 }
@@ -128,10 +131,10 @@ inline void Cell::AddEnergy(const float energy)
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
-typedef std::map<int, Cell*> IntCellMap;
+typedef std::map<CellIndex, Cell*> CellIndexCellMap;
 typedef std::pair<int, float> IntFloatPair;
 typedef std::vector<IntFloatPair> IntFloatVector;
-typedef std::map<int, IntFloatVector> MCComponents;
+typedef std::map<CellIndex, IntFloatVector> MCComponents;
 
 /**
  *  @brief CellList class
@@ -157,8 +160,16 @@ public:
      */
     void AddEnergyDeposition(Cell *pCell, const int geantTrackId);
 
-    IntCellMap     m_idCellMap;     ///< Cell Id to cell map
-    MCComponents   m_mcComponents;  ///< Cell Id to vector of geantIds to energies pairs
+    /**
+     *  @brief  Add the energy deposit in a given cell from several geant tracks to the cell list
+     *
+     *  @param  pCell cell energy to add, the sum of the track contributions
+     *  @param  mcComponents the geant track IDs creating the energy deposit and their energies
+     */
+    void AddEnergyDepositions(Cell *pCell, const IntFloatVector &mcComponents);
+
+    CellIndexCellMap  m_idCellMap;     ///< Cell Id to cell map
+    MCComponents      m_mcComponents;  ///< Cell Id to vector of geantIds to energies pairs
 };
 
 #endif // #ifndef CELL_H
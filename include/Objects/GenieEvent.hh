@@ -189,6 +189,33 @@ public:
      */
     double GetVertexZ() const;
 
+    /**
+     *  @brief  Set index of the event in the genie tracker file
+     *
+     *  @param  sourceIndex
+     */
+    void SetSourceIndex(const int sourceIndex);
+
+    /**
+     *  @brief  Get index of the event in the genie tracker file
+     *
+     *  @return m_sourceIndex
+     */
+    int GetSourceIndex() const;
+
+    /**
+     *  @brief  Get the energy the daughters can deposit, their kinetic energy with the masses of the geant4 particle table, or the total
+     *          energy of neutral pions.  Neutrinos, neutrons, nuclear fragments and species missing from the particle table are excluded.
+     *
+     *  @return visible energy (GeV)
+     */
+    double GetVisibleEnergy() const;
+
+    /**
+     *  @brief  Construct the geant4 particle definitions of the genie final state particles, for their masses before a physics list is built
+     */
+    static void ConstructParticleDefinitions();
+
 private:
     const Track   *m_pNeutrinoTrack;   ///< Neutrino particle track
     TrackList      m_daughterTracks;   ///< Daughter particle tracks
@@ -196,6 +223,7 @@ private:
     double         m_vertexX;          ///< Neutrino interaction vertex x
     double         m_vertexY;          ///< Neutrino interaction vertex y
     double         m_vertexZ;          ///< Neutrino interaction vertex z
+    int            m_sourceIndex;      ///< Index of the event in the genie tracker file, before any filtering
 };
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
@@ -270,6 +298,20 @@ inline double GenieEvent::GetVertexZ() const
     return m_vertexZ;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline void GenieEvent::SetSourceIndex(const int sourceIndex)
+{
+    m_sourceIndex = sourceIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline int GenieEvent::GetSourceIndex() const
+{
+    return m_sourceIndex;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
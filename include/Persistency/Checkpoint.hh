@@ -0,0 +1,105 @@
+/**
+ *  @file   include/Persistency/Checkpoint.hh
+ *
+ *  @brief  Header file for the Checkpoint class.
+ *
+ *  $Log: $
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H 1
+
+#include <cstdint>
+#include <string>
+
+/**
+ *  @brief Checkpoint class, records how far a run with streamed output has got, so that a job stopped part way through can resume.  The
+ *         checkpoint holds the number of completed events, the size of the output file after them and the random engine status.  Checkpoints
+ *         are written to a temporary file and renamed into place, so a job stopped while checkpointing leaves the previous checkpoint intact.
+ */
+class Checkpoint
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  fileName the checkpoint file name
+     */
+    Checkpoint(const std::string &fileName);
+
+    /**
+     *  @brief  Load the checkpoint, if there is one
+     *
+     *  @return whether a checkpoint was loaded
+     */
+    bool Load();
+
+    /**
+     *  @brief  Save a checkpoint and the current random engine status
+     *
+     *  @param  nEventsCompleted number of events completed and written to the output
+     *  @param  outputPosition size of the output file after the completed events (bytes)
+     */
+    void Save(const int nEventsCompleted, const std::uint64_t outputPosition);
+
+    /**
+     *  @brief  Restore the random engine status saved with the loaded checkpoint
+     */
+    void RestoreEngineStatus() const;
+
+    /**
+     *  @brief  Remove the checkpoint, once the run it records has completed
+     */
+    void Remove();
+
+    /**
+     *  @brief  Get whether a checkpoint was loaded
+     *
+     *  @return m_loaded
+     */
+    bool IsLoaded() const;
+
+    /**
+     *  @brief  Get the number of completed events
+     *
+     *  @return m_nEventsCompleted
+     */
+    int GetNEventsCompleted() const;
+
+    /**
+     *  @brief  Get the size of the output file after the completed events
+     *
+     *  @return m_outputPosition (bytes)
+     */
+    std::uint64_t GetOutputPosition() const;
+
+private:
+    std::string            m_fileName;              ///< Checkpoint file name
+    bool                   m_loaded;                ///< Was a checkpoint loaded
+    int                    m_nEventsCompleted;      ///< Number of completed events
+    std::uint64_t          m_outputPosition;        ///< Size of the output file after the completed events (bytes)
+    std::string            m_engineStatus;          ///< Random engine status, as written by the engine
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool Checkpoint::IsLoaded() const
+{
+    return m_loaded;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline int Checkpoint::GetNEventsCompleted() const
+{
+    return m_nEventsCompleted;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::uint64_t Checkpoint::GetOutputPosition() const
+{
+    return m_outputPosition;
+}
+
+#endif // #ifndef CHECKPOINT_H
@@ -0,0 +1,179 @@
+/**
+ *  @file   include/Persistency/DepositArchive.hh
+ *
+ *  @brief  Header file for the DepositArchiveWriter and DepositArchiveReader classes.
+ *
+ *  $Log: $
+ */
+
+#ifndef DEPOSIT_ARCHIVE_H
+#define DEPOSIT_ARCHIVE_H 1
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Objects/MCParticle.hh"
+
+#include "Readout/DepositBuffer.hh"
+
+/**
+ *  @brief  Raw step deposit archive layout.  The file starts with an 8 byte magic string and a 32 bit version, followed by one record per
+ *          event.  Each record is a fixed size header followed by a zlib compressed payload holding, as contiguous arrays, the pre step
+ *          positions, post step positions, energies and track ids of the deposits, then the (track id, parent id) links and the ids of the
+ *          MC particles kept in the event.  Values are written in native (little endian on all supported platforms) byte order.
+ */
+namespace DepositArchive
+{
+    /**
+     *  @brief  Header for one event record
+     */
+    struct EventHeader
+    {
+        std::int32_t    m_eventNumber;          ///< Event number in the simulation job
+        std::uint32_t   m_nParentLinks;         ///< Number of (track id, parent id) links
+        std::uint32_t   m_nKnownParticles;      ///< Number of MC particle track ids kept in the event
+        std::uint32_t   m_padding;              ///< Unused, keeps the 64 bit fields aligned
+        std::uint64_t   m_nDeposits;            ///< Number of deposits
+        std::uint64_t   m_compressedSize;       ///< Size of the compressed payload in bytes
+        std::uint64_t   m_uncompressedSize;     ///< Size of the payload before compression in bytes
+    };
+
+    static const char           MAGIC[8] = {'G', '4', 'T', 'P', 'C', 'D', 'E', 'P'};   ///< File magic string
+    static const std::uint32_t  VERSION = 1;                                            ///< File format version
+}
+
+/**
+ *  @brief DepositArchiveWriter class
+ */
+class DepositArchiveWriter
+{
+public:
+    /**
+     *  @brief  Constructor, opens the archive and writes the file header
+     *
+     *  @param  fileName the archive file name
+     *  @param  compressionLevel zlib compression level, 1 (fastest) to 9 (smallest)
+     */
+    DepositArchiveWriter(const std::string &fileName, const int compressionLevel = 1);
+
+    /**
+     *  @brief  Destructor, closes the archive
+     */
+    ~DepositArchiveWriter();
+
+    /**
+     *  @brief  Append one event to the archive
+     *
+     *  @param  eventNumber the event number
+     *  @param  depositBuffer the raw deposits for the event
+     *  @param  mcParticleList the MC particles for the event, used to attribute deposits to kept particles when re-binning
+     */
+    void WriteEvent(const int eventNumber, const DepositBuffer &depositBuffer, const MCParticleList &mcParticleList);
+
+    /**
+     *  @brief  Get the number of bytes written to the archive so far
+     *
+     *  @return number of bytes
+     */
+    std::uint64_t GetNBytesWritten() const;
+
+private:
+    std::ofstream               m_file;                 ///< The archive file
+    int                         m_compressionLevel;     ///< zlib compression level
+    std::vector<char>           m_payload;              ///< Reused buffer for the uncompressed payload
+    std::vector<unsigned char>  m_compressedPayload;    ///< Reused buffer for the compressed payload
+    std::uint64_t               m_nBytesWritten;        ///< Number of bytes written so far
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief DepositArchiveReader class
+ */
+class DepositArchiveReader
+{
+public:
+    /**
+     *  @brief  Constructor, opens the archive and indexes the event records
+     *
+     *  @param  fileName the archive file name
+     */
+    DepositArchiveReader(const std::string &fileName);
+
+    /**
+     *  @brief  Destructor
+     */
+    ~DepositArchiveReader();
+
+    /**
+     *  @brief  Whether the archive was opened and indexed successfully
+     *
+     *  @return is archive valid
+     */
+    bool IsValid() const;
+
+    /**
+     *  @brief  Get the number of events in the archive
+     *
+     *  @return number of events
+     */
+    unsigned int GetNEvents() const;
+
+    /**
+     *  @brief  Read one event from the archive
+     *
+     *  @param  index the index of the event record in the archive
+     *  @param  eventNumber to receive the event number
+     *  @param  depositBuffer to receive the raw deposits
+     *  @param  trackIdParentMap to receive the (track id, parent id) links
+     *  @param  knownParticles to receive the ids of the MC particles kept in the event
+     *
+     *  @return whether the event was read successfully
+     */
+    bool ReadEvent(const unsigned int index, int &eventNumber, DepositBuffer &depositBuffer, IntIntMap &trackIdParentMap,
+        IntVector &knownParticles);
+
+private:
+    typedef std::vector<std::streamoff> OffsetVector;
+
+    /**
+     *  @brief  Get the payload size implied by the counts in an event header
+     *
+     *  @param  eventHeader the event header
+     *
+     *  @return the uncompressed payload size in bytes
+     */
+    static std::uint64_t GetPayloadSize(const DepositArchive::EventHeader &eventHeader);
+
+    std::ifstream               m_file;                 ///< The archive file
+    bool                        m_isValid;              ///< Whether the archive was opened and indexed successfully
+    OffsetVector                m_eventOffsets;         ///< File offsets of each event record
+    std::vector<char>           m_payload;              ///< Reused buffer for the uncompressed payload
+    std::vector<unsigned char>  m_compressedPayload;    ///< Reused buffer for the compressed payload
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::uint64_t DepositArchiveWriter::GetNBytesWritten() const
+{
+    return m_nBytesWritten;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool DepositArchiveReader::IsValid() const
+{
+    return m_isValid;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int DepositArchiveReader::GetNEvents() const
+{
+    return m_eventOffsets.size();
+}
+
+#endif // #ifndef DEPOSIT_ARCHIVE_H
@@ -9,19 +9,69 @@
 #ifndef EVENT_CONTAINER_H
 #define EVENT_CONTAINER_H 1
 
+#include <fstream>
+#include <functional>
 #include <iostream>
 
+#include "Analysis/EventReducer.hh"
+
 #include "ControlFlow/InputParameters.hh"
 
 #include "Objects/Cell.hh"
 #include "Objects/MCParticle.hh"
 
+#include "Persistency/SharedMemoryRing.hh"
+
+#include "Readout/DepositBuffer.hh"
+
+class Checkpoint;
+class DepositArchiveWriter;
+class EventCostReport;
+class EventWatchdog;
+class OverlayLibrary;
+class ProgressReporter;
+class RandomSnapshotReader;
+class RandomSnapshotWriter;
+class StepProfiler;
+class TiXmlElement;
+class VoxelGrid;
+
+/**
+ *  @brief EventView struct, read only view of a completed event, handed to the event callback.  The cells and MC particles belong to the
+ *         event container and are only valid during the callback, a consumer that keeps them must copy them.
+ */
+struct EventView
+{
+    int                             m_eventNumber;      ///< Event number
+    long                            m_seed;             ///< Random seed of the event
+    bool                            m_aborted;          ///< Whether the event was aborted
+    const std::vector<CellList>    *m_pCellLists;       ///< Cell lists, for the default readout then each additional readout grid
+    const MCParticleList           *m_pMCParticleList;  ///< MC particles
+};
+
+/**
+ *  @brief OverlaidEvent struct, a background event from the overlay library overlaid on an event
+ */
+struct OverlaidEvent
+{
+    int                             m_trackId;              ///< Track id labelling the overlaid deposits, negative to keep it apart from geant4 tracks
+    int                             m_libraryEventNumber;   ///< Event number of the background event in the job that simulated the library
+    float                           m_timeShift;            ///< Time shift (ns)
+    float                           m_shiftX;               ///< Shift along x, from the time shift (mm)
+    float                           m_shiftY;               ///< Shift along y (mm)
+    float                           m_shiftZ;               ///< Shift along z (mm)
+};
+
+typedef std::vector<OverlaidEvent> OverlaidEventVector;
+
 /**
  *  @brief EventContainer class
  */
 class EventContainer
 {
 public:
+    typedef std::function<void(const EventView &eventView)> EventCallback;
+
     /**
      *  @brief  Default constructor
      *
@@ -35,26 +85,75 @@ public:
     ~EventContainer();
 
     /**
-     *  @brief  Increment variables for current event
+     *  @brief  Delete the events of the previous run, so each run is saved to its own output file.  When streaming the output, open the
+     *          output file, resuming from the checkpoint if there is one.  When replaying, start from the first replay event.
+     *
+     *  @param  nEventsToProcess number of events the run will process
+     */
+    void BeginOfRunAction(const int nEventsToProcess);
+
+    /**
+     *  @brief  Increment variables for current event and sample the background events to overlay on it, if requested
      */
     void BeginOfEventAction();
 
     /**
-     *  @brief  Increment variables for next event
+     *  @brief  Hand the current event to the event callback and the shared memory ring, archive the raw deposits for the current event, if
+     *          requested, and increment variables for next event
      */
     void EndOfEventAction();
 
     /**
-     *  @brief  Save events to xml
+     *  @brief  Save events to xml, or when streaming the output, complete the output file and remove the checkpoint.  Nothing is written
+     *          if the event output is switched off.
      */
     void SaveXml();
 
     /**
-    *  @brief  Get the current cell list
+     *  @brief  Write the cells in a cell list to xml, attributing each cell to the visible MC particle contributing most energy
+     *
+     *  @param  cellList the cells
+     *  @param  mcParticleList the MC particles used for the attribution
+     *  @param  pEventTiXmlElement the xml element to receive the cells
+     */
+    static void WriteCellsXml(const CellList &cellList, const MCParticleList &mcParticleList, TiXmlElement *pEventTiXmlElement);
+
+    /**
+     *  @brief  Find the visible MC particle contributing most energy to a cell, following the parents of MC particles that were not kept
+     *
+     *  @param  cellList the cell list holding the cell
+     *  @param  pCell the cell
+     *  @param  mcParticleList the MC particles used for the attribution
+     *  @param  mainVisibleMCTrackId to receive the track id of the visible MC particle, zero if no ancestor was kept
+     *
+     *  @return whether the cell has any energy contribution
+     */
+    static bool GetMainVisibleMCTrackId(const CellList &cellList, const Cell *pCell, const MCParticleList &mcParticleList, int &mainVisibleMCTrackId);
+
+    /**
+    *  @brief  Get the current cell list for a readout grid
+    *
+    *  @param  gridIndex index of the readout grid, zero for the default readout
     *
     *  @return the current list of cells
     */
-    CellList &GetCurrentCellList();
+    CellList &GetCurrentCellList(const unsigned int gridIndex = 0);
+
+    /**
+    *  @brief  Get the buffer of raw energy deposits for the current event
+    *
+    *  @return the current deposit buffer
+    */
+    DepositBuffer &GetCurrentDepositBuffer();
+
+    /**
+    *  @brief  Sum the buffered raw energy deposits for the current event into the current cell list, if batched deposits are requested,
+    *          then the deposits of the overlaid background events
+    *
+    *  @param  voxelGrid the readout grid
+    *  @param  gridIndex index of the readout grid, zero for the default readout
+    */
+    void ReduceDeposits(const VoxelGrid &voxelGrid, const unsigned int gridIndex = 0);
 
     /**
      *  @brief  Get the current MCParticle list
@@ -77,35 +176,186 @@ public:
      */
     int GetEventNumber() const;
 
+    /**
+     *  @brief  Set the random seed used to generate the next event
+     *
+     *  @param  seed the random seed
+     */
+    void SetCurrentSeed(const long seed);
+
+    /**
+     *  @brief  Get the random seed used to generate the current event
+     *
+     *  @return m_currentSeed
+     */
+    long GetCurrentSeed() const;
+
+    /**
+     *  @brief  Mark the current event as aborted, so it is flagged in the output
+     */
+    void SetCurrentEventAborted();
+
+    /**
+     *  @brief  Get the event watchdog
+     *
+     *  @return the event watchdog, nullptr if no event time budget is set
+     */
+    EventWatchdog *GetEventWatchdog() const;
+
+    /**
+     *  @brief  Get the event cost report
+     *
+     *  @return the event cost report, nullptr if not requested
+     */
+    EventCostReport *GetEventCostReport() const;
+
+    /**
+     *  @brief  Get the step profiler
+     *
+     *  @return the step profiler, nullptr if not requested
+     */
+    StepProfiler *GetStepProfiler() const;
+
+    /**
+     *  @brief  Get the progress reporter
+     *
+     *  @return the progress reporter, nullptr if not requested
+     */
+    ProgressReporter *GetProgressReporter() const;
+
+    /**
+     *  @brief  Get the random snapshot writer
+     *
+     *  @return the random snapshot writer, nullptr if not requested
+     */
+    RandomSnapshotWriter *GetRandomSnapshotWriter() const;
+
+    /**
+     *  @brief  Get the random snapshot reader, used to replay events
+     *
+     *  @return the random snapshot reader, nullptr if not replaying
+     */
+    const RandomSnapshotReader *GetRandomSnapshotReader() const;
+
+    /**
+     *  @brief  Get the overlay library
+     *
+     *  @return the overlay library, nullptr if no overlay is requested or the library could not be read
+     */
+    const OverlayLibrary *GetOverlayLibrary() const;
+
+    /**
+     *  @brief  Get the event reducers
+     *
+     *  @return m_eventReducers
+     */
+    const EventReducerVector &GetEventReducers() const;
+
+    /**
+     *  @brief  Set the callback receiving each completed event, before it is written out
+     *
+     *  @param  eventCallback the event callback, empty for none
+     */
+    void SetEventCallback(const EventCallback &eventCallback);
+
+    /**
+     *  @brief  Get the time spent writing the output, the deposit archive and the shared memory ring
+     *
+     *  @return m_serializationTime (s)
+     */
+    double GetSerializationTime() const;
+
 private:
+    /**
+     *  @brief  Create the xml element for an event held in the container
+     *
+     *  @param  eventIndex the index of the event in the container
+     *
+     *  @return the event xml element, owned by the caller
+     */
+    TiXmlElement *CreateEventXml(const unsigned int eventIndex) const;
+
+    /**
+     *  @brief  Delete the cells and MC particles of the events held in the container
+     */
+    void DeleteEvents();
+
+    /**
+     *  @brief  Write the default readout cells and the MC particles of the current event to the shared memory ring
+     */
+    void WriteSharedMemoryEvent();
+
+    /**
+     *  @brief  Sample the background events to overlay on the current event and fill the overlay deposit buffer with their shifted deposits
+     */
+    void SampleOverlay();
+
     typedef std::vector<MCParticleList> MCParticleListVector;
     typedef std::vector<CellList> CellListVector;
+    typedef std::vector<CellListVector> CellListVectorVector;
+    typedef std::vector<long> LongVector;
+    typedef std::vector<bool> BoolVector;
+    typedef std::vector<OverlaidEventVector> OverlaidEventVectorVector;
+    typedef std::vector<SharedMemoryRing::CellRecord> CellRecordVector;
+    typedef std::vector<SharedMemoryRing::MCParticleRecord> MCParticleRecordVector;
 
     int                        m_eventNumber;       ///< Event number
+    int                        m_endEventNumber;    ///< Event number after the last event of the run
+    unsigned int               m_replayIndex;       ///< Index of the current event in the replay events
+    IntVector                  m_eventNumbers;      ///< Event number of each event
     MCParticleListVector       m_mcParticles;       ///< MCParticle list
-    CellListVector             m_cells;             ///< Cell list
+    CellListVectorVector       m_cells;             ///< Cell lists, by event then readout grid
+    DepositBuffer              m_depositBuffer;     ///< Raw energy deposits for the current event
+    DepositArchiveWriter      *m_pDepositArchive;   ///< Raw step deposit archive
+    EventWatchdog             *m_pEventWatchdog;    ///< Event time budget watchdog
+    EventCostReport           *m_pEventCostReport;  ///< Per event cost report
+    StepProfiler              *m_pStepProfiler;     ///< Step profiler
+    ProgressReporter          *m_pProgressReporter; ///< Progress reporter
+    double                     m_serializationTime; ///< Time spent writing the output, the deposit archive and the shared memory ring (s)
+    long                       m_currentSeed;       ///< Random seed for the current event
+    LongVector                 m_seeds;             ///< Random seed for each event
+    BoolVector                 m_abortedEvents;     ///< Whether each event was aborted
+    std::ofstream              m_outputFile;        ///< Streamed output file, events are written as they end
+    Checkpoint                *m_pCheckpoint;       ///< Checkpoint of the streamed output
+    RandomSnapshotWriter      *m_pRandomSnapshotWriter;  ///< Random snapshot writer
+    RandomSnapshotReader      *m_pRandomSnapshotReader;  ///< Random snapshot reader, used to replay events
+    EventReducerVector         m_eventReducers;     ///< Event reducers
+    EventCallback              m_eventCallback;     ///< Callback receiving each completed event
+    SharedMemoryRingWriter    *m_pSharedMemoryRing; ///< Shared memory ring, for a consumer process on the same host
+    CellRecordVector           m_cellRecords;       ///< Cell records for the shared memory ring, reused between events
+    MCParticleRecordVector     m_mcParticleRecords; ///< MC particle records for the shared memory ring, reused between events
+    OverlayLibrary            *m_pOverlayLibrary;   ///< Background events to overlay
+    DepositBuffer              m_overlayBuffer;     ///< Shifted deposits of the background events overlaid on the current event
+    OverlaidEventVectorVector  m_overlaidEvents;    ///< Background events overlaid on each event
     const InputParameters     *m_pInputParameters;  ///< Input parameters
 };
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
-inline CellList &EventContainer::GetCurrentCellList()
+inline CellList &EventContainer::GetCurrentCellList(const unsigned int gridIndex)
 {
-    return m_cells.at(m_eventNumber);
+    return m_cells.back().at(gridIndex);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline DepositBuffer &EventContainer::GetCurrentDepositBuffer()
+{
+    return m_depositBuffer;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
 inline MCParticleList &EventContainer::GetCurrentMCParticleList()
 {
-    return m_mcParticles.at(m_eventNumber);
+    return m_mcParticles.back();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
 inline void EventContainer::SetCurrentMCParticleList(const MCParticleList &mcParticleList)
 {
-    m_mcParticles.at(m_eventNumber) = mcParticleList;
+    m_mcParticles.back() = mcParticleList;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
@@ -115,4 +365,95 @@ inline int EventContainer::GetEventNumber() const
    return m_eventNumber;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline void EventContainer::SetCurrentSeed(const long seed)
+{
+    m_currentSeed = seed;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline long EventContainer::GetCurrentSeed() const
+{
+    return m_currentSeed;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline void EventContainer::SetCurrentEventAborted()
+{
+    m_abortedEvents.back() = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline EventWatchdog *EventContainer::GetEventWatchdog() const
+{
+    return m_pEventWatchdog;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline EventCostReport *EventContainer::GetEventCostReport() const
+{
+    return m_pEventCostReport;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline StepProfiler *EventContainer::GetStepProfiler() const
+{
+    return m_pStepProfiler;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline ProgressReporter *EventContainer::GetProgressReporter() const
+{
+    return m_pProgressReporter;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline RandomSnapshotWriter *EventContainer::GetRandomSnapshotWriter() const
+{
+    return m_pRandomSnapshotWriter;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline const RandomSnapshotReader *EventContainer::GetRandomSnapshotReader() const
+{
+    return m_pRandomSnapshotReader;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline const OverlayLibrary *EventContainer::GetOverlayLibrary() const
+{
+    return m_pOverlayLibrary;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline const EventReducerVector &EventContainer::GetEventReducers() const
+{
+    return m_eventReducers;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline void EventContainer::SetEventCallback(const EventCallback &eventCallback)
+{
+    m_eventCallback = eventCallback;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+inline double EventContainer::GetSerializationTime() const
+{
+    return m_serializationTime;
+}
+
 #endif // #ifndef EVENT_CONTAINER_H
@@ -0,0 +1,102 @@
+/**
+ *  @file   include/Persistency/OverlayLibrary.hh
+ *
+ *  @brief  Header file for the OverlayLibrary class.
+ *
+ *  $Log: $
+ */
+
+#ifndef OVERLAY_LIBRARY_H
+#define OVERLAY_LIBRARY_H 1
+
+#include <string>
+#include <vector>
+
+#include "Readout/DepositBuffer.hh"
+
+/**
+ *  @brief OverlayLibrary class, pre-simulated background events, such as cosmic muons, held in memory to be overlaid on simulated events.
+ *         The library is a raw step deposit archive written by this program, read in full when the library is opened, so overlaying an event
+ *         is a copy of its deposits rather than a decompression or a simulation.
+ */
+class OverlayLibrary
+{
+public:
+    /**
+     *  @brief  Constructor, reads every event in the deposit archive
+     *
+     *  @param  fileName the deposit archive file name
+     */
+    OverlayLibrary(const std::string &fileName);
+
+    /**
+     *  @brief  Whether the library was read successfully and holds at least one event
+     *
+     *  @return is library valid
+     */
+    bool IsValid() const;
+
+    /**
+     *  @brief  Get the number of events in the library
+     *
+     *  @return number of events
+     */
+    unsigned int GetNEvents() const;
+
+    /**
+     *  @brief  Get the event number an event had in the job that simulated the library
+     *
+     *  @param  index the index of the event in the library
+     *
+     *  @return the event number
+     */
+    int GetEventNumber(const unsigned int index) const;
+
+    /**
+     *  @brief  Append the deposits of a library event, shifted, to a deposit buffer.  Deposits shifted outside the bounds are dropped, as the
+     *          readout would otherwise clamp them into the edge cells.
+     *
+     *  @param  index the index of the event in the library
+     *  @param  shiftX shift along x (mm)
+     *  @param  shiftY shift along y (mm)
+     *  @param  shiftZ shift along z (mm)
+     *  @param  lowEdge low edge of the bounds along x, y and z (mm)
+     *  @param  highEdge high edge of the bounds along x, y and z (mm)
+     *  @param  trackId track id given to every deposit, labelling the overlay in the cell MC contributions
+     *  @param  depositBuffer to receive the shifted deposits
+     *
+     *  @return the number of deposits appended
+     */
+    std::size_t AddShiftedEvent(const unsigned int index, const float shiftX, const float shiftY, const float shiftZ, const float lowEdge[3],
+        const float highEdge[3], const int trackId, DepositBuffer &depositBuffer) const;
+
+private:
+    typedef std::vector<DepositBuffer> DepositBufferVector;
+
+    bool                        m_isValid;              ///< Whether the library was read successfully
+    DepositBufferVector         m_events;               ///< The deposits of each library event
+    std::vector<int>            m_eventNumbers;         ///< The event number of each library event in the job that simulated it
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool OverlayLibrary::IsValid() const
+{
+    return m_isValid;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int OverlayLibrary::GetNEvents() const
+{
+    return m_events.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline int OverlayLibrary::GetEventNumber(const unsigned int index) const
+{
+    return m_eventNumbers.at(index);
+}
+
+#endif // #ifndef OVERLAY_LIBRARY_H
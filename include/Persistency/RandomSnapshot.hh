@@ -0,0 +1,135 @@
+/**
+ *  @file   include/Persistency/RandomSnapshot.hh
+ *
+ *  @brief  Header file for the RandomSnapshotWriter and RandomSnapshotReader classes.
+ *
+ *  $Log: $
+ */
+
+#ifndef RANDOM_SNAPSHOT_H
+#define RANDOM_SNAPSHOT_H 1
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ *  @brief  Random snapshot file layout.  The file starts with an 8 byte magic string and a 32 bit version, followed by one record per
+ *          event.  Each record is a fixed size header followed by the random engine status at the start of the event, as the array of
+ *          words written by the engine.  Values are written in native (little endian on all supported platforms) byte order.
+ */
+namespace RandomSnapshot
+{
+    /**
+     *  @brief  Header for one event record
+     */
+    struct EventHeader
+    {
+        std::int32_t    m_eventNumber;          ///< Event number in the simulation job
+        std::uint32_t   m_nWords;               ///< Number of words in the random engine status
+        std::int64_t    m_seed;                 ///< Random seed of the event
+    };
+
+    static const char           MAGIC[8] = {'G', '4', 'T', 'P', 'C', 'R', 'N', 'G'};   ///< File magic string
+    static const std::uint32_t  VERSION = 1;                                            ///< File format version
+}
+
+/**
+ *  @brief RandomSnapshotWriter class, records the random engine status at the start of each event, so that any event can be simulated again
+ *         exactly without simulating the events before it
+ */
+class RandomSnapshotWriter
+{
+public:
+    /**
+     *  @brief  Constructor, opens the snapshot file and writes the file header
+     *
+     *  @param  fileName the snapshot file name
+     */
+    RandomSnapshotWriter(const std::string &fileName);
+
+    /**
+     *  @brief  Destructor, closes the snapshot file
+     */
+    ~RandomSnapshotWriter();
+
+    /**
+     *  @brief  Append the current random engine status for an event
+     *
+     *  @param  eventNumber the event number
+     *  @param  seed the random seed of the event
+     */
+    void WriteEvent(const int eventNumber, const long seed);
+
+private:
+    std::ofstream               m_file;                 ///< The snapshot file
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief RandomSnapshotReader class
+ */
+class RandomSnapshotReader
+{
+public:
+    /**
+     *  @brief  Constructor, reads the snapshot of every event in the snapshot file
+     *
+     *  @param  fileName the snapshot file name
+     */
+    RandomSnapshotReader(const std::string &fileName);
+
+    /**
+     *  @brief  Whether the snapshot file was read successfully
+     *
+     *  @return is snapshot file valid
+     */
+    bool IsValid() const;
+
+    /**
+     *  @brief  Whether there is a snapshot for an event
+     *
+     *  @param  eventNumber the event number
+     *
+     *  @return whether there is a snapshot
+     */
+    bool HasEvent(const int eventNumber) const;
+
+    /**
+     *  @brief  Restore the random engine status at the start of an event
+     *
+     *  @param  eventNumber the event number
+     *  @param  seed to receive the random seed of the event
+     *
+     *  @return whether the random engine status was restored
+     */
+    bool RestoreEngineStatus(const int eventNumber, long &seed) const;
+
+private:
+    typedef std::vector<unsigned long> EngineStatus;
+    typedef std::pair<long, EngineStatus> Snapshot;
+    typedef std::map<int, Snapshot> IntSnapshotMap;
+
+    bool                        m_isValid;              ///< Whether the snapshot file was read successfully
+    IntSnapshotMap              m_snapshots;            ///< Random seed and engine status, by event number
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool RandomSnapshotReader::IsValid() const
+{
+    return m_isValid;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool RandomSnapshotReader::HasEvent(const int eventNumber) const
+{
+    return (m_snapshots.find(eventNumber) != m_snapshots.end());
+}
+
+#endif // #ifndef RANDOM_SNAPSHOT_H
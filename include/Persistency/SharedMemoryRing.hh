@@ -0,0 +1,264 @@
+/**
+ *  @file   include/Persistency/SharedMemoryRing.hh
+ *
+ *  @brief  Header file for the SharedMemoryRingWriter and SharedMemoryRingReader classes.
+ *
+ *  $Log: $
+ */
+
+#ifndef SHARED_MEMORY_RING_H
+#define SHARED_MEMORY_RING_H 1
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ *  @brief  Shared memory ring layout.  The POSIX shared memory object starts with a control block, followed by the ring of event records.
+ *          Each record is a record header followed by the cell array and then the MC particle array of the event, and is always contiguous
+ *          in the ring: a record that would run past the end of the ring is preceded by a padding record filling the rest of the ring, or by
+ *          nothing if less than a record header is left.  The read and write positions only ever increase, the offset in the ring being the
+ *          position modulo the ring capacity.  There is one writer and one reader, each waiting on the other with a futex on the
+ *          notification counter the other increments.
+ */
+namespace SharedMemoryRing
+{
+    /**
+     *  @brief  Control block at the start of the shared memory object, the positions and counters of the two sides are kept on separate
+     *          cache lines
+     */
+    struct ControlBlock
+    {
+        char                        m_magic[8];         ///< Magic string
+        std::uint32_t               m_version;          ///< Layout version
+        std::uint32_t               m_padding;          ///< Unused
+        std::uint64_t               m_capacity;         ///< Size of the ring of records in bytes
+
+        alignas(64) std::atomic<std::uint64_t> m_writePosition;     ///< Bytes written, published once a record is complete
+        std::atomic<std::uint32_t>  m_writeNotify;      ///< Incremented by the writer after each record, the reader waits on it
+        std::atomic<std::uint32_t>  m_closed;           ///< Set by the writer once it has written its last record
+
+        alignas(64) std::atomic<std::uint64_t> m_readPosition;      ///< Bytes released by the reader
+        std::atomic<std::uint32_t>  m_readNotify;       ///< Incremented by the reader after each release, the writer waits on it
+    };
+
+    /**
+     *  @brief  Record type
+     */
+    enum RecordType : std::uint32_t
+    {
+        EVENT = 1,                                      ///< An event record
+        PADDING = 2                                     ///< Padding to the end of the ring
+    };
+
+    /**
+     *  @brief  Result of writing an event to the ring
+     */
+    enum WriteResult
+    {
+        WRITTEN,                                        ///< The event was written
+        TOO_LARGE,                                      ///< The event is larger than the ring, so was not written
+        TIMED_OUT                                       ///< The reader did not release enough space in time, so the event was not written
+    };
+
+    /**
+     *  @brief  Header of a record
+     */
+    struct RecordHeader
+    {
+        std::uint32_t   m_type;                         ///< Record type
+        std::uint32_t   m_size;                         ///< Size of the record in bytes, including the header
+        std::uint64_t   m_sequence;                     ///< Sequence number of the event record, counting from 0
+        std::int32_t    m_eventNumber;                  ///< Event number in the simulation job
+        std::uint32_t   m_aborted;                      ///< Whether the event was aborted
+        std::uint32_t   m_nCells;                       ///< Number of cells
+        std::uint32_t   m_nMCParticles;                 ///< Number of MC particles
+        std::int64_t    m_seed;                         ///< Random seed of the event
+    };
+
+    /**
+     *  @brief  A cell of the default readout, as written to the xml output
+     */
+    struct CellRecord
+    {
+        std::uint64_t   m_id;                           ///< Cell index
+        float           m_x;                            ///< Cell x position (mm)
+        float           m_y;                            ///< Cell y position (mm)
+        float           m_z;                            ///< Cell z position (mm)
+        float           m_energy;                       ///< Cell energy
+        std::int32_t    m_mcId;                         ///< Track id of the visible MC particle contributing most energy
+        std::uint32_t   m_padding;                      ///< Unused, keeps the records 8 byte aligned
+    };
+
+    /**
+     *  @brief  An MC particle, as written to the xml output
+     */
+    struct MCParticleRecord
+    {
+        std::int32_t    m_id;                           ///< Track id
+        std::int32_t    m_pdg;                          ///< PDG code
+        std::int32_t    m_parentId;                     ///< Parent track id
+        std::int32_t    m_padding;                      ///< Unused, keeps the records 8 byte aligned
+        double          m_mass;                         ///< Mass (GeV)
+        double          m_energy;                       ///< Energy at the start (GeV)
+        double          m_startX;                       ///< Start x position (mm)
+        double          m_startY;                       ///< Start y position (mm)
+        double          m_startZ;                       ///< Start z position (mm)
+        double          m_endX;                         ///< End x position (mm)
+        double          m_endY;                         ///< End y position (mm)
+        double          m_endZ;                         ///< End z position (mm)
+        double          m_momentumX;                    ///< Momentum x component at the start (GeV)
+        double          m_momentumY;                    ///< Momentum y component at the start (GeV)
+        double          m_momentumZ;                    ///< Momentum z component at the start (GeV)
+    };
+
+    /**
+     *  @brief  Read only view of an event record in the ring, valid until the record is released
+     */
+    struct EventView
+    {
+        const RecordHeader         *m_pHeader;          ///< The record header
+        const CellRecord           *m_pCells;           ///< The cells, m_pHeader->m_nCells of them
+        const MCParticleRecord     *m_pMCParticles;     ///< The MC particles, m_pHeader->m_nMCParticles of them
+    };
+
+    static const char           MAGIC[8] = {'G', '4', 'T', 'P', 'C', 'S', 'H', 'M'};   ///< Magic string
+    static const std::uint32_t  VERSION = 1;                                            ///< Layout version
+}
+
+/**
+ *  @brief SharedMemoryRingWriter class, creates the shared memory ring and writes events to it.  The writer blocks while the ring is full,
+ *         so a slow reader slows the simulation down rather than losing events, until the timeout.  Once a write has timed out, later writes
+ *         do not wait until the reader frees space again, so a reader that has died or never attached costs one timeout, not one per event.
+ */
+class SharedMemoryRingWriter
+{
+public:
+    /**
+     *  @brief  Constructor, creates the shared memory object, replacing any left by a previous job
+     *
+     *  @param  name the shared memory object name, starting with a slash
+     *  @param  capacity size of the ring of records in bytes
+     *  @param  timeout longest time to wait for the reader to release space for an event (ms), negative to wait until it does
+     */
+    SharedMemoryRingWriter(const std::string &name, const std::uint64_t capacity, const int timeout = -1);
+
+    /**
+     *  @brief  Destructor, marks the ring closed, so the reader ends once it has read every record, and removes the shared memory object name
+     */
+    ~SharedMemoryRingWriter();
+
+    /**
+     *  @brief  Whether the shared memory ring was created successfully
+     *
+     *  @return is ring valid
+     */
+    bool IsValid() const;
+
+    /**
+     *  @brief  Write an event, waiting for the reader to release enough space
+     *
+     *  @param  eventNumber the event number
+     *  @param  seed the random seed of the event
+     *  @param  aborted whether the event was aborted
+     *  @param  pCells the cells
+     *  @param  nCells the number of cells
+     *  @param  pMCParticles the MC particles
+     *  @param  nMCParticles the number of MC particles
+     *
+     *  @return whether the event was written, or why not
+     */
+    SharedMemoryRing::WriteResult WriteEvent(const int eventNumber, const long seed, const bool aborted, const SharedMemoryRing::CellRecord *pCells,
+        const std::size_t nCells, const SharedMemoryRing::MCParticleRecord *pMCParticles, const std::size_t nMCParticles);
+
+private:
+    /**
+     *  @brief  Wait until the reader has released enough of the ring, or the timeout
+     *
+     *  @param  nBytes the number of bytes needed
+     *
+     *  @return whether there is enough space
+     */
+    bool WaitForSpace(const std::uint64_t nBytes);
+
+    std::string                     m_name;             ///< Shared memory object name
+    SharedMemoryRing::ControlBlock *m_pControlBlock;    ///< The mapped control block
+    char                           *m_pRing;            ///< The mapped ring of records
+    std::size_t                     m_mappedSize;       ///< Size of the mapping in bytes
+    std::uint64_t                   m_sequence;         ///< Sequence number of the next event record
+    int                             m_timeout;          ///< Longest time to wait for space (ms), negative to wait until there is space
+    bool                            m_timedOut;         ///< Whether the last wait for space timed out, so the next does not wait
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief SharedMemoryRingReader class, reads events from a shared memory ring in place, without copying them
+ */
+class SharedMemoryRingReader
+{
+public:
+    /**
+     *  @brief  Constructor, opens the shared memory ring created by a writer
+     *
+     *  @param  name the shared memory object name, starting with a slash
+     */
+    SharedMemoryRingReader(const std::string &name);
+
+    /**
+     *  @brief  Destructor
+     */
+    ~SharedMemoryRingReader();
+
+    /**
+     *  @brief  Whether the shared memory ring was opened successfully
+     *
+     *  @return is ring valid
+     */
+    bool IsValid() const;
+
+    /**
+     *  @brief  Get the next event, waiting for the writer if there is none.  The previous event is released first.
+     *
+     *  @param  eventView to receive the view of the event, valid until the next call or Release
+     *  @param  timeout longest time to wait for the writer (ms), negative to wait until an event is written or the ring is closed
+     *
+     *  @return whether there is an event, false on timeout or once the ring is closed and every event has been read
+     */
+    bool NextEvent(SharedMemoryRing::EventView &eventView, const int timeout = -1);
+
+    /**
+     *  @brief  Release the current event, so the writer may reuse its space
+     */
+    void Release();
+
+    /**
+     *  @brief  Whether the writer has closed the ring and every event has been read
+     *
+     *  @return whether the ring is finished
+     */
+    bool IsFinished() const;
+
+private:
+    SharedMemoryRing::ControlBlock *m_pControlBlock;    ///< The mapped control block
+    char                           *m_pRing;            ///< The mapped ring of records
+    std::size_t                     m_mappedSize;       ///< Size of the mapping in bytes
+    std::uint64_t                   m_currentSize;      ///< Size of the current event record, 0 if none
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool SharedMemoryRingWriter::IsValid() const
+{
+    return (m_pControlBlock != nullptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool SharedMemoryRingReader::IsValid() const
+{
+    return (m_pControlBlock != nullptr);
+}
+
+#endif // #ifndef SHARED_MEMORY_RING_H
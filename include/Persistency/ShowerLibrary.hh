@@ -0,0 +1,210 @@
+/**
+ *  @file   include/Persistency/ShowerLibrary.hh
+ *
+ *  @brief  Header file for the ShowerLibraryWriter and ShowerLibraryReader classes.
+ *
+ *  $Log: $
+ */
+
+#ifndef SHOWER_LIBRARY_H
+#define SHOWER_LIBRARY_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ *  @brief  Frozen shower library layout.  A file header is followed by the energy bins, sorted by pdg code then energy, the showers, grouped
+ *          by bin, and the energy spots, grouped by shower.  Spot positions are relative to the shower start with the primary travelling
+ *          along +z, and spot energies are fractions of the primary kinetic energy, so a shower can be stamped at any position, direction
+ *          and nearby energy.  Values are written in native (little endian on all supported platforms) byte order, so that the file can be
+ *          memory mapped and used in place.
+ */
+namespace ShowerLibrary
+{
+    /**
+     *  @brief  File header
+     */
+    struct FileHeader
+    {
+        char            m_magic[8];             ///< File magic string
+        std::uint32_t   m_version;              ///< File format version
+        std::uint32_t   m_nBins;                ///< Number of energy bins
+        std::uint32_t   m_nShowers;             ///< Number of showers
+        std::uint32_t   m_padding;              ///< Unused, keeps the 64 bit fields aligned
+        std::uint64_t   m_nSpots;               ///< Number of energy spots
+    };
+
+    /**
+     *  @brief  Energy bin for one particle type
+     */
+    struct Bin
+    {
+        std::int32_t    m_pdg;                  ///< Pdg code of the primary
+        float           m_minEnergy;            ///< Lower primary kinetic energy edge (MeV)
+        float           m_maxEnergy;            ///< Upper primary kinetic energy edge (MeV)
+        std::uint32_t   m_firstShower;          ///< Index of the first shower in the bin
+        std::uint32_t   m_nShowers;             ///< Number of showers in the bin
+        std::uint32_t   m_padding;              ///< Unused
+    };
+
+    /**
+     *  @brief  One library shower
+     */
+    struct Shower
+    {
+        float           m_energy;               ///< Simulated primary kinetic energy (MeV)
+        std::uint32_t   m_nSpots;               ///< Number of energy spots
+        std::uint64_t   m_firstSpot;            ///< Index of the first energy spot
+    };
+
+    /**
+     *  @brief  One energy spot
+     */
+    struct Spot
+    {
+        float           m_x;                    ///< Position transverse to the primary direction (mm)
+        float           m_y;                    ///< Position transverse to the primary direction (mm)
+        float           m_z;                    ///< Position along the primary direction (mm)
+        float           m_energyFraction;       ///< Deposited energy as a fraction of the primary kinetic energy
+    };
+
+    typedef std::vector<Spot> SpotVector;
+
+    static const char           MAGIC[8] = {'G', '4', 'T', 'P', 'C', 'S', 'H', 'L'};   ///< File magic string
+    static const std::uint32_t  VERSION = 1;                                            ///< File format version
+}
+
+/**
+ *  @brief ShowerLibraryWriter class
+ */
+class ShowerLibraryWriter
+{
+public:
+    /**
+     *  @brief  Constructor
+     */
+    ShowerLibraryWriter();
+
+    /**
+     *  @brief  Destructor
+     */
+    ~ShowerLibraryWriter();
+
+    /**
+     *  @brief  Start a new energy bin, bins must be added in order of pdg code then energy
+     *
+     *  @param  pdg code of the primary
+     *  @param  minEnergy lower primary kinetic energy edge (MeV)
+     *  @param  maxEnergy upper primary kinetic energy edge (MeV)
+     */
+    void AddBin(const int pdg, const float minEnergy, const float maxEnergy);
+
+    /**
+     *  @brief  Add a shower to the current energy bin
+     *
+     *  @param  energy the simulated primary kinetic energy (MeV)
+     *  @param  spots the energy spots, relative to the shower start and direction
+     */
+    void AddShower(const float energy, const ShowerLibrary::SpotVector &spots);
+
+    /**
+     *  @brief  Write the library to file
+     *
+     *  @param  fileName the library file name
+     *
+     *  @return whether the library was written successfully
+     */
+    bool Write(const std::string &fileName) const;
+
+private:
+    typedef std::vector<ShowerLibrary::Bin> BinVector;
+    typedef std::vector<ShowerLibrary::Shower> ShowerVector;
+
+    BinVector                   m_bins;                 ///< The energy bins
+    ShowerVector                m_showers;              ///< The showers
+    ShowerLibrary::SpotVector   m_spots;                ///< The energy spots
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief ShowerLibraryReader class, memory maps a library file so showers are read in place
+ */
+class ShowerLibraryReader
+{
+public:
+    /**
+     *  @brief  Constructor, maps the library file and checks its layout
+     *
+     *  @param  fileName the library file name
+     */
+    ShowerLibraryReader(const std::string &fileName);
+
+    /**
+     *  @brief  Destructor, unmaps the library file
+     */
+    ~ShowerLibraryReader();
+
+    /**
+     *  @brief  Whether the library was mapped successfully
+     *
+     *  @return is library valid
+     */
+    bool IsValid() const;
+
+    /**
+     *  @brief  Find the energy bin for a primary
+     *
+     *  @param  pdg code of the primary
+     *  @param  energy kinetic energy of the primary (MeV)
+     *
+     *  @return the bin, nullptr if the library has no showers for the primary
+     */
+    const ShowerLibrary::Bin *FindBin(const int pdg, const double energy) const;
+
+    /**
+     *  @brief  Pick a shower from an energy bin
+     *
+     *  @param  bin the energy bin
+     *  @param  random uniform random number in [0, 1)
+     *
+     *  @return the shower
+     */
+    const ShowerLibrary::Shower &GetShower(const ShowerLibrary::Bin &bin, const double random) const;
+
+    /**
+     *  @brief  Get the energy spots for a shower
+     *
+     *  @param  shower the shower
+     *
+     *  @return address of the first of the shower's energy spots
+     */
+    const ShowerLibrary::Spot *GetSpots(const ShowerLibrary::Shower &shower) const;
+
+private:
+    void                        *m_pMapping;            ///< Address of the mapped file
+    std::size_t                  m_mappingSize;         ///< Size of the mapped file in bytes
+    const ShowerLibrary::Bin    *m_pBins;               ///< The energy bins
+    const ShowerLibrary::Shower *m_pShowers;            ///< The showers
+    const ShowerLibrary::Spot   *m_pSpots;              ///< The energy spots
+    std::uint32_t                m_nBins;               ///< Number of energy bins
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool ShowerLibraryReader::IsValid() const
+{
+    return (m_pMapping != nullptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const ShowerLibrary::Spot *ShowerLibraryReader::GetSpots(const ShowerLibrary::Shower &shower) const
+{
+    return m_pSpots + shower.m_firstSpot;
+}
+
+#endif // #ifndef SHOWER_LIBRARY_H
@@ -0,0 +1,262 @@
+/**
+ *  @file   include/Readout/DepositBuffer.hh
+ *
+ *  @brief  Header file for the DepositBuffer class.
+ *
+ *  $Log: $
+ */
+
+#ifndef DEPOSIT_BUFFER_H
+#define DEPOSIT_BUFFER_H 1
+
+#include <cstddef>
+#include <vector>
+
+#include "Objects/Cell.hh"
+
+class VoxelGrid;
+
+/**
+ *  @brief DepositBuffer class, raw energy deposits for one event stored as a structure of arrays
+ */
+class DepositBuffer
+{
+public:
+    /**
+     *  @brief  Constructor
+     */
+    DepositBuffer();
+
+    /**
+     *  @brief  Destructor
+     */
+    ~DepositBuffer();
+
+    /**
+     *  @brief  Append an energy deposit
+     *
+     *  @param  x position of deposit (mm)
+     *  @param  y position of deposit (mm)
+     *  @param  z position of deposit (mm)
+     *  @param  postX post step position of deposit (mm)
+     *  @param  postY post step position of deposit (mm)
+     *  @param  postZ post step position of deposit (mm)
+     *  @param  energy deposited
+     *  @param  trackId geant4 track id creating the deposit
+     */
+    void Add(const float x, const float y, const float z, const float postX, const float postY, const float postZ, const float energy,
+        const int trackId);
+
+    /**
+     *  @brief  Append an energy deposit with no step length
+     *
+     *  @param  x position of deposit (mm)
+     *  @param  y position of deposit (mm)
+     *  @param  z position of deposit (mm)
+     *  @param  energy deposited
+     *  @param  trackId geant4 track id creating the deposit
+     */
+    void Add(const float x, const float y, const float z, const float energy, const int trackId);
+
+    /**
+     *  @brief  Remove all deposits, retaining the allocated capacity for the next event
+     */
+    void Clear();
+
+    /**
+     *  @brief  Get the number of deposits
+     *
+     *  @return number of deposits
+     */
+    std::size_t Size() const;
+
+    /**
+     *  @brief  Resize the buffer, leaving new deposits zero initialised
+     *
+     *  @param  nDeposits the number of deposits
+     */
+    void Resize(const std::size_t nDeposits);
+
+    /**
+     *  @brief  Get the deposit (pre step) x positions
+     *
+     *  @return m_x
+     */
+    const std::vector<float> &GetX() const;
+
+    /**
+     *  @brief  Get the deposit (pre step) y positions
+     *
+     *  @return m_y
+     */
+    const std::vector<float> &GetY() const;
+
+    /**
+     *  @brief  Get the deposit (pre step) z positions
+     *
+     *  @return m_z
+     */
+    const std::vector<float> &GetZ() const;
+
+    /**
+     *  @brief  Get the deposit post step x positions
+     *
+     *  @return m_postX
+     */
+    const std::vector<float> &GetPostX() const;
+
+    /**
+     *  @brief  Get the deposit post step y positions
+     *
+     *  @return m_postY
+     */
+    const std::vector<float> &GetPostY() const;
+
+    /**
+     *  @brief  Get the deposit post step z positions
+     *
+     *  @return m_postZ
+     */
+    const std::vector<float> &GetPostZ() const;
+
+    /**
+     *  @brief  Get the deposit energies
+     *
+     *  @return m_energy
+     */
+    const std::vector<float> &GetEnergy() const;
+
+    /**
+     *  @brief  Get the deposit geant4 track ids
+     *
+     *  @return m_trackId
+     */
+    const std::vector<int> &GetTrackId() const;
+
+    /**
+     *  @brief  Voxelize the deposits, sort them by cell index and sum each cell into the cell list
+     *
+     *  @param  voxelGrid the readout grid
+     *  @param  cellList to receive the summed cells
+     */
+    void Reduce(const VoxelGrid &voxelGrid, CellList &cellList) const;
+
+    /**
+     *  @brief  Share the energy of each step longer than the given length between equal segments along the step, appending to another buffer
+     *
+     *  @param  maxStepLength the longest step kept as a single deposit at its pre step position, longer steps are split into segments no
+     *          longer than this, each deposited at its midpoint (mm)
+     *  @param  splitBuffer to receive the deposits
+     */
+    void SplitSteps(const float maxStepLength, DepositBuffer &splitBuffer) const;
+
+private:
+    typedef std::vector<CellIndex> CellIndexVector;
+    typedef std::vector<unsigned int> UIntVector;
+
+    /**
+     *  @brief  Stable least significant digit radix sort of cell indices, carrying the original deposit positions
+     *
+     *  @param  cellIndices the cell indices, sorted on return
+     *  @param  order the original deposit positions, permuted alongside the cell indices on return
+     */
+    static void RadixSort(CellIndexVector &cellIndices, UIntVector &order);
+
+    std::vector<float>      m_x;          ///< Deposit x positions
+    std::vector<float>      m_y;          ///< Deposit y positions
+    std::vector<float>      m_z;          ///< Deposit z positions
+    std::vector<float>      m_postX;      ///< Deposit post step x positions
+    std::vector<float>      m_postY;      ///< Deposit post step y positions
+    std::vector<float>      m_postZ;      ///< Deposit post step z positions
+    std::vector<float>      m_energy;     ///< Deposit energies
+    std::vector<int>        m_trackId;    ///< Deposit geant4 track ids
+
+    friend class DepositArchiveReader;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void DepositBuffer::Add(const float x, const float y, const float z, const float postX, const float postY, const float postZ,
+    const float energy, const int trackId)
+{
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_z.push_back(z);
+    m_postX.push_back(postX);
+    m_postY.push_back(postY);
+    m_postZ.push_back(postZ);
+    m_energy.push_back(energy);
+    m_trackId.push_back(trackId);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void DepositBuffer::Add(const float x, const float y, const float z, const float energy, const int trackId)
+{
+    this->Add(x, y, z, x, y, z, energy, trackId);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::size_t DepositBuffer::Size() const
+{
+    return m_energy.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const std::vector<float> &DepositBuffer::GetX() const
+{
+    return m_x;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const std::vector<float> &DepositBuffer::GetY() const
+{
+    return m_y;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const std::vector<float> &DepositBuffer::GetZ() const
+{
+    return m_z;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const std::vector<float> &DepositBuffer::GetPostX() const
+{
+    return m_postX;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const std::vector<float> &DepositBuffer::GetPostY() const
+{
+    return m_postY;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const std::vector<float> &DepositBuffer::GetPostZ() const
+{
+    return m_postZ;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const std::vector<float> &DepositBuffer::GetEnergy() const
+{
+    return m_energy;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const std::vector<int> &DepositBuffer::GetTrackId() const
+{
+    return m_trackId;
+}
+
+#endif // #ifndef DEPOSIT_BUFFER_H
@@ -0,0 +1,381 @@
+/**
+ *  @file   include/Readout/VoxelGrid.hh
+ *
+ *  @brief  Header file for the VoxelGrid class.
+ *
+ *  $Log: $
+ */
+
+#ifndef VOXEL_GRID_H
+#define VOXEL_GRID_H 1
+
+#include <cstddef>
+
+#include "Objects/Cell.hh"
+
+/**
+ *  @brief VoxelGrid class
+ */
+class VoxelGrid
+{
+public:
+    /**
+     *  @brief  Scheme used to pack the three bin indices into a single cell index
+     */
+    enum IndexScheme
+    {
+        LINEAR, ///< x + y * nBinsX + z * nBinsX * nBinsY
+        MORTON  ///< Interleaved bits of the x, y and z bin indices (z-order curve)
+    };
+
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  xLow low x edge of the grid (mm)
+     *  @param  yLow low y edge of the grid (mm)
+     *  @param  zLow low z edge of the grid (mm)
+     *  @param  xWidth grid width along x (mm)
+     *  @param  yWidth grid width along y (mm)
+     *  @param  zWidth grid width along z (mm)
+     *  @param  nBinsX number of bins along x
+     *  @param  nBinsY number of bins along y
+     *  @param  nBinsZ number of bins along z
+     *  @param  indexScheme cell index packing scheme
+     */
+    VoxelGrid(const double xLow, const double yLow, const double zLow, const double xWidth, const double yWidth, const double zWidth,
+        const unsigned int nBinsX, const unsigned int nBinsY, const unsigned int nBinsZ, const IndexScheme indexScheme = LINEAR);
+
+    /**
+     *  @brief  Destructor
+     */
+    ~VoxelGrid();
+
+    /**
+     *  @brief  Get the index of the cell containing the given position, positions outside the grid are clamped to the edge cells
+     *
+     *  @param  x position (mm)
+     *  @param  y position (mm)
+     *  @param  z position (mm)
+     *
+     *  @return cell index
+     */
+    CellIndex GetCellIndex(const double x, const double y, const double z) const;
+
+    /**
+     *  @brief  Get the cell indices for a batch of positions, giving the same indices as GetCellIndex in a loop the compiler can vectorize
+     *
+     *  @param  pX the x positions (mm)
+     *  @param  pY the y positions (mm)
+     *  @param  pZ the z positions (mm)
+     *  @param  nPositions the number of positions
+     *  @param  pCellIndices to receive the cell indices
+     */
+    void GetCellIndices(const float *pX, const float *pY, const float *pZ, const std::size_t nPositions, CellIndex *pCellIndices) const;
+
+    /**
+     *  @brief  Get the cell containing the given position, with no energy
+     *
+     *  @param  x position (mm)
+     *  @param  y position (mm)
+     *  @param  z position (mm)
+     *
+     *  @return the cell
+     */
+    Cell GetCell(const double x, const double y, const double z) const;
+
+    /**
+     *  @brief  Get the centre of the cell with the given index
+     *
+     *  @param  cellIndex the cell index
+     *  @param  x to receive the cell centre along x (mm)
+     *  @param  y to receive the cell centre along y (mm)
+     *  @param  z to receive the cell centre along z (mm)
+     */
+    void GetCellCentre(const CellIndex cellIndex, float &x, float &y, float &z) const;
+
+    /**
+     *  @brief  Unpack a cell index into its bin indices
+     *
+     *  @param  cellIndex the cell index
+     *  @param  xBin to receive the bin index along x
+     *  @param  yBin to receive the bin index along y
+     *  @param  zBin to receive the bin index along z
+     */
+    void GetBinIndices(const CellIndex cellIndex, unsigned int &xBin, unsigned int &yBin, unsigned int &zBin) const;
+
+    /**
+     *  @brief  Whether the given position lies inside the grid
+     *
+     *  @param  x position (mm)
+     *  @param  y position (mm)
+     *  @param  z position (mm)
+     *
+     *  @return is position inside grid
+     */
+    bool Contains(const double x, const double y, const double z) const;
+
+    /**
+     *  @brief  Whether the grid has the same number of bins and bin width along every axis
+     *
+     *  @return m_uniformCubic
+     */
+    bool IsUniformCubic() const;
+
+    /**
+     *  @brief  Get the cell index packing scheme
+     *
+     *  @return m_indexScheme
+     */
+    IndexScheme GetIndexScheme() const;
+
+    /**
+     *  @brief  Get the number of bins along x
+     *
+     *  @return m_nBinsX
+     */
+    unsigned int GetNBinsX() const;
+
+    /**
+     *  @brief  Get the number of bins along y
+     *
+     *  @return m_nBinsY
+     */
+    unsigned int GetNBinsY() const;
+
+    /**
+     *  @brief  Get the number of bins along z
+     *
+     *  @return m_nBinsZ
+     */
+    unsigned int GetNBinsZ() const;
+
+    /**
+     *  @brief  Check the bin counts can be packed into a 64 bit cell index using the given scheme
+     *
+     *  @param  nBinsX number of bins along x
+     *  @param  nBinsY number of bins along y
+     *  @param  nBinsZ number of bins along z
+     *  @param  indexScheme cell index packing scheme
+     *
+     *  @return are the bin counts representable
+     */
+    static bool IsRepresentable(const unsigned int nBinsX, const unsigned int nBinsY, const unsigned int nBinsZ, const IndexScheme indexScheme);
+
+    static const unsigned int MAX_MORTON_BINS_PER_AXIS = (1u << 21); ///< Morton indices hold 21 bits per axis
+
+private:
+    /**
+     *  @brief  Specialisation of the cell index implementations, selected at construction
+     */
+    enum Specialisation
+    {
+        LINEAR_GENERAL,
+        LINEAR_UNIFORM_CUBIC,
+        MORTON_GENERAL,
+        MORTON_UNIFORM_CUBIC
+    };
+
+    /**
+     *  @brief  Get the cell index, specialised at compile time for the index scheme and for uniform cubic grids
+     *
+     *  @param  x position (mm)
+     *  @param  y position (mm)
+     *  @param  z position (mm)
+     *
+     *  @return cell index
+     */
+    template <IndexScheme SCHEME, bool UNIFORM_CUBIC>
+    CellIndex GetCellIndexImpl(const double x, const double y, const double z) const;
+
+    /**
+     *  @brief  Get the cell indices for a batch of positions, specialised at compile time for the index scheme and for uniform cubic grids
+     *
+     *  @param  pX the x positions (mm)
+     *  @param  pY the y positions (mm)
+     *  @param  pZ the z positions (mm)
+     *  @param  nPositions the number of positions
+     *  @param  pCellIndices to receive the cell indices
+     */
+    template <IndexScheme SCHEME, bool UNIFORM_CUBIC>
+    void GetCellIndicesImpl(const float *pX, const float *pY, const float *pZ, const std::size_t nPositions, CellIndex *pCellIndices) const;
+
+    /**
+     *  @brief  Get the bin along one axis, clamped to [0, nBins)
+     *
+     *  @param  position along the axis (mm)
+     *  @param  low edge of the axis (mm)
+     *  @param  inverseBinWidth reciprocal of the bin width (1/mm)
+     *  @param  nBins number of bins along the axis
+     *
+     *  @return bin index
+     */
+    static unsigned int GetBin(const double position, const double low, const double inverseBinWidth, const unsigned int nBins);
+
+    /**
+     *  @brief  Spread the low 21 bits of a bin index so that there are two zero bits between each
+     *
+     *  @param  bin the bin index
+     *
+     *  @return the spread bits
+     */
+    static CellIndex SpreadBits(const unsigned int bin);
+
+    /**
+     *  @brief  Inverse of SpreadBits
+     *
+     *  @param  bits the spread bits
+     *
+     *  @return the bin index
+     */
+    static unsigned int CompactBits(const CellIndex bits);
+
+    double              m_xLow;                 ///< Low x edge of the grid
+    double              m_yLow;                 ///< Low y edge of the grid
+    double              m_zLow;                 ///< Low z edge of the grid
+    double              m_xBinWidth;            ///< Bin width along x
+    double              m_yBinWidth;            ///< Bin width along y
+    double              m_zBinWidth;            ///< Bin width along z
+    double              m_xInverseBinWidth;     ///< Reciprocal of the bin width along x
+    double              m_yInverseBinWidth;     ///< Reciprocal of the bin width along y
+    double              m_zInverseBinWidth;     ///< Reciprocal of the bin width along z
+    unsigned int        m_nBinsX;               ///< Number of bins along x
+    unsigned int        m_nBinsY;               ///< Number of bins along y
+    unsigned int        m_nBinsZ;               ///< Number of bins along z
+    CellIndex           m_strideY;              ///< Linear index stride for one step in y
+    CellIndex           m_strideZ;              ///< Linear index stride for one step in z
+    IndexScheme         m_indexScheme;          ///< Cell index packing scheme
+    bool                m_uniformCubic;         ///< Same bin count and bin width along every axis
+    Specialisation      m_specialisation;       ///< Specialisation of the cell index implementations for this grid
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline CellIndex VoxelGrid::GetCellIndex(const double x, const double y, const double z) const
+{
+    // ATTN : A switch, rather than a pointer to member, lets the specialised implementation inline into the caller.  The branch always goes
+    //        the same way for a grid, so is predicted.
+    switch (m_specialisation)
+    {
+        case LINEAR_UNIFORM_CUBIC: return this->GetCellIndexImpl<LINEAR, true>(x, y, z);
+        case MORTON_GENERAL: return this->GetCellIndexImpl<MORTON, false>(x, y, z);
+        case MORTON_UNIFORM_CUBIC: return this->GetCellIndexImpl<MORTON, true>(x, y, z);
+        case LINEAR_GENERAL: default: return this->GetCellIndexImpl<LINEAR, false>(x, y, z);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void VoxelGrid::GetCellIndices(const float *pX, const float *pY, const float *pZ, const std::size_t nPositions, CellIndex *pCellIndices) const
+{
+    // ATTN : Dispatched once per batch, so each loop is specialised and free of branches on the grid layout
+    switch (m_specialisation)
+    {
+        case LINEAR_UNIFORM_CUBIC: this->GetCellIndicesImpl<LINEAR, true>(pX, pY, pZ, nPositions, pCellIndices); break;
+        case MORTON_GENERAL: this->GetCellIndicesImpl<MORTON, false>(pX, pY, pZ, nPositions, pCellIndices); break;
+        case MORTON_UNIFORM_CUBIC: this->GetCellIndicesImpl<MORTON, true>(pX, pY, pZ, nPositions, pCellIndices); break;
+        case LINEAR_GENERAL: default: this->GetCellIndicesImpl<LINEAR, false>(pX, pY, pZ, nPositions, pCellIndices); break;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool VoxelGrid::IsUniformCubic() const
+{
+    return m_uniformCubic;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline VoxelGrid::IndexScheme VoxelGrid::GetIndexScheme() const
+{
+    return m_indexScheme;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int VoxelGrid::GetNBinsX() const
+{
+    return m_nBinsX;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int VoxelGrid::GetNBinsY() const
+{
+    return m_nBinsY;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int VoxelGrid::GetNBinsZ() const
+{
+    return m_nBinsZ;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int VoxelGrid::GetBin(const double position, const double low, const double inverseBinWidth, const unsigned int nBins)
+{
+    // ATTN : Branch free clamp so that batched loops over this function vectorize
+    const double maxBin(static_cast<double>(nBins - 1));
+    double fractionalBin((position - low) * inverseBinWidth);
+    fractionalBin = (fractionalBin > 0. ? fractionalBin : 0.);
+    fractionalBin = (fractionalBin < maxBin ? fractionalBin : maxBin);
+    return static_cast<unsigned int>(fractionalBin);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline CellIndex VoxelGrid::SpreadBits(const unsigned int bin)
+{
+    CellIndex bits(bin & 0x1fffff);
+    bits = (bits | (bits << 32)) & 0x1f00000000ffffULL;
+    bits = (bits | (bits << 16)) & 0x1f0000ff0000ffULL;
+    bits = (bits | (bits << 8))  & 0x100f00f00f00f00fULL;
+    bits = (bits | (bits << 4))  & 0x10c30c30c30c30c3ULL;
+    bits = (bits | (bits << 2))  & 0x1249249249249249ULL;
+    return bits;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int VoxelGrid::CompactBits(const CellIndex bits)
+{
+    CellIndex bin(bits & 0x1249249249249249ULL);
+    bin = (bin | (bin >> 2))  & 0x10c30c30c30c30c3ULL;
+    bin = (bin | (bin >> 4))  & 0x100f00f00f00f00fULL;
+    bin = (bin | (bin >> 8))  & 0x1f0000ff0000ffULL;
+    bin = (bin | (bin >> 16)) & 0x1f00000000ffffULL;
+    bin = (bin | (bin >> 32)) & 0x1fffffULL;
+    return static_cast<unsigned int>(bin);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <VoxelGrid::IndexScheme SCHEME, bool UNIFORM_CUBIC>
+inline CellIndex VoxelGrid::GetCellIndexImpl(const double x, const double y, const double z) const
+{
+    // ATTN : For uniform cubic grids the x axis parameters are valid for every axis, so only one bin width and bin count are loaded
+    const unsigned int xBin(GetBin(x, m_xLow, m_xInverseBinWidth, m_nBinsX));
+    const unsigned int yBin(GetBin(y, m_yLow, UNIFORM_CUBIC ? m_xInverseBinWidth : m_yInverseBinWidth, UNIFORM_CUBIC ? m_nBinsX : m_nBinsY));
+    const unsigned int zBin(GetBin(z, m_zLow, UNIFORM_CUBIC ? m_xInverseBinWidth : m_zInverseBinWidth, UNIFORM_CUBIC ? m_nBinsX : m_nBinsZ));
+
+    if (SCHEME == MORTON)
+        return (SpreadBits(xBin) | (SpreadBits(yBin) << 1) | (SpreadBits(zBin) << 2));
+
+    if (UNIFORM_CUBIC)
+        return (static_cast<CellIndex>(xBin) + static_cast<CellIndex>(m_nBinsX) * (static_cast<CellIndex>(yBin) + static_cast<CellIndex>(m_nBinsX) * zBin));
+
+    return (static_cast<CellIndex>(xBin) + static_cast<CellIndex>(yBin) * m_strideY + static_cast<CellIndex>(zBin) * m_strideZ);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <VoxelGrid::IndexScheme SCHEME, bool UNIFORM_CUBIC>
+inline void VoxelGrid::GetCellIndicesImpl(const float *pX, const float *pY, const float *pZ, const std::size_t nPositions, CellIndex *pCellIndices) const
+{
+    for (std::size_t i = 0; i < nPositions; ++i)
+        pCellIndices[i] = this->GetCellIndexImpl<SCHEME, UNIFORM_CUBIC>(pX[i], pY[i], pZ[i]);
+}
+
+#endif // #ifndef VOXEL_GRID_H
@@ -0,0 +1,24 @@
+#!/bin/bash
+# Run every benchmark workload and collect one json line per workload in BenchmarkResults.json
+# Usage: RunBenchmarks.sh path/to/G4TPC_bench [OutputDirectory]
+
+if [ $# -lt 1 ] || [ $# -gt 2 ]; then
+    echo "Usage: $0 path/to/G4TPC_bench [OutputDirectory]"
+    exit 1
+fi
+
+BENCH=$(readlink -f "$1")
+WORKLOADS=$(cd "$(dirname "$0")" && pwd)
+OUTPUT=${2:-.}
+
+mkdir -p "${OUTPUT}" && cd "${OUTPUT}" || exit 1
+rm -f BenchmarkResults.json
+
+# The genie workload reads its tracker file relative to the working directory
+cp "${WORKLOADS}/GenieSample.txt" .
+
+for WORKLOAD in Muon2GeV Electron1GeV PiPlus5GeV GenieSample; do
+    "${BENCH}" "${WORKLOADS}/${WORKLOAD}.xml" BenchmarkResults.json > "Bench_${WORKLOAD}.log" 2>&1 || { echo "Workload ${WORKLOAD} failed, see Bench_${WORKLOAD}.log"; exit 1; }
+done
+
+cat BenchmarkResults.json
@@ -0,0 +1,33 @@
+#!/bin/bash
+# Simulate the same electron, positron and photon samples with the parameterised EM shower model switched off and on, then compare the cell
+# energy, cell multiplicity, energy centroid and shower profiles of the two outputs for each species
+# Usage: ValidateEMShowerModel.sh path/to/G4TPC path/to/G4TPCCompareOutputs [OutputDirectory]
+
+if [ $# -lt 2 ] || [ $# -gt 3 ]; then
+    echo "Usage: $0 path/to/G4TPC path/to/G4TPCCompareOutputs [OutputDirectory]"
+    exit 1
+fi
+
+G4TPC=$(readlink -f "$1")
+COMPARE=$(readlink -f "$2")
+CONFIGS=$(cd "$(dirname "$0")" && pwd)
+OUTPUT=${3:-.}
+
+mkdir -p "${OUTPUT}" && cd "${OUTPUT}" || exit 1
+: > EMShowerValidation.txt
+
+for SPECIES in e- e+ gamma; do
+    for CONFIG in EMShowerFull EMShowerModel; do
+        # The photon sample checks the sampled conversion point, the positron sample the annihilation energy
+        sed -e "s|<Species>e-</Species>|<Species>${SPECIES}</Species>|" \
+            -e "s|<Output3DXmlFileName>${CONFIG}.xml<|<Output3DXmlFileName>${CONFIG}_${SPECIES}.xml<|" \
+            "${CONFIGS}/${CONFIG}.xml" > "${CONFIG}_${SPECIES}_Config.xml"
+
+        "${G4TPC}" "${CONFIG}_${SPECIES}_Config.xml" > "${CONFIG}_${SPECIES}.log" 2>&1 ||
+            { echo "Simulation ${CONFIG} ${SPECIES} failed, see ${CONFIG}_${SPECIES}.log"; exit 1; }
+    done
+
+    # Profiles in 1 cm bins, longitudinal out to 1 m and transverse out to 1 m
+    echo "${SPECIES}" | tee -a EMShowerValidation.txt
+    "${COMPARE}" "EMShowerModel_${SPECIES}.xml" "EMShowerFull_${SPECIES}.xml" 100 10 | tee -a EMShowerValidation.txt
+done
@@ -0,0 +1,70 @@
+/**
+ *  @file   src/Analysis/CellEnergyHistogramReducer.cc
+ *
+ *  @brief  Implementation of the CellEnergyHistogramReducer class.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include "G4SystemOfUnits.hh"
+
+#include "Analysis/CellEnergyHistogramReducer.hh"
+
+CellEnergyHistogramReducer::CellEnergyHistogramReducer(const std::string &fileName, const int nBins, const double binWidth) :
+    m_fileName(fileName),
+    m_binWidth(binWidth),
+    m_nCells(nBins + 1, 0),
+    m_nEvents(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void CellEnergyHistogramReducer::BeginOfRun(const std::string &runLabel)
+{
+    m_runFileName = EventReducer::GetRunFileName(m_fileName, runLabel);
+    std::fill(m_nCells.begin(), m_nCells.end(), 0);
+    m_nEvents = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void CellEnergyHistogramReducer::ProcessEvent(const int /*eventNumber*/, const CellList &cellList, const MCParticleList &/*mcParticleList*/)
+{
+    const std::size_t overflowBin(m_nCells.size() - 1);
+
+    for (const auto &iter : cellList.m_idCellMap)
+    {
+        const std::size_t bin(iter.second->GetEnergy() / (m_binWidth * CLHEP::MeV));
+        m_nCells.at(std::min(bin, overflowBin))++;
+    }
+
+    m_nEvents++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void CellEnergyHistogramReducer::EndOfRun()
+{
+    std::ofstream file(m_runFileName, std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        std::cout << "Unable to open cell energy histogram " << m_runFileName << std::endl;
+        return;
+    }
+
+    file << "BinLow,BinHigh,Cells,CellsPerEvent" << std::endl;
+
+    const double norm(m_nEvents > 0 ? 1. / m_nEvents : 0.);
+    const std::size_t overflowBin(m_nCells.size() - 1);
+
+    for (std::size_t bin = 0; bin < overflowBin; bin++)
+        file << bin * m_binWidth << "," << (bin + 1) * m_binWidth << "," << m_nCells.at(bin) << "," << m_nCells.at(bin) * norm << "\n";
+
+    file << overflowBin * m_binWidth << ",inf," << m_nCells.at(overflowBin) << "," << m_nCells.at(overflowBin) * norm << "\n";
+}
@@ -0,0 +1,73 @@
+/**
+ *  @file   src/Analysis/EnergySummaryReducer.cc
+ *
+ *  @brief  Implementation of the EnergySummaryReducer class.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <iostream>
+
+#include "G4SystemOfUnits.hh"
+
+#include "Analysis/EnergySummaryReducer.hh"
+
+EnergySummaryReducer::EnergySummaryReducer(const std::string &fileName) :
+    m_fileName(fileName)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EnergySummaryReducer::BeginOfRun(const std::string &runLabel)
+{
+    const std::string fileName(EventReducer::GetRunFileName(m_fileName, runLabel));
+    m_file.open(fileName, std::ios::trunc);
+
+    if (!m_file.is_open())
+    {
+        std::cout << "Unable to open energy summary " << fileName << std::endl;
+        return;
+    }
+
+    m_file << "Event,Cells,VisibleEnergy,PrimaryEnergy,ContainmentFraction,MaxCellEnergy" << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EnergySummaryReducer::ProcessEvent(const int eventNumber, const CellList &cellList, const MCParticleList &mcParticleList)
+{
+    if (!m_file.is_open())
+        return;
+
+    // ATTN : Cell energies are in geant4 units, MC particle energies in GeV
+    double visibleEnergy(0.), maxCellEnergy(0.);
+
+    for (const auto &iter : cellList.m_idCellMap)
+    {
+        const double energy(iter.second->GetEnergy() / CLHEP::GeV);
+        visibleEnergy += energy;
+        maxCellEnergy = std::max(maxCellEnergy, energy);
+    }
+
+    double primaryEnergy(0.);
+
+    for (const auto &iter : mcParticleList.m_mcParticles)
+    {
+        const MCParticle *pMCParticle(iter.second);
+
+        if (pMCParticle->GetParent() == 0 && pMCParticle->GetNumberOfTrajectoryPoints() > 0)
+            primaryEnergy += pMCParticle->GetEnergy() - pMCParticle->GetMass();
+    }
+
+    m_file << eventNumber << "," << cellList.m_idCellMap.size() << "," << visibleEnergy << "," << primaryEnergy << ","
+           << (primaryEnergy > 0. ? visibleEnergy / primaryEnergy : 0.) << "," << maxCellEnergy << "\n";
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EnergySummaryReducer::EndOfRun()
+{
+    m_file.close();
+}
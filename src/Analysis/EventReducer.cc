@@ -0,0 +1,46 @@
+/**
+ *  @file   src/Analysis/EventReducer.cc
+ *
+ *  @brief  Implementation of the EventReducer class.
+ *
+ *  $Log: $
+ */
+
+#include "Analysis/EventReducer.hh"
+
+EventReducer::~EventReducer()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string EventReducer::GetRunFileName(const std::string &fileName, const std::string &runLabel)
+{
+    const std::size_t extension(fileName.rfind('.'));
+
+    if (extension == std::string::npos)
+        return fileName + runLabel;
+
+    return fileName.substr(0, extension) + runLabel + fileName.substr(extension);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const MCParticle *EventReducer::GetLeadingPrimary(const MCParticleList &mcParticleList)
+{
+    const MCParticle *pLeadingPrimary(nullptr);
+
+    // ATTN : Primaries are the particle gun particles, or the genie final state particles, the daughters of the neutrino with track id 0
+    for (const auto &iter : mcParticleList.m_mcParticles)
+    {
+        const MCParticle *pMCParticle(iter.second);
+
+        if (pMCParticle->GetParent() != 0 || pMCParticle->GetNumberOfTrajectoryPoints() == 0)
+            continue;
+
+        if (!pLeadingPrimary || pMCParticle->GetEnergy() > pLeadingPrimary->GetEnergy())
+            pLeadingPrimary = pMCParticle;
+    }
+
+    return pLeadingPrimary;
+}
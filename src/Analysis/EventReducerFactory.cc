@@ -0,0 +1,82 @@
+/**
+ *  @file   src/Analysis/EventReducerFactory.cc
+ *
+ *  @brief  Implementation of the EventReducerFactory class.
+ *
+ *  $Log: $
+ */
+
+#include <iostream>
+
+#include "Analysis/CellEnergyHistogramReducer.hh"
+#include "Analysis/EnergySummaryReducer.hh"
+#include "Analysis/EventReducerFactory.hh"
+#include "Analysis/ShowerProfileReducer.hh"
+
+namespace
+{
+
+EventReducer *CreateEnergySummary(const EventReducerParameters &eventReducerParameters)
+{
+    return new EnergySummaryReducer(eventReducerParameters.m_fileName);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventReducer *CreateShowerProfile(const EventReducerParameters &eventReducerParameters)
+{
+    return new ShowerProfileReducer(eventReducerParameters.m_fileName, eventReducerParameters.m_nBins, eventReducerParameters.m_binWidth);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventReducer *CreateCellEnergyHistogram(const EventReducerParameters &eventReducerParameters)
+{
+    return new CellEnergyHistogramReducer(eventReducerParameters.m_fileName, eventReducerParameters.m_nBins, eventReducerParameters.m_binWidth);
+}
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventReducer *EventReducerFactory::Create(const EventReducerParameters &eventReducerParameters)
+{
+    const CreatorMap &creators(EventReducerFactory::GetCreators());
+    const CreatorMap::const_iterator iter(creators.find(eventReducerParameters.m_type));
+
+    if (iter == creators.end())
+    {
+        std::cout << "Unknown event reducer : " << eventReducerParameters.m_type << std::endl;
+        return nullptr;
+    }
+
+    return iter->second(eventReducerParameters);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventReducerFactory::Register(const std::string &type, const Creator creator)
+{
+    EventReducerFactory::GetCreators()[type] = creator;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventReducerFactory::IsRegistered(const std::string &type)
+{
+    const CreatorMap &creators(EventReducerFactory::GetCreators());
+    return (creators.find(type) != creators.end());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventReducerFactory::CreatorMap &EventReducerFactory::GetCreators()
+{
+    static CreatorMap creators = {
+        {"EnergySummary", CreateEnergySummary},
+        {"ShowerProfile", CreateShowerProfile},
+        {"CellEnergyHistogram", CreateCellEnergyHistogram}
+    };
+
+    return creators;
+}
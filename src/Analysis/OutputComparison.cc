@@ -0,0 +1,246 @@
+/**
+ *  @file   src/Analysis/OutputComparison.cc
+ *
+ *  @brief  Implementation of the OutputComparison class.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include "Analysis/OutputComparison.hh"
+#include "Xml/tinyxml.hh"
+
+OutputComparison::EventSummary::EventSummary() :
+    m_nCells(0),
+    m_energy(0.),
+    m_centroidX(0.),
+    m_centroidY(0.),
+    m_centroidZ(0.),
+    m_hasAxis(false)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+OutputComparison::OutputComparison(const unsigned int nProfileBins, const double profileBinWidth) :
+    m_nProfileBins(nProfileBins),
+    m_profileBinWidth(profileBinWidth)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+OutputComparison::EventSummary OutputComparison::Summarise(const TiXmlElement *pEventTiXmlElement) const
+{
+    EventSummary eventSummary;
+    eventSummary.m_longitudinal.assign(m_nProfileBins, 0.);
+    eventSummary.m_transverse.assign(m_nProfileBins, 0.);
+
+    // The shower axis is the direction of the primary with the highest energy, from its start point, as in the ShowerProfileReducer
+    double leadingEnergy(0.), startX(0.), startY(0.), startZ(0.), axisX(0.), axisY(0.), axisZ(0.);
+
+    for (const TiXmlElement *pTiXmlElement = pEventTiXmlElement->FirstChildElement("MCParticle"); pTiXmlElement != nullptr;
+        pTiXmlElement = pTiXmlElement->NextSiblingElement("MCParticle"))
+    {
+        int parentId(-1);
+        double energy(0.), momentumX(0.), momentumY(0.), momentumZ(0.);
+        pTiXmlElement->QueryIntAttribute("ParentId", &parentId);
+        pTiXmlElement->QueryDoubleAttribute("Energy", &energy);
+        pTiXmlElement->QueryDoubleAttribute("MomentumX", &momentumX);
+        pTiXmlElement->QueryDoubleAttribute("MomentumY", &momentumY);
+        pTiXmlElement->QueryDoubleAttribute("MomentumZ", &momentumZ);
+
+        const double momentum(std::sqrt(momentumX * momentumX + momentumY * momentumY + momentumZ * momentumZ));
+
+        if (parentId != 0 || momentum <= 0. || (eventSummary.m_hasAxis && energy <= leadingEnergy))
+            continue;
+
+        eventSummary.m_hasAxis = true;
+        leadingEnergy = energy;
+        pTiXmlElement->QueryDoubleAttribute("StartX", &startX);
+        pTiXmlElement->QueryDoubleAttribute("StartY", &startY);
+        pTiXmlElement->QueryDoubleAttribute("StartZ", &startZ);
+        axisX = momentumX / momentum;
+        axisY = momentumY / momentum;
+        axisZ = momentumZ / momentum;
+    }
+
+    for (const TiXmlElement *pCellTiXmlElement = pEventTiXmlElement->FirstChildElement("Cell"); pCellTiXmlElement != nullptr;
+        pCellTiXmlElement = pCellTiXmlElement->NextSiblingElement("Cell"))
+    {
+        double x(0.), y(0.), z(0.), energy(0.);
+        pCellTiXmlElement->QueryDoubleAttribute("X", &x);
+        pCellTiXmlElement->QueryDoubleAttribute("Y", &y);
+        pCellTiXmlElement->QueryDoubleAttribute("Z", &z);
+        pCellTiXmlElement->QueryDoubleAttribute("Energy", &energy);
+
+        eventSummary.m_nCells++;
+        eventSummary.m_energy += energy;
+        eventSummary.m_centroidX += energy * x;
+        eventSummary.m_centroidY += energy * y;
+        eventSummary.m_centroidZ += energy * z;
+
+        if (!eventSummary.m_hasAxis)
+            continue;
+
+        const double dX(x - startX), dY(y - startY), dZ(z - startZ);
+        const double longitudinal(dX * axisX + dY * axisY + dZ * axisZ);
+        const double transverse(std::sqrt(std::max(0., dX * dX + dY * dY + dZ * dZ - longitudinal * longitudinal)));
+
+        // ATTN : Energy deposited behind the start point or beyond the last bin is not in the profiles
+        const int longitudinalBin(std::floor(longitudinal / m_profileBinWidth)), transverseBin(std::floor(transverse / m_profileBinWidth));
+
+        if (longitudinalBin >= 0 && longitudinalBin < static_cast<int>(m_nProfileBins))
+            eventSummary.m_longitudinal.at(longitudinalBin) += energy;
+
+        if (transverseBin < static_cast<int>(m_nProfileBins))
+            eventSummary.m_transverse.at(transverseBin) += energy;
+    }
+
+    if (eventSummary.m_energy > 0.)
+    {
+        eventSummary.m_centroidX /= eventSummary.m_energy;
+        eventSummary.m_centroidY /= eventSummary.m_energy;
+        eventSummary.m_centroidZ /= eventSummary.m_energy;
+    }
+
+    return eventSummary;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool OutputComparison::ReadOutput(const std::string &fileName, EventSummaryMap &eventSummaries) const
+{
+    TiXmlDocument tiXmlDocument(fileName);
+
+    if (!tiXmlDocument.LoadFile() || !tiXmlDocument.RootElement())
+    {
+        std::cout << "Unable to read output " << fileName << std::endl;
+        return false;
+    }
+
+    for (const TiXmlElement *pEventTiXmlElement = tiXmlDocument.RootElement()->FirstChildElement("Event"); pEventTiXmlElement != nullptr;
+        pEventTiXmlElement = pEventTiXmlElement->NextSiblingElement("Event"))
+    {
+        int eventNumber(0);
+
+        // ATTN : Aborted events hold whatever was simulated before the abort, so are not compared
+        if (pEventTiXmlElement->QueryIntAttribute("Number", &eventNumber) != TIXML_SUCCESS || pEventTiXmlElement->Attribute("Aborted"))
+            continue;
+
+        eventSummaries[eventNumber] = this->Summarise(pEventTiXmlElement);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void OutputComparison::Compare(const EventSummaryMap &testSummaries, const EventSummaryMap &referenceSummaries, const std::string &testName,
+    const std::string &referenceName) const
+{
+    unsigned int nMatched(0), nProfiles(0);
+    double sumEnergyDifference(0.), sumEnergyDifference2(0.), sumCellRatio(0.), sumCellRatio2(0.), sumDistance(0.), sumDistance2(0.);
+    DoubleVector testLongitudinal(m_nProfileBins, 0.), referenceLongitudinal(m_nProfileBins, 0.);
+    DoubleVector testTransverse(m_nProfileBins, 0.), referenceTransverse(m_nProfileBins, 0.);
+
+    for (const auto &iter : testSummaries)
+    {
+        EventSummaryMap::const_iterator referenceIter(referenceSummaries.find(iter.first));
+
+        if (referenceIter == referenceSummaries.end() || referenceIter->second.m_energy <= 0. || referenceIter->second.m_nCells == 0)
+            continue;
+
+        const EventSummary &test(iter.second), &reference(referenceIter->second);
+        const double energyDifference((test.m_energy - reference.m_energy) / reference.m_energy);
+        const double cellRatio(static_cast<double>(test.m_nCells) / reference.m_nCells);
+        const double dX(test.m_centroidX - reference.m_centroidX), dY(test.m_centroidY - reference.m_centroidY), dZ(test.m_centroidZ - reference.m_centroidZ);
+        const double distance(std::sqrt(dX * dX + dY * dY + dZ * dZ));
+
+        nMatched++;
+        sumEnergyDifference += energyDifference;
+        sumEnergyDifference2 += energyDifference * energyDifference;
+        sumCellRatio += cellRatio;
+        sumCellRatio2 += cellRatio * cellRatio;
+        sumDistance += distance;
+        sumDistance2 += distance * distance;
+
+        if (!test.m_hasAxis || !reference.m_hasAxis)
+            continue;
+
+        nProfiles++;
+
+        for (unsigned int bin = 0; bin < m_nProfileBins; bin++)
+        {
+            testLongitudinal.at(bin) += test.m_longitudinal.at(bin);
+            referenceLongitudinal.at(bin) += reference.m_longitudinal.at(bin);
+            testTransverse.at(bin) += test.m_transverse.at(bin);
+            referenceTransverse.at(bin) += reference.m_transverse.at(bin);
+        }
+    }
+
+    if (nMatched == 0)
+    {
+        std::cout << "No events in common with " << referenceName << std::endl;
+        return;
+    }
+
+    const auto rms([nMatched](const double sum, const double sum2){ return std::sqrt(std::max(0., sum2 / nMatched - (sum / nMatched) * (sum / nMatched))); });
+    const std::string ratio("(" + testName + " - " + referenceName + ") / " + referenceName);
+
+    std::cout << "Compared " << nMatched << " events of " << testName << " with " << referenceName << std::endl
+              << "  " << ratio << " energy : mean " << sumEnergyDifference / nMatched << ", rms " << rms(sumEnergyDifference, sumEnergyDifference2) << std::endl
+              << "  " << testName << " / " << referenceName << " number of cells : mean " << sumCellRatio / nMatched << ", rms " << rms(sumCellRatio, sumCellRatio2) << std::endl
+              << "  Energy centroid distance : mean " << sumDistance / nMatched << " mm, rms " << rms(sumDistance, sumDistance2) << " mm" << std::endl;
+
+    if (nProfiles == 0)
+    {
+        std::cout << "  No events with a primary particle in both outputs, so no shower profiles" << std::endl;
+        return;
+    }
+
+    std::cout << "  Shower profiles over " << nProfiles << " events, largest difference of the normalised cumulative profiles : longitudinal "
+              << GetMaxCumulativeDifference(testLongitudinal, referenceLongitudinal) << ", transverse "
+              << GetMaxCumulativeDifference(testTransverse, referenceTransverse) << std::endl
+              << "  Mean energy per event (MeV) by distance (mm) along and from the shower axis" << std::endl
+              << "    " << std::setw(10) << "Low" << std::setw(10) << "High" << std::setw(16) << "Long " + testName << std::setw(16) << "Long " + referenceName
+              << std::setw(16) << "Trans " + testName << std::setw(16) << "Trans " + referenceName << std::endl;
+
+    for (unsigned int bin = 0; bin < m_nProfileBins; bin++)
+    {
+        std::cout << "    " << std::setw(10) << bin * m_profileBinWidth << std::setw(10) << (bin + 1) * m_profileBinWidth
+                  << std::setw(16) << testLongitudinal.at(bin) / nProfiles << std::setw(16) << referenceLongitudinal.at(bin) / nProfiles
+                  << std::setw(16) << testTransverse.at(bin) / nProfiles << std::setw(16) << referenceTransverse.at(bin) / nProfiles << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double OutputComparison::GetMaxCumulativeDifference(const DoubleVector &testProfile, const DoubleVector &referenceProfile)
+{
+    double testTotal(0.), referenceTotal(0.);
+
+    for (unsigned int bin = 0; bin < testProfile.size(); bin++)
+    {
+        testTotal += testProfile.at(bin);
+        referenceTotal += referenceProfile.at(bin);
+    }
+
+    if (testTotal <= 0. || referenceTotal <= 0.)
+        return 0.;
+
+    double testCumulative(0.), referenceCumulative(0.), maxDifference(0.);
+
+    for (unsigned int bin = 0; bin < testProfile.size(); bin++)
+    {
+        testCumulative += testProfile.at(bin) / testTotal;
+        referenceCumulative += referenceProfile.at(bin) / referenceTotal;
+        maxDifference = std::max(maxDifference, std::fabs(testCumulative - referenceCumulative));
+    }
+
+    return maxDifference;
+}
@@ -0,0 +1,103 @@
+/**
+ *  @file   src/Analysis/ShowerProfileReducer.cc
+ *
+ *  @brief  Implementation of the ShowerProfileReducer class.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+
+#include "Analysis/ShowerProfileReducer.hh"
+
+ShowerProfileReducer::ShowerProfileReducer(const std::string &fileName, const int nBins, const double binWidth) :
+    m_fileName(fileName),
+    m_binWidth(binWidth),
+    m_longitudinal(nBins, 0.),
+    m_transverse(nBins, 0.),
+    m_nEvents(0),
+    m_nSkippedEvents(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ShowerProfileReducer::BeginOfRun(const std::string &runLabel)
+{
+    m_runFileName = EventReducer::GetRunFileName(m_fileName, runLabel);
+    std::fill(m_longitudinal.begin(), m_longitudinal.end(), 0.);
+    std::fill(m_transverse.begin(), m_transverse.end(), 0.);
+    m_nEvents = 0;
+    m_nSkippedEvents = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ShowerProfileReducer::ProcessEvent(const int /*eventNumber*/, const CellList &cellList, const MCParticleList &mcParticleList)
+{
+    const MCParticle *pLeadingPrimary(EventReducer::GetLeadingPrimary(mcParticleList));
+    const G4ThreeVector momentum(pLeadingPrimary ? G4ThreeVector(pLeadingPrimary->GetMomentumX(), pLeadingPrimary->GetMomentumY(),
+        pLeadingPrimary->GetMomentumZ()) : G4ThreeVector());
+
+    if (momentum.mag2() <= 0.)
+    {
+        m_nSkippedEvents++;
+        return;
+    }
+
+    const G4ThreeVector start(pLeadingPrimary->GetPositionX(), pLeadingPrimary->GetPositionY(), pLeadingPrimary->GetPositionZ());
+    const G4ThreeVector axis(momentum.unit());
+    const int nBins(m_longitudinal.size());
+
+    for (const auto &iter : cellList.m_idCellMap)
+    {
+        const Cell *pCell(iter.second);
+        const G4ThreeVector displacement(G4ThreeVector(pCell->GetX(), pCell->GetY(), pCell->GetZ()) - start);
+        const double longitudinal(displacement.dot(axis));
+        const double transverse((displacement - longitudinal * axis).mag());
+        const double energy(pCell->GetEnergy() / CLHEP::GeV);
+
+        // ATTN : Energy deposited behind the start point or beyond the last bin is not in the profiles
+        const int longitudinalBin(std::floor(longitudinal / m_binWidth)), transverseBin(std::floor(transverse / m_binWidth));
+
+        if (longitudinalBin >= 0 && longitudinalBin < nBins)
+            m_longitudinal.at(longitudinalBin) += energy;
+
+        if (transverseBin < nBins)
+            m_transverse.at(transverseBin) += energy;
+    }
+
+    m_nEvents++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ShowerProfileReducer::EndOfRun()
+{
+    std::ofstream file(m_runFileName, std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        std::cout << "Unable to open shower profile " << m_runFileName << std::endl;
+        return;
+    }
+
+    if (m_nSkippedEvents > 0)
+        std::cout << "Shower profile skipped " << m_nSkippedEvents << " events without a primary particle" << std::endl;
+
+    file << "Profile,BinLow,BinHigh,MeanEnergy" << std::endl;
+
+    const double norm(m_nEvents > 0 ? 1. / m_nEvents : 0.);
+
+    for (unsigned int bin = 0; bin < m_longitudinal.size(); bin++)
+        file << "Longitudinal," << bin * m_binWidth << "," << (bin + 1) * m_binWidth << "," << m_longitudinal.at(bin) * norm << "\n";
+
+    for (unsigned int bin = 0; bin < m_transverse.size(); bin++)
+        file << "Transverse," << bin * m_binWidth << "," << (bin + 1) * m_binWidth << "," << m_transverse.at(bin) * norm << "\n";
+}
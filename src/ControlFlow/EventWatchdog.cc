@@ -0,0 +1,59 @@
+/**
+ *  @file   src/ControlFlow/EventWatchdog.cc
+ *
+ *  @brief  Implementation of the EventWatchdog class.
+ *
+ *  $Log: $
+ */
+
+#include "ControlFlow/EventWatchdog.hh"
+
+EventWatchdog::EventWatchdog(const double maxWallTime, const double maxCPUTime, const unsigned int checkInterval) :
+    m_maxWallTime(maxWallTime),
+    m_maxCPUTime(maxCPUTime),
+    m_checkInterval(checkInterval),
+    m_nChecks(0),
+    m_expired(false),
+    m_wallStart(Clock::now()),
+    m_cpuStart(std::clock())
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void EventWatchdog::Start()
+{
+    m_nChecks = 0;
+    m_expired = false;
+    m_wallStart = Clock::now();
+    m_cpuStart = std::clock();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+bool EventWatchdog::Check()
+{
+    if (m_expired || ++m_nChecks < m_checkInterval)
+        return false;
+
+    m_nChecks = 0;
+
+    if ((m_maxWallTime > 0. && this->GetWallTime() > m_maxWallTime) || (m_maxCPUTime > 0. && this->GetCPUTime() > m_maxCPUTime))
+        m_expired = true;
+
+    return m_expired;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+double EventWatchdog::GetWallTime() const
+{
+    return std::chrono::duration<double>(Clock::now() - m_wallStart).count();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+double EventWatchdog::GetCPUTime() const
+{
+    return static_cast<double>(std::clock() - m_cpuStart) / CLOCKS_PER_SEC;
+}
@@ -6,20 +6,102 @@
  *  $Log: $
  */
 #include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <limits>
+#include <sstream>
 
 #include "G4SystemOfUnits.hh"
 
 #include "Xml/tinyxml.hh"
+#include "Analysis/EventReducerFactory.hh"
 #include "ControlFlow/InputParameters.hh"
+#include "ControlFlow/Logger.hh"
+#include "Readout/VoxelGrid.hh"
+
+RegionParameters::RegionParameters() :
+    m_gammaCut(-1.),
+    m_electronCut(-1.),
+    m_positronCut(-1.),
+    m_maxStep(0.001*mm),
+    m_minKineticEnergy(0.)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
 
 InputParameters::InputParameters() :
     m_useParticleGun(false),
     m_energy(-1.),
     m_nParticlesPerEvent(1),
     m_useGenieInput(false),
+    m_useGenieFilter(false),
+    m_genieFilterMinVertexX(std::numeric_limits<double>::lowest()),
+    m_genieFilterMaxVertexX(std::numeric_limits<double>::max()),
+    m_genieFilterMinVertexY(std::numeric_limits<double>::lowest()),
+    m_genieFilterMaxVertexY(std::numeric_limits<double>::max()),
+    m_genieFilterMinVertexZ(std::numeric_limits<double>::lowest()),
+    m_genieFilterMaxVertexZ(std::numeric_limits<double>::max()),
+    m_genieFilterMinVisibleEnergy(0.),
     m_keepEMShowerDaughters(false),
     m_energyCut(0.001f),
+    m_useBatchedDeposits(false),
+    m_useDepositArchive(false),
+    m_depositArchiveCompressionLevel(1),
+    m_physicsListName("QGSP_BERT"),
+    m_defaultProductionCut(0.7*mm),
+    m_useEMShowerParameterisation(false),
+    m_emShowerMinEnergy(100.*MeV),
+    m_emShowerSpotEnergy(0.5*MeV),
+    m_emShowerRadiationLength(140.*mm),
+    m_emShowerMoliereRadius(90.4*mm),
+    m_emShowerCriticalEnergy(32.84*MeV),
+    m_emShowerEffectiveZ(18.),
+    m_useShowerLibrary(false),
+    m_showerLibraryMinEnergy(1.*MeV),
+    m_showerLibraryMaxEnergy(100.*MeV),
+    m_showerLibraryNEnergyBins(20),
+    m_showerLibraryNShowersPerBin(10),
+    m_showerLibrarySpotSize(1.*mm),
+    m_showerLibraryPDGCodes({-11, 11, 22}),
+    m_useStackingAction(false),
+    m_neutronTimeWindow(-1.),
+    m_killNeutrinos(true),
+    m_maxEventWallTime(-1.),
+    m_maxEventCPUTime(-1.),
+    m_eventTimeBudgetCheckInterval(1000),
+    m_useEventCostReport(false),
+    m_useStepProfiler(false),
+    m_stepProfilerNRows(20),
+    m_randomSeed(-1),
+    m_useVisualization(false),
+    m_usePhysicsTableCache(false),
+    m_physicsTableCacheDirectory("PhysicsTables"),
+    m_logLevel("info"),
+    m_progressInterval(10.),
+    m_streamOutput(false),
+    m_useCheckpoint(false),
+    m_checkpointFileName("Checkpoint.txt"),
+    m_checkpointInterval(100),
+    m_useRandomSnapshots(false),
+    m_randomSnapshotFileName("RandomSnapshots.bin"),
+    m_useReplay(false),
+    m_replaySnapshotFileName("RandomSnapshots.bin"),
+    m_replayDetailedTrajectories(false),
+    m_writeEventOutput(true),
+    m_useSharedMemoryOutput(false),
+    m_sharedMemoryName("/g4tpc"),
+    m_sharedMemoryCapacity(64),
+    m_sharedMemoryTimeout(60.),
+    m_sharedMemoryDropOnTimeout(false),
+    m_useOverlay(false),
+    m_overlayLibraryFileName(""),
+    m_overlayNEvents(1),
+    m_overlayTimeWindow(0.),
+    m_overlayDriftVelocity(1.6*mm/microsecond),
+    m_overlayMaxShiftY(0.),
+    m_overlayMaxShiftZ(0.),
     m_xCenter(0*mm),
     m_yCenter(0*mm),
     m_zCenter(0*mm),
@@ -27,16 +109,33 @@ InputParameters::InputParameters() :
     m_yWidth(1000*mm),
     m_zWidth(1000*mm),
     m_nLayers(1000),
+    m_nBinsX(0),
+    m_nBinsY(0),
+    m_nBinsZ(0),
+    m_useMortonCellIndex(false),
     m_maxNEventsToProcess(std::numeric_limits<int>::max())
 {
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-InputParameters::InputParameters(const std::string &inputXmlFileName)
+InputParameters::InputParameters(const std::string &inputXmlFileName, const bool readoutOnly) :
+    InputParameters()
 {
     this->LoadViaXml(inputXmlFileName);
 
+    // ATTN : The log level is applied before the genie events are loaded, so their parsing messages are filtered too
+    Logger::Severity logLevel(Logger::INFO);
+
+    if (Logger::GetSeverity(m_logLevel, logLevel))
+        Logger::SetLevel(logLevel);
+
+    // Offline tools that only bin deposits need neither the particle gun configurations nor the genie events
+    if (readoutOnly)
+        return;
+
+    this->SetUpParticleGuns();
+
     if (m_useGenieInput)
         this->LoadGenieEvents();
 }
@@ -57,157 +156,960 @@ bool InputParameters::Valid() const
         return false;
     }
 
-    if (m_useParticleGun)
-    {
-        if (m_energy < 0.)
-        {
-            std::cout << "Energy not specified" << std::endl;
-            return false;
+    if (m_useParticleGun)
+    {
+        if (m_particleGuns.empty())
+        {
+            std::cout << "Particle gun not specified" << std::endl;
+            return false;
+        }
+
+        for (const ParticleGunParameters &particleGun : m_particleGuns)
+        {
+            if (particleGun.m_energy < 0.)
+            {
+                std::cout << "Energy not specified" << std::endl;
+                return false;
+            }
+
+            if (particleGun.m_species.empty())
+            {
+                std::cout << "Particle species not specified" << std::endl;
+                return false;
+            }
+
+            if (m_maxNEventsToProcess <= 0 || particleGun.m_nParticlesPerEvent <= 0)
+            {
+                std::cout << "Must specify positive number of events and particles per event to simulate" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    if (m_useGenieInput)
+    {
+        if (m_genieTrackerFile.empty())
+        {
+            std::cout << "Genie tracker file not specified" << std::endl;
+            return false;
+        }
+    }
+
+    if (m_useGenieFilter)
+    {
+        if (!m_useGenieInput)
+        {
+            std::cout << "Genie filter requires genie input" << std::endl;
+            return false;
+        }
+
+        if (m_genieFilterMinVertexX > m_genieFilterMaxVertexX || m_genieFilterMinVertexY > m_genieFilterMaxVertexY ||
+            m_genieFilterMinVertexZ > m_genieFilterMaxVertexZ)
+        {
+            std::cout << "Genie filter vertex minimum exceeds its maximum" << std::endl;
+            return false;
+        }
+    }
+
+    if (m_useCheckpoint)
+    {
+        // ATTN : A checkpoint records one output file and one run, and the deposit archive is not resumable
+        if (!m_streamOutput || m_useDepositArchive || m_particleGuns.size() > 1)
+        {
+            std::cout << "Checkpoints require streamed output, a single particle gun configuration and no deposit archive" << std::endl;
+            return false;
+        }
+
+        if (!m_writeEventOutput)
+        {
+            std::cout << "Checkpoints require the event output" << std::endl;
+            return false;
+        }
+
+        // ATTN : The reducers, cost report and step profiler rewrite their files each run, and the ring consumer sees only the events
+        //        simulated since the resume, so a resumed job would silently leave out every event before its checkpoint
+        if (!m_eventReducers.empty() || m_useEventCostReport || m_useStepProfiler || m_useSharedMemoryOutput)
+        {
+            std::cout << "Checkpoints cannot be used with event reducers, the event cost report, the step profiler or shared memory output" << std::endl;
+            return false;
+        }
+
+        if (m_checkpointFileName.empty() || m_checkpointInterval <= 0)
+        {
+            std::cout << "Checkpoints require a file name and a positive interval" << std::endl;
+            return false;
+        }
+    }
+
+    if (m_useRandomSnapshots || m_useReplay)
+    {
+        // ATTN : Snapshots are found by event number, which restarts with each run and is not continued by a resumed job
+        if (m_useCheckpoint || m_particleGuns.size() > 1)
+        {
+            std::cout << "Random snapshots and replay require a single particle gun configuration and no checkpoint" << std::endl;
+            return false;
+        }
+    }
+
+    if (m_useRandomSnapshots && m_randomSnapshotFileName.empty())
+    {
+        std::cout << "Random snapshot file name not specified" << std::endl;
+        return false;
+    }
+
+    if (m_useReplay)
+    {
+        if (m_replaySnapshotFileName.empty() || m_replayEvents.empty())
+        {
+            std::cout << "Replay requires a random snapshot file and the events to replay" << std::endl;
+            return false;
+        }
+
+        if (m_useRandomSnapshots && m_randomSnapshotFileName == m_replaySnapshotFileName)
+        {
+            std::cout << "Replay would overwrite the random snapshot file it reads : " << m_replaySnapshotFileName << std::endl;
+            return false;
+        }
+
+        for (const int eventNumber : m_replayEvents)
+        {
+            if (eventNumber < 0 || (m_useGenieInput && eventNumber >= static_cast<int>(m_genieEvents.size())))
+            {
+                std::cout << "Replay event out of range : " << eventNumber << std::endl;
+                return false;
+            }
+        }
+    }
+
+    if (m_useSharedMemoryOutput)
+    {
+#ifndef G4TPC_SHARED_MEMORY_RING
+        std::cout << "Shared memory output is only available on linux" << std::endl;
+        return false;
+#endif
+
+        if (m_sharedMemoryName.size() < 2 || m_sharedMemoryName.at(0) != '/' || m_sharedMemoryName.find('/', 1) != std::string::npos)
+        {
+            std::cout << "Shared memory name must be a single / followed by a name : " << m_sharedMemoryName << std::endl;
+            return false;
+        }
+
+        // ATTN : Record sizes are 32 bit, so the ring is limited to below 4 GB
+        if (m_sharedMemoryCapacity <= 0 || m_sharedMemoryCapacity >= 4096)
+        {
+            std::cout << "Shared memory capacity must be between 1 and 4095 MB : " << m_sharedMemoryCapacity << std::endl;
+            return false;
+        }
+
+        // ATTN : The ring waits in whole milliseconds held in an int
+        if (m_sharedMemoryTimeout * 1000. >= std::numeric_limits<int>::max())
+        {
+            std::cout << "Shared memory timeout is too long : " << m_sharedMemoryTimeout << std::endl;
+            return false;
+        }
+    }
+
+    if (m_useOverlay)
+    {
+        if (m_overlayLibraryFileName.empty() || m_overlayNEvents <= 0)
+        {
+            std::cout << "Overlay requires a library file and a positive number of events to overlay" << std::endl;
+            return false;
+        }
+
+        if (m_overlayTimeWindow < 0. || m_overlayDriftVelocity <= 0. || m_overlayMaxShiftY < 0. || m_overlayMaxShiftZ < 0.)
+        {
+            std::cout << "Overlay time window and shifts must not be negative, and the drift velocity must be positive" << std::endl;
+            return false;
+        }
+    }
+
+    Logger::Severity logLevel(Logger::INFO);
+
+    if (!Logger::GetSeverity(m_logLevel, logLevel))
+    {
+        std::cout << "Unknown log level : " << m_logLevel << std::endl;
+        return false;
+    }
+
+    if (m_useDepositArchive)
+    {
+        if (m_depositArchiveFileName.empty())
+        {
+            std::cout << "Deposit archive file not specified" << std::endl;
+            return false;
+        }
+
+        if (m_depositArchiveCompressionLevel < 1 || m_depositArchiveCompressionLevel > 9)
+        {
+            std::cout << "Deposit archive compression level must be between 1 and 9" << std::endl;
+            return false;
+        }
+    }
+
+    if (m_energyCut < 0.)
+    {
+        std::cout << "Invalid energy cut specified" << std::endl;
+        return false;
+    }
+
+    if (m_physicsListName.empty())
+    {
+        std::cout << "Physics list name not specified" << std::endl;
+        return false;
+    }
+
+    if (m_defaultProductionCut <= 0.)
+    {
+        std::cout << "Default production cut must be positive" << std::endl;
+        return false;
+    }
+
+    if (!InputParameters::ValidRegion("World", m_worldRegion) || !InputParameters::ValidRegion("Absorber", m_absorberRegion))
+        return false;
+
+    if (m_useEMShowerParameterisation)
+    {
+        if (m_emShowerMinEnergy <= m_emShowerCriticalEnergy)
+        {
+            std::cout << "Electromagnetic shower parameterisation requires a minimum energy above the critical energy" << std::endl;
+            return false;
+        }
+
+        if (m_emShowerSpotEnergy <= 0. || m_emShowerRadiationLength <= 0. || m_emShowerMoliereRadius <= 0. || m_emShowerCriticalEnergy <= 0. ||
+            m_emShowerEffectiveZ <= 0.)
+        {
+            std::cout << "Electromagnetic shower parameterisation requires positive spot energy and material properties" << std::endl;
+            return false;
+        }
+    }
+
+    // ATTN : The library builder runs with the library switched off, so checks its parameters itself
+    if (m_useShowerLibrary && !this->ValidShowerLibrary())
+        return false;
+
+    for (const KillThresholdParameters &killThreshold : m_killThresholds)
+    {
+        if (killThreshold.m_species.empty())
+        {
+            std::cout << "Kill threshold particle species not specified" << std::endl;
+            return false;
+        }
+
+        if (killThreshold.m_energy < 0.)
+        {
+            std::cout << "Kill threshold for " << killThreshold.m_species << " must not be negative" << std::endl;
+            return false;
+        }
+    }
+
+    if (m_eventTimeBudgetCheckInterval <= 0)
+    {
+        std::cout << "Event time budget check interval must be positive" << std::endl;
+        return false;
+    }
+
+    if (m_useEventCostReport && m_eventCostReportFileName.empty())
+    {
+        std::cout << "Event cost report file not specified" << std::endl;
+        return false;
+    }
+
+    if (m_stepProfilerNRows < 0)
+    {
+        std::cout << "Number of step profile rows to print must not be negative" << std::endl;
+        return false;
+    }
+
+    if (!this->ValidReadout())
+        return false;
+
+    for (const EventReducerParameters &eventReducer : m_eventReducers)
+    {
+        if (!EventReducerFactory::IsRegistered(eventReducer.m_type))
+        {
+            std::cout << "Unknown event reducer : " << eventReducer.m_type << std::endl;
+            return false;
+        }
+
+        if (eventReducer.m_fileName.empty())
+        {
+            std::cout << "Event reducer " << eventReducer.m_type << " requires a file name" << std::endl;
+            return false;
+        }
+
+        if (eventReducer.m_nBins <= 0 || eventReducer.m_binWidth <= 0.)
+        {
+            std::cout << "Event reducer " << eventReducer.m_type << " requires a positive number of bins and bin width" << std::endl;
+            return false;
+        }
+    }
+
+    for (const ReadoutGridParameters &readoutGrid : m_readoutGrids)
+    {
+        if (readoutGrid.m_name.empty())
+        {
+            std::cout << "Readout grid name not specified" << std::endl;
+            return false;
+        }
+
+        if (std::count_if(m_readoutGrids.begin(), m_readoutGrids.end(), [&readoutGrid](const ReadoutGridParameters &other){ return other.m_name == readoutGrid.m_name;}) > 1)
+        {
+            std::cout << "Readout grid names must be unique : " << readoutGrid.m_name << std::endl;
+            return false;
+        }
+
+        if (readoutGrid.m_cellSize <= 0.)
+        {
+            std::cout << "Readout grid " << readoutGrid.m_name << " requires a positive cell size" << std::endl;
+            return false;
+        }
+
+        const double nBinsX(std::ceil(m_xWidth / readoutGrid.m_cellSize)), nBinsY(std::ceil(m_yWidth / readoutGrid.m_cellSize)), nBinsZ(std::ceil(m_zWidth / readoutGrid.m_cellSize));
+
+        if (std::max(nBinsX, std::max(nBinsY, nBinsZ)) > std::numeric_limits<unsigned int>::max() ||
+            !VoxelGrid::IsRepresentable(nBinsX, nBinsY, nBinsZ, m_useMortonCellIndex ? VoxelGrid::MORTON : VoxelGrid::LINEAR))
+        {
+            std::cout << "Readout grid " << readoutGrid.m_name << " has too many cells to fit in a 64 bit cell index" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+bool InputParameters::ValidReadout() const
+{
+    if (m_outputFileName.empty())
+    {
+        std::cout << "Missing output file name" << std::endl;
+        return false;
+    }
+
+    if (m_xWidth < 0.f || m_yWidth < 0.f || m_zWidth < 0.f)
+    {
+        std::cout << "Detector must not have negative width" << std::endl;
+        return false;
+    }
+
+    if (m_nLayers <= 0)
+    {
+        std::cout << "3D energy binning requires positive number of layers" << std::endl;
+        return false;
+    }
+
+    if (m_nBinsX < 0 || m_nBinsY < 0 || m_nBinsZ < 0)
+    {
+        std::cout << "3D energy binning requires positive number of bins along each axis" << std::endl;
+        return false;
+    }
+
+    if (!VoxelGrid::IsRepresentable(this->GetNBinsX(), this->GetNBinsY(), this->GetNBinsZ(), m_useMortonCellIndex ? VoxelGrid::MORTON : VoxelGrid::LINEAR))
+    {
+        std::cout << "Number of bins along each axis too large to fit in a 64 bit cell index" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+bool InputParameters::ValidShowerLibrary() const
+{
+    if (m_showerLibraryFileName.empty())
+    {
+        std::cout << "Shower library file not specified" << std::endl;
+        return false;
+    }
+
+    if (m_showerLibraryMinEnergy <= 0. || m_showerLibraryMaxEnergy <= m_showerLibraryMinEnergy || m_showerLibraryNEnergyBins <= 0 ||
+        m_showerLibraryNShowersPerBin <= 0 || m_showerLibrarySpotSize <= 0.)
+    {
+        std::cout << "Shower library requires a positive energy range, number of energy bins, number of showers per bin and spot size" << std::endl;
+        return false;
+    }
+
+    if (m_showerLibraryPDGCodes.empty())
+    {
+        std::cout << "Shower library requires at least one pdg code" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void InputParameters::SelectParticleGun(const unsigned int index)
+{
+    const ParticleGunParameters &particleGun(m_particleGuns.at(index));
+    m_species = particleGun.m_species;
+    m_energy = particleGun.m_energy;
+    m_nParticlesPerEvent = particleGun.m_nParticlesPerEvent;
+    m_outputFileName = particleGun.m_outputFileName;
+    m_runLabel = particleGun.m_runLabel;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void InputParameters::SetUpParticleGuns()
+{
+    if (m_particleGuns.empty())
+        return;
+
+    // ATTN : A single configuration keeps the configured output file name, a scan labels each output file with its configuration
+    const std::size_t extension(m_outputFileName.rfind(".xml"));
+    const std::string stem(m_outputFileName.substr(0, extension));
+    const std::string suffix(extension == std::string::npos ? "" : m_outputFileName.substr(extension));
+
+    for (unsigned int index = 0; index < m_particleGuns.size(); index++)
+    {
+        ParticleGunParameters &particleGun(m_particleGuns.at(index));
+
+        if (m_particleGuns.size() == 1)
+        {
+            particleGun.m_outputFileName = m_outputFileName;
+            continue;
+        }
+
+        std::ostringstream runLabel;
+        runLabel << "_" << index << "_" << particleGun.m_species << "_" << particleGun.m_energy << "GeV";
+        particleGun.m_runLabel = runLabel.str();
+        particleGun.m_outputFileName = stem + particleGun.m_runLabel + suffix;
+    }
+
+    this->SelectParticleGun(0);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+bool InputParameters::ValidRegion(const std::string &name, const RegionParameters &regionParameters)
+{
+    if (regionParameters.m_maxStep <= 0.)
+    {
+        std::cout << "Region " << name << " requires a positive maximum step length" << std::endl;
+        return false;
+    }
+
+    if (regionParameters.m_minKineticEnergy < 0.)
+    {
+        std::cout << "Region " << name << " must not have a negative minimum kinetic energy" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void InputParameters::LoadViaXml(const std::string &inputXmlFileName)
+{
+    TiXmlDocument *pTiXmlDocument = new TiXmlDocument();
+
+    if (!pTiXmlDocument->LoadFile(inputXmlFileName.c_str()))
+    {
+        std::cerr << pTiXmlDocument->ErrorDesc() << std::endl;
+        return;
+    }
+
+    TiXmlElement *pDocumentTiXmlElement = pTiXmlDocument->RootElement();
+
+    for (TiXmlElement *pHeadTiXmlElement = pDocumentTiXmlElement->FirstChildElement(); pHeadTiXmlElement != nullptr; pHeadTiXmlElement = pHeadTiXmlElement->NextSiblingElement())
+    {
+        if (!pHeadTiXmlElement)
+        {
+            std::cout << "Failed to load file: No root element." << std::endl;
+            pTiXmlDocument->Clear();
+        }
+
+        if (pHeadTiXmlElement->ValueStr() == "Output3DXmlFileName")
+        {
+            m_outputFileName = pHeadTiXmlElement->GetText();
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "HitThresholdEnergy")
+        {
+            m_energyCut = std::stod(pHeadTiXmlElement->GetText());
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "KeepMCEmShowerDaughters")
+        {
+            m_keepEMShowerDaughters = InputParameters::ParseBool(pHeadTiXmlElement);
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "BatchedDeposits")
+        {
+            m_useBatchedDeposits = InputParameters::ParseBool(pHeadTiXmlElement);
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "ParticleGun")
+        {
+            ParticleGunParameters particleGun;
+            particleGun.m_energy = -1.;
+            particleGun.m_nParticlesPerEvent = 1;
+            bool useParticleGun(false);
+
+            for (TiXmlElement *pParticleGunTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pParticleGunTiXmlElement != nullptr; pParticleGunTiXmlElement = pParticleGunTiXmlElement->NextSiblingElement())
+            {
+                if (pParticleGunTiXmlElement->ValueStr() == "Use")
+                {
+                    useParticleGun = InputParameters::ParseBool(pParticleGunTiXmlElement);
+                }
+                else if (pParticleGunTiXmlElement->ValueStr() == "Species")
+                {
+                    particleGun.m_species = pParticleGunTiXmlElement->GetText();
+                }
+                else if (pParticleGunTiXmlElement->ValueStr() == "Energy")
+                {
+                    particleGun.m_energy = std::stod(pParticleGunTiXmlElement->GetText());
+                }
+                else if (pParticleGunTiXmlElement->ValueStr() == "ParticlePerEvent")
+                {
+                    particleGun.m_nParticlesPerEvent = std::stoi(pParticleGunTiXmlElement->GetText());
+                }
+            }
+
+            // ATTN : As for scans, a block in use enables the particle gun and a block not in use is ignored, whatever the order of the blocks
+            if (!useParticleGun)
+                continue;
+
+            m_useParticleGun = true;
+            m_particleGuns.push_back(particleGun);
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "ParticleGunScan")
+        {
+            StringVector species;
+            std::vector<double> energies;
+            double minEnergy(0.), maxEnergy(0.);
+            int nEnergies(0), nParticlesPerEvent(1);
+            bool useScan(false);
+
+            for (TiXmlElement *pScanTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pScanTiXmlElement != nullptr; pScanTiXmlElement = pScanTiXmlElement->NextSiblingElement())
+            {
+                if (pScanTiXmlElement->ValueStr() == "Use")
+                {
+                    useScan = InputParameters::ParseBool(pScanTiXmlElement);
+                }
+                else if (pScanTiXmlElement->ValueStr() == "Species")
+                {
+                    species.push_back(pScanTiXmlElement->GetText());
+                }
+                else if (pScanTiXmlElement->ValueStr() == "Energy")
+                {
+                    energies.push_back(std::stod(pScanTiXmlElement->GetText()));
+                }
+                else if (pScanTiXmlElement->ValueStr() == "MinEnergy")
+                {
+                    minEnergy = std::stod(pScanTiXmlElement->GetText());
+                }
+                else if (pScanTiXmlElement->ValueStr() == "MaxEnergy")
+                {
+                    maxEnergy = std::stod(pScanTiXmlElement->GetText());
+                }
+                else if (pScanTiXmlElement->ValueStr() == "NEnergies")
+                {
+                    nEnergies = std::stoi(pScanTiXmlElement->GetText());
+                }
+                else if (pScanTiXmlElement->ValueStr() == "ParticlePerEvent")
+                {
+                    nParticlesPerEvent = std::stoi(pScanTiXmlElement->GetText());
+                }
+            }
+
+            // ATTN : A scan in use enables the particle gun, a scan not in use is ignored
+            if (!useScan)
+                continue;
+
+            m_useParticleGun = true;
+
+            // ATTN : Energy ranges are scanned in equal steps, including both ends, after any explicitly listed energies
+            for (int energyStep = 0; energyStep < nEnergies; energyStep++)
+                energies.push_back(nEnergies > 1 ? minEnergy + (maxEnergy - minEnergy) * energyStep / (nEnergies - 1) : minEnergy);
+
+            for (const std::string &scanSpecies : species)
+            {
+                for (const double energy : energies)
+                {
+                    ParticleGunParameters particleGun;
+                    particleGun.m_species = scanSpecies;
+                    particleGun.m_energy = energy;
+                    particleGun.m_nParticlesPerEvent = nParticlesPerEvent;
+                    m_particleGuns.push_back(particleGun);
+                }
+            }
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "GenieInput")
+        {
+            for (TiXmlElement *pGenieTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pGenieTiXmlElement != nullptr; pGenieTiXmlElement = pGenieTiXmlElement->NextSiblingElement())
+            {
+                if (pGenieTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useGenieInput = InputParameters::ParseBool(pGenieTiXmlElement);
+                }
+                else if (pGenieTiXmlElement->ValueStr() == "TrackerFile")
+                {
+                    m_genieTrackerFile = pGenieTiXmlElement->GetText();
+                }
+            }
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "GenieFilter")
+        {
+            for (TiXmlElement *pFilterTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pFilterTiXmlElement != nullptr; pFilterTiXmlElement = pFilterTiXmlElement->NextSiblingElement())
+            {
+                if (pFilterTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useGenieFilter = InputParameters::ParseBool(pFilterTiXmlElement);
+                }
+                else if (pFilterTiXmlElement->ValueStr() == "MinVertexX")
+                {
+                    m_genieFilterMinVertexX = std::stod(pFilterTiXmlElement->GetText());
+                }
+                else if (pFilterTiXmlElement->ValueStr() == "MaxVertexX")
+                {
+                    m_genieFilterMaxVertexX = std::stod(pFilterTiXmlElement->GetText());
+                }
+                else if (pFilterTiXmlElement->ValueStr() == "MinVertexY")
+                {
+                    m_genieFilterMinVertexY = std::stod(pFilterTiXmlElement->GetText());
+                }
+                else if (pFilterTiXmlElement->ValueStr() == "MaxVertexY")
+                {
+                    m_genieFilterMaxVertexY = std::stod(pFilterTiXmlElement->GetText());
+                }
+                else if (pFilterTiXmlElement->ValueStr() == "MinVertexZ")
+                {
+                    m_genieFilterMinVertexZ = std::stod(pFilterTiXmlElement->GetText());
+                }
+                else if (pFilterTiXmlElement->ValueStr() == "MaxVertexZ")
+                {
+                    m_genieFilterMaxVertexZ = std::stod(pFilterTiXmlElement->GetText());
+                }
+                else if (pFilterTiXmlElement->ValueStr() == "NuanceCodes")
+                {
+                    // Whitespace separated nuance codes of the interactions to keep
+                    std::istringstream nuanceCodes(pFilterTiXmlElement->GetText());
+                    int nuanceCode(0);
+                    m_genieFilterNuanceCodes.clear();
+
+                    while (nuanceCodes >> nuanceCode)
+                        m_genieFilterNuanceCodes.push_back(nuanceCode);
+                }
+                else if (pFilterTiXmlElement->ValueStr() == "MinVisibleEnergy")
+                {
+                    m_genieFilterMinVisibleEnergy = std::stod(pFilterTiXmlElement->GetText());
+                }
+            }
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "DepositArchive")
+        {
+            for (TiXmlElement *pArchiveTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pArchiveTiXmlElement != nullptr; pArchiveTiXmlElement = pArchiveTiXmlElement->NextSiblingElement())
+            {
+                if (pArchiveTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useDepositArchive = InputParameters::ParseBool(pArchiveTiXmlElement);
+                }
+                else if (pArchiveTiXmlElement->ValueStr() == "FileName")
+                {
+                    m_depositArchiveFileName = pArchiveTiXmlElement->GetText();
+                }
+                else if (pArchiveTiXmlElement->ValueStr() == "CompressionLevel")
+                {
+                    m_depositArchiveCompressionLevel = std::stoi(pArchiveTiXmlElement->GetText());
+                }
+            }
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "PhysicsList")
+        {
+            for (TiXmlElement *pPhysicsTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pPhysicsTiXmlElement != nullptr; pPhysicsTiXmlElement = pPhysicsTiXmlElement->NextSiblingElement())
+            {
+                if (pPhysicsTiXmlElement->ValueStr() == "Name")
+                {
+                    m_physicsListName = pPhysicsTiXmlElement->GetText();
+                }
+                else if (pPhysicsTiXmlElement->ValueStr() == "DefaultCut")
+                {
+                    m_defaultProductionCut = std::stod(pPhysicsTiXmlElement->GetText());
+                }
+                else if (pPhysicsTiXmlElement->ValueStr() == "Remove")
+                {
+                    m_physicsToRemove.push_back(pPhysicsTiXmlElement->GetText());
+                }
+            }
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "Regions")
+        {
+            for (TiXmlElement *pRegionTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pRegionTiXmlElement != nullptr; pRegionTiXmlElement = pRegionTiXmlElement->NextSiblingElement())
+            {
+                if (pRegionTiXmlElement->ValueStr() == "World")
+                {
+                    InputParameters::LoadRegionParameters(pRegionTiXmlElement, m_worldRegion);
+                }
+                else if (pRegionTiXmlElement->ValueStr() == "Absorber")
+                {
+                    InputParameters::LoadRegionParameters(pRegionTiXmlElement, m_absorberRegion);
+                }
+            }
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "EMShowerParameterisation")
+        {
+            for (TiXmlElement *pShowerTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pShowerTiXmlElement != nullptr; pShowerTiXmlElement = pShowerTiXmlElement->NextSiblingElement())
+            {
+                if (pShowerTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useEMShowerParameterisation = InputParameters::ParseBool(pShowerTiXmlElement);
+                }
+                else if (pShowerTiXmlElement->ValueStr() == "MinEnergy")
+                {
+                    m_emShowerMinEnergy = std::stod(pShowerTiXmlElement->GetText());
+                }
+                else if (pShowerTiXmlElement->ValueStr() == "SpotEnergy")
+                {
+                    m_emShowerSpotEnergy = std::stod(pShowerTiXmlElement->GetText());
+                }
+                else if (pShowerTiXmlElement->ValueStr() == "RadiationLength")
+                {
+                    m_emShowerRadiationLength = std::stod(pShowerTiXmlElement->GetText());
+                }
+                else if (pShowerTiXmlElement->ValueStr() == "MoliereRadius")
+                {
+                    m_emShowerMoliereRadius = std::stod(pShowerTiXmlElement->GetText());
+                }
+                else if (pShowerTiXmlElement->ValueStr() == "CriticalEnergy")
+                {
+                    m_emShowerCriticalEnergy = std::stod(pShowerTiXmlElement->GetText());
+                }
+                else if (pShowerTiXmlElement->ValueStr() == "EffectiveZ")
+                {
+                    m_emShowerEffectiveZ = std::stod(pShowerTiXmlElement->GetText());
+                }
+            }
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "ShowerLibrary")
+        {
+            for (TiXmlElement *pLibraryTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pLibraryTiXmlElement != nullptr; pLibraryTiXmlElement = pLibraryTiXmlElement->NextSiblingElement())
+            {
+                if (pLibraryTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useShowerLibrary = InputParameters::ParseBool(pLibraryTiXmlElement);
+                }
+                else if (pLibraryTiXmlElement->ValueStr() == "FileName")
+                {
+                    m_showerLibraryFileName = pLibraryTiXmlElement->GetText();
+                }
+                else if (pLibraryTiXmlElement->ValueStr() == "MinEnergy")
+                {
+                    m_showerLibraryMinEnergy = std::stod(pLibraryTiXmlElement->GetText());
+                }
+                else if (pLibraryTiXmlElement->ValueStr() == "MaxEnergy")
+                {
+                    m_showerLibraryMaxEnergy = std::stod(pLibraryTiXmlElement->GetText());
+                }
+                else if (pLibraryTiXmlElement->ValueStr() == "NEnergyBins")
+                {
+                    m_showerLibraryNEnergyBins = std::stoi(pLibraryTiXmlElement->GetText());
+                }
+                else if (pLibraryTiXmlElement->ValueStr() == "NShowersPerBin")
+                {
+                    m_showerLibraryNShowersPerBin = std::stoi(pLibraryTiXmlElement->GetText());
+                }
+                else if (pLibraryTiXmlElement->ValueStr() == "SpotSize")
+                {
+                    m_showerLibrarySpotSize = std::stod(pLibraryTiXmlElement->GetText());
+                }
+                else if (pLibraryTiXmlElement->ValueStr() == "PDGCodes")
+                {
+                    // Whitespace separated pdg codes, replacing the default electrons, positrons and photons
+                    std::istringstream pdgCodes(pLibraryTiXmlElement->GetText());
+                    int pdg(0);
+                    m_showerLibraryPDGCodes.clear();
+
+                    while (pdgCodes >> pdg)
+                        m_showerLibraryPDGCodes.push_back(pdg);
+                }
+            }
         }
+        else if (pHeadTiXmlElement->ValueStr() == "StackingAction")
+        {
+            for (TiXmlElement *pStackingTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pStackingTiXmlElement != nullptr; pStackingTiXmlElement = pStackingTiXmlElement->NextSiblingElement())
+            {
+                if (pStackingTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useStackingAction = InputParameters::ParseBool(pStackingTiXmlElement);
+                }
+                else if (pStackingTiXmlElement->ValueStr() == "KillThreshold")
+                {
+                    KillThresholdParameters killThreshold;
+                    killThreshold.m_energy = 0.;
+
+                    for (TiXmlElement *pThresholdTiXmlElement = pStackingTiXmlElement->FirstChildElement(); pThresholdTiXmlElement != nullptr; pThresholdTiXmlElement = pThresholdTiXmlElement->NextSiblingElement())
+                    {
+                        if (pThresholdTiXmlElement->ValueStr() == "Species")
+                        {
+                            killThreshold.m_species = pThresholdTiXmlElement->GetText();
+                        }
+                        else if (pThresholdTiXmlElement->ValueStr() == "Energy")
+                        {
+                            killThreshold.m_energy = std::stod(pThresholdTiXmlElement->GetText());
+                        }
+                    }
 
-        if (m_species.empty())
+                    m_killThresholds.push_back(killThreshold);
+                }
+                else if (pStackingTiXmlElement->ValueStr() == "NeutronTimeWindow")
+                {
+                    m_neutronTimeWindow = std::stod(pStackingTiXmlElement->GetText());
+                }
+                else if (pStackingTiXmlElement->ValueStr() == "KillNeutrinos")
+                {
+                    m_killNeutrinos = InputParameters::ParseBool(pStackingTiXmlElement);
+                }
+            }
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "EventTimeBudget")
         {
-            std::cout << "Particle species not specified" << std::endl;
-            return false;
+            for (TiXmlElement *pBudgetTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pBudgetTiXmlElement != nullptr; pBudgetTiXmlElement = pBudgetTiXmlElement->NextSiblingElement())
+            {
+                if (pBudgetTiXmlElement->ValueStr() == "MaxWallTime")
+                {
+                    m_maxEventWallTime = std::stod(pBudgetTiXmlElement->GetText());
+                }
+                else if (pBudgetTiXmlElement->ValueStr() == "MaxCPUTime")
+                {
+                    m_maxEventCPUTime = std::stod(pBudgetTiXmlElement->GetText());
+                }
+                else if (pBudgetTiXmlElement->ValueStr() == "CheckInterval")
+                {
+                    m_eventTimeBudgetCheckInterval = std::stoi(pBudgetTiXmlElement->GetText());
+                }
+            }
         }
-
-        if (m_maxNEventsToProcess <= 0 || m_nParticlesPerEvent <= 0)
+        else if (pHeadTiXmlElement->ValueStr() == "EventCostReport")
         {
-            std::cout << "Must specify positive number of events and particles per event to simulate" << std::endl;
-            return false;
+            for (TiXmlElement *pReportTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pReportTiXmlElement != nullptr; pReportTiXmlElement = pReportTiXmlElement->NextSiblingElement())
+            {
+                if (pReportTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useEventCostReport = InputParameters::ParseBool(pReportTiXmlElement);
+                }
+                else if (pReportTiXmlElement->ValueStr() == "FileName")
+                {
+                    m_eventCostReportFileName = pReportTiXmlElement->GetText();
+                }
+            }
         }
-    }
-
-    if (m_useGenieInput)
-    {
-        if (m_genieTrackerFile.empty())
+        else if (pHeadTiXmlElement->ValueStr() == "StepProfiler")
         {
-            std::cout << "Genie tracker file not specified" << std::endl;
-            return false;
+            for (TiXmlElement *pProfilerTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pProfilerTiXmlElement != nullptr; pProfilerTiXmlElement = pProfilerTiXmlElement->NextSiblingElement())
+            {
+                if (pProfilerTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useStepProfiler = InputParameters::ParseBool(pProfilerTiXmlElement);
+                }
+                else if (pProfilerTiXmlElement->ValueStr() == "FileName")
+                {
+                    m_stepProfilerFileName = pProfilerTiXmlElement->GetText();
+                }
+                else if (pProfilerTiXmlElement->ValueStr() == "NRows")
+                {
+                    m_stepProfilerNRows = std::stoi(pProfilerTiXmlElement->GetText());
+                }
+            }
         }
-    }
-
-    if (m_outputFileName.empty())
-    {
-        std::cout << "Missing output file name" << std::endl;
-        return false;
-    }
-
-    if (m_energyCut < 0.)
-    {
-        std::cout << "Invalid energy cut specified" << std::endl;
-        return false;
-    }
-
-    if (m_xWidth < 0.f || m_yWidth < 0.f || m_zWidth < 0.f)
-    {
-        std::cout << "Detector must not have negative width" << std::endl;
-        return false;
-    }
-
-    if (m_nLayers <= 0)
-    {
-        std::cout << "3D energy binning requires positive number of layers" << std::endl;
-        return false;
-    }
-
-    return true;
-}
-
-//------------------------------------------------------------------------------------------------------------------------------------------ 
-
-void InputParameters::LoadViaXml(const std::string &inputXmlFileName)
-{
-    TiXmlDocument *pTiXmlDocument = new TiXmlDocument();
-
-    if (!pTiXmlDocument->LoadFile(inputXmlFileName.c_str()))
-    {
-        std::cerr << pTiXmlDocument->ErrorDesc() << std::endl;
-        return;
-    }
-
-    TiXmlElement *pDocumentTiXmlElement = pTiXmlDocument->RootElement();
-
-    for (TiXmlElement *pHeadTiXmlElement = pDocumentTiXmlElement->FirstChildElement(); pHeadTiXmlElement != nullptr; pHeadTiXmlElement = pHeadTiXmlElement->NextSiblingElement())
-    {
-        if (!pHeadTiXmlElement)
+        else if (pHeadTiXmlElement->ValueStr() == "RandomSeed")
         {
-            std::cout << "Failed to load file: No root element." << std::endl;
-            pTiXmlDocument->Clear();
+            m_randomSeed = std::stol(pHeadTiXmlElement->GetText());
         }
-
-        if (pHeadTiXmlElement->ValueStr() == "Output3DXmlFileName")
+        else if (pHeadTiXmlElement->ValueStr() == "Visualization")
         {
-            m_outputFileName = pHeadTiXmlElement->GetText();
+            m_useVisualization = InputParameters::ParseBool(pHeadTiXmlElement);
         }
-        else if (pHeadTiXmlElement->ValueStr() == "HitThresholdEnergy")
+        else if (pHeadTiXmlElement->ValueStr() == "StreamOutput")
         {
-            m_energyCut = std::stod(pHeadTiXmlElement->GetText());
+            m_streamOutput = InputParameters::ParseBool(pHeadTiXmlElement);
         }
-        else if (pHeadTiXmlElement->ValueStr() == "KeepMCEmShowerDaughters")
+        else if (pHeadTiXmlElement->ValueStr() == "Checkpoint")
         {
-            std::string keepEMShowerDaughtersString(pHeadTiXmlElement->GetText());
-            std::transform(keepEMShowerDaughtersString.begin(), keepEMShowerDaughtersString.end(), keepEMShowerDaughtersString.begin(), [](unsigned char c){ return std::tolower(c);});
-            if ((keepEMShowerDaughtersString == "0") || (keepEMShowerDaughtersString == "false"))
+            for (TiXmlElement *pCheckpointTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pCheckpointTiXmlElement != nullptr; pCheckpointTiXmlElement = pCheckpointTiXmlElement->NextSiblingElement())
             {
-                m_keepEMShowerDaughters = false;
+                if (pCheckpointTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useCheckpoint = InputParameters::ParseBool(pCheckpointTiXmlElement);
+                }
+                else if (pCheckpointTiXmlElement->ValueStr() == "FileName")
+                {
+                    m_checkpointFileName = pCheckpointTiXmlElement->GetText();
+                }
+                else if (pCheckpointTiXmlElement->ValueStr() == "Interval")
+                {
+                    m_checkpointInterval = std::stoi(pCheckpointTiXmlElement->GetText());
+                }
             }
-            else
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "RandomSnapshots")
+        {
+            for (TiXmlElement *pSnapshotTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pSnapshotTiXmlElement != nullptr; pSnapshotTiXmlElement = pSnapshotTiXmlElement->NextSiblingElement())
             {
-                m_keepEMShowerDaughters = true;
+                if (pSnapshotTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useRandomSnapshots = InputParameters::ParseBool(pSnapshotTiXmlElement);
+                }
+                else if (pSnapshotTiXmlElement->ValueStr() == "FileName")
+                {
+                    m_randomSnapshotFileName = pSnapshotTiXmlElement->GetText();
+                }
             }
         }
-        else if (pHeadTiXmlElement->ValueStr() == "ParticleGun")
+        else if (pHeadTiXmlElement->ValueStr() == "Replay")
         {
-            for (TiXmlElement *pParticleGunTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pParticleGunTiXmlElement != nullptr; pParticleGunTiXmlElement = pParticleGunTiXmlElement->NextSiblingElement())
+            for (TiXmlElement *pReplayTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pReplayTiXmlElement != nullptr; pReplayTiXmlElement = pReplayTiXmlElement->NextSiblingElement())
             {
-                if (pParticleGunTiXmlElement->ValueStr() == "Use")
+                if (pReplayTiXmlElement->ValueStr() == "Use")
                 {
-                    std::string useParticleGunString(pParticleGunTiXmlElement->GetText());
-                    std::transform(useParticleGunString.begin(), useParticleGunString.end(), useParticleGunString.begin(), [](unsigned char c){ return std::tolower(c);});
-                    if ((useParticleGunString == "0") || (useParticleGunString == "false"))
-                    {
-                        m_useParticleGun = false;
-                    }
-                    else
-                    {
-                        m_useParticleGun = true;
-                    }
+                    m_useReplay = InputParameters::ParseBool(pReplayTiXmlElement);
                 }
-                else if (pParticleGunTiXmlElement->ValueStr() == "Species")
+                else if (pReplayTiXmlElement->ValueStr() == "SnapshotFileName")
                 {
-                    m_species = pParticleGunTiXmlElement->GetText();
+                    m_replaySnapshotFileName = pReplayTiXmlElement->GetText();
                 }
-                else if (pParticleGunTiXmlElement->ValueStr() == "Energy")
+                else if (pReplayTiXmlElement->ValueStr() == "Events")
                 {
-                    m_energy = std::stod(pParticleGunTiXmlElement->GetText());
+                    // Whitespace separated event numbers
+                    std::istringstream events(pReplayTiXmlElement->GetText());
+                    int eventNumber(0);
+
+                    while (events >> eventNumber)
+                        m_replayEvents.push_back(eventNumber);
                 }
-                else if (pParticleGunTiXmlElement->ValueStr() == "ParticlePerEvent")
+                else if (pReplayTiXmlElement->ValueStr() == "DetailedTrajectories")
                 {
-                    m_nParticlesPerEvent = std::stoi(pParticleGunTiXmlElement->GetText());
+                    m_replayDetailedTrajectories = InputParameters::ParseBool(pReplayTiXmlElement);
                 }
             }
         }
-        else if (pHeadTiXmlElement->ValueStr() == "GenieInput")
+        else if (pHeadTiXmlElement->ValueStr() == "Logging")
         {
-            for (TiXmlElement *pGenieTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pGenieTiXmlElement != nullptr; pGenieTiXmlElement = pGenieTiXmlElement->NextSiblingElement())
+            for (TiXmlElement *pLoggingTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pLoggingTiXmlElement != nullptr; pLoggingTiXmlElement = pLoggingTiXmlElement->NextSiblingElement())
             {
-                if (pGenieTiXmlElement->ValueStr() == "Use")
+                if (pLoggingTiXmlElement->ValueStr() == "Level")
                 {
-                    std::string useGenieString(pGenieTiXmlElement->GetText());
-                    std::transform(useGenieString.begin(), useGenieString.end(), useGenieString.begin(), [](unsigned char c){ return std::tolower(c);});
-                    if ((useGenieString == "0") || (useGenieString == "false"))
-                    {
-                        m_useGenieInput = false;
-                    }
-                    else
-                    {
-                        m_useGenieInput = true;
-                    }
+                    m_logLevel = pLoggingTiXmlElement->GetText();
                 }
-                else if (pGenieTiXmlElement->ValueStr() == "TrackerFile")
+                else if (pLoggingTiXmlElement->ValueStr() == "ProgressInterval")
                 {
-                    m_genieTrackerFile = pGenieTiXmlElement->GetText();
+                    m_progressInterval = std::stod(pLoggingTiXmlElement->GetText());
+                }
+            }
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "PhysicsTableCache")
+        {
+            for (TiXmlElement *pCacheTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pCacheTiXmlElement != nullptr; pCacheTiXmlElement = pCacheTiXmlElement->NextSiblingElement())
+            {
+                if (pCacheTiXmlElement->ValueStr() == "Use")
+                {
+                    m_usePhysicsTableCache = InputParameters::ParseBool(pCacheTiXmlElement);
+                }
+                else if (pCacheTiXmlElement->ValueStr() == "Directory")
+                {
+                    m_physicsTableCacheDirectory = pCacheTiXmlElement->GetText();
                 }
             }
         }
@@ -239,6 +1141,133 @@ void InputParameters::LoadViaXml(const std::string &inputXmlFileName)
         {
             m_nLayers = std::stoi(pHeadTiXmlElement->GetText());
         }
+        else if (pHeadTiXmlElement->ValueStr() == "NBinsX")
+        {
+            m_nBinsX = std::stoi(pHeadTiXmlElement->GetText());
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "NBinsY")
+        {
+            m_nBinsY = std::stoi(pHeadTiXmlElement->GetText());
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "NBinsZ")
+        {
+            m_nBinsZ = std::stoi(pHeadTiXmlElement->GetText());
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "MortonCellIndex")
+        {
+            m_useMortonCellIndex = InputParameters::ParseBool(pHeadTiXmlElement);
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "ReadoutGrid")
+        {
+            ReadoutGridParameters readoutGrid;
+            readoutGrid.m_cellSize = -1.;
+
+            for (TiXmlElement *pGridTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pGridTiXmlElement != nullptr; pGridTiXmlElement = pGridTiXmlElement->NextSiblingElement())
+            {
+                if (pGridTiXmlElement->ValueStr() == "Name")
+                {
+                    readoutGrid.m_name = pGridTiXmlElement->GetText();
+                }
+                else if (pGridTiXmlElement->ValueStr() == "CellSize")
+                {
+                    readoutGrid.m_cellSize = std::stod(pGridTiXmlElement->GetText());
+                }
+            }
+
+            m_readoutGrids.push_back(readoutGrid);
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "EventReducer")
+        {
+            EventReducerParameters eventReducer;
+            eventReducer.m_nBins = 100;
+            eventReducer.m_binWidth = 10.;
+
+            for (TiXmlElement *pReducerTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pReducerTiXmlElement != nullptr; pReducerTiXmlElement = pReducerTiXmlElement->NextSiblingElement())
+            {
+                if (pReducerTiXmlElement->ValueStr() == "Type")
+                {
+                    eventReducer.m_type = pReducerTiXmlElement->GetText();
+                }
+                else if (pReducerTiXmlElement->ValueStr() == "FileName")
+                {
+                    eventReducer.m_fileName = pReducerTiXmlElement->GetText();
+                }
+                else if (pReducerTiXmlElement->ValueStr() == "NBins")
+                {
+                    eventReducer.m_nBins = std::stoi(pReducerTiXmlElement->GetText());
+                }
+                else if (pReducerTiXmlElement->ValueStr() == "BinWidth")
+                {
+                    eventReducer.m_binWidth = std::stod(pReducerTiXmlElement->GetText());
+                }
+            }
+
+            m_eventReducers.push_back(eventReducer);
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "WriteEventOutput")
+        {
+            m_writeEventOutput = InputParameters::ParseBool(pHeadTiXmlElement);
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "SharedMemoryOutput")
+        {
+            for (TiXmlElement *pSharedMemoryTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pSharedMemoryTiXmlElement != nullptr; pSharedMemoryTiXmlElement = pSharedMemoryTiXmlElement->NextSiblingElement())
+            {
+                if (pSharedMemoryTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useSharedMemoryOutput = InputParameters::ParseBool(pSharedMemoryTiXmlElement);
+                }
+                else if (pSharedMemoryTiXmlElement->ValueStr() == "Name")
+                {
+                    m_sharedMemoryName = pSharedMemoryTiXmlElement->GetText();
+                }
+                else if (pSharedMemoryTiXmlElement->ValueStr() == "Capacity")
+                {
+                    m_sharedMemoryCapacity = std::stoi(pSharedMemoryTiXmlElement->GetText());
+                }
+                else if (pSharedMemoryTiXmlElement->ValueStr() == "Timeout")
+                {
+                    m_sharedMemoryTimeout = std::stod(pSharedMemoryTiXmlElement->GetText());
+                }
+                else if (pSharedMemoryTiXmlElement->ValueStr() == "DropOnTimeout")
+                {
+                    m_sharedMemoryDropOnTimeout = InputParameters::ParseBool(pSharedMemoryTiXmlElement);
+                }
+            }
+        }
+        else if (pHeadTiXmlElement->ValueStr() == "Overlay")
+        {
+            for (TiXmlElement *pOverlayTiXmlElement = pHeadTiXmlElement->FirstChildElement(); pOverlayTiXmlElement != nullptr; pOverlayTiXmlElement = pOverlayTiXmlElement->NextSiblingElement())
+            {
+                if (pOverlayTiXmlElement->ValueStr() == "Use")
+                {
+                    m_useOverlay = InputParameters::ParseBool(pOverlayTiXmlElement);
+                }
+                else if (pOverlayTiXmlElement->ValueStr() == "LibraryFileName")
+                {
+                    m_overlayLibraryFileName = pOverlayTiXmlElement->GetText();
+                }
+                else if (pOverlayTiXmlElement->ValueStr() == "NEvents")
+                {
+                    m_overlayNEvents = std::stoi(pOverlayTiXmlElement->GetText());
+                }
+                else if (pOverlayTiXmlElement->ValueStr() == "TimeWindow")
+                {
+                    m_overlayTimeWindow = std::stod(pOverlayTiXmlElement->GetText());
+                }
+                else if (pOverlayTiXmlElement->ValueStr() == "DriftVelocity")
+                {
+                    m_overlayDriftVelocity = std::stod(pOverlayTiXmlElement->GetText());
+                }
+                else if (pOverlayTiXmlElement->ValueStr() == "MaxShiftY")
+                {
+                    m_overlayMaxShiftY = std::stod(pOverlayTiXmlElement->GetText());
+                }
+                else if (pOverlayTiXmlElement->ValueStr() == "MaxShiftZ")
+                {
+                    m_overlayMaxShiftZ = std::stod(pOverlayTiXmlElement->GetText());
+                }
+            }
+        }
         else if (pHeadTiXmlElement->ValueStr() == "MaxNEventsToProcess")
         {
             m_maxNEventsToProcess = std::stoi(pHeadTiXmlElement->GetText());
@@ -249,21 +1278,64 @@ void InputParameters::LoadViaXml(const std::string &inputXmlFileName)
 
 //------------------------------------------------------------------------------
 
+void InputParameters::LoadRegionParameters(const TiXmlElement *pTiXmlElement, RegionParameters &regionParameters)
+{
+    for (const TiXmlElement *pParameterTiXmlElement = pTiXmlElement->FirstChildElement(); pParameterTiXmlElement != nullptr; pParameterTiXmlElement = pParameterTiXmlElement->NextSiblingElement())
+    {
+        if (pParameterTiXmlElement->ValueStr() == "GammaCut")
+        {
+            regionParameters.m_gammaCut = std::stod(pParameterTiXmlElement->GetText());
+        }
+        else if (pParameterTiXmlElement->ValueStr() == "ElectronCut")
+        {
+            regionParameters.m_electronCut = std::stod(pParameterTiXmlElement->GetText());
+        }
+        else if (pParameterTiXmlElement->ValueStr() == "PositronCut")
+        {
+            regionParameters.m_positronCut = std::stod(pParameterTiXmlElement->GetText());
+        }
+        else if (pParameterTiXmlElement->ValueStr() == "MaxStep")
+        {
+            regionParameters.m_maxStep = std::stod(pParameterTiXmlElement->GetText());
+        }
+        else if (pParameterTiXmlElement->ValueStr() == "MinKineticEnergy")
+        {
+            regionParameters.m_minKineticEnergy = std::stod(pParameterTiXmlElement->GetText());
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool InputParameters::ParseBool(const TiXmlElement *pTiXmlElement)
+{
+    std::string boolString(pTiXmlElement->GetText());
+    std::transform(boolString.begin(), boolString.end(), boolString.begin(), [](unsigned char c){ return std::tolower(c);});
+    return ((boolString != "0") && (boolString != "false"));
+}
+
+//------------------------------------------------------------------------------
+
 void InputParameters::LoadGenieEvents()
 {
     std::ifstream inputFile(m_genieTrackerFile);
 
     if (!inputFile.is_open())
     {
-        std::cout << "Unable to load genie event from the following file : " << m_genieTrackerFile << std::endl;
+        Logger::Write(Logger::ERROR, "Unable to load genie event from the following file : " + m_genieTrackerFile);
     }
 
     std::string line;
     StringVector tokens;
-    unsigned int eventStatus(0);
+    unsigned int eventStatus(0), nUnexpectedLines(0);
+    int nSourceEvents(0), nFailVertex(0), nFailNuanceCode(0), nFailVisibleEnergy(0);
 
     GenieEvent *pGenieEvent(nullptr);
 
+    // ATTN : Genie events are filtered before the physics list is built, so the particle definitions used for their masses are constructed here
+    if (m_useGenieFilter)
+        GenieEvent::ConstructParticleDefinitions();
+
     while(std::getline(inputFile, line))
     {
         tokens = TokeniseLine(line, " $");
@@ -271,6 +1343,7 @@ void InputParameters::LoadGenieEvents()
         if(eventStatus == 0 && tokens[0] == "begin")
         {
             pGenieEvent = new GenieEvent();
+            pGenieEvent->SetSourceIndex(nSourceEvents++);
             eventStatus = 1;
         }
         else if(eventStatus == 1 && tokens[0] == "nuance")
@@ -301,20 +1374,57 @@ void InputParameters::LoadGenieEvents()
         }
         else if(eventStatus == 4 && tokens[0] == "end")
         {
-            // We have reached the end of this event, so save the event and move on
-            m_genieEvents.push_back(*pGenieEvent);
+            // We have reached the end of this event, so save the event if it passes the filter and move on. Rejected events are counted
+            // by the first criterion they fail and are never simulated.
+            if (m_useGenieFilter && (pGenieEvent->GetVertexX() < m_genieFilterMinVertexX || pGenieEvent->GetVertexX() > m_genieFilterMaxVertexX ||
+                pGenieEvent->GetVertexY() < m_genieFilterMinVertexY || pGenieEvent->GetVertexY() > m_genieFilterMaxVertexY ||
+                pGenieEvent->GetVertexZ() < m_genieFilterMinVertexZ || pGenieEvent->GetVertexZ() > m_genieFilterMaxVertexZ))
+            {
+                nFailVertex++;
+            }
+            else if (m_useGenieFilter && !m_genieFilterNuanceCodes.empty() &&
+                std::find(m_genieFilterNuanceCodes.begin(), m_genieFilterNuanceCodes.end(), pGenieEvent->GetNuanceCode()) == m_genieFilterNuanceCodes.end())
+            {
+                nFailNuanceCode++;
+            }
+            else if (m_useGenieFilter && pGenieEvent->GetVisibleEnergy() < m_genieFilterMinVisibleEnergy)
+            {
+                nFailVisibleEnergy++;
+            }
+            else
+            {
+                m_genieEvents.push_back(*pGenieEvent);
+            }
+
             delete pGenieEvent;
             eventStatus = 0;
         }
         else if(eventStatus == 0 && tokens[0] == "stop")
         {
-            std::cout << "Finished reading input file " << m_genieTrackerFile << std::endl;
+            Logger::Write(Logger::INFO, "Finished reading input file " + m_genieTrackerFile);
         }
         else
         {
-            std::cout << "Something has gone wrong in the file. Event status = " << eventStatus << " but line token = " << tokens[0] << std::endl;
+            // ATTN : Unexpected lines are only logged one by one when debugging, otherwise they are summarised once the file is read
+            nUnexpectedLines++;
+
+            if (Logger::IsEnabled(Logger::DEBUG))
+            {
+                Logger::Write(Logger::DEBUG, "Something has gone wrong in the file. Event status = " + std::to_string(eventStatus) + " but line token = " +
+                    (tokens.empty() ? std::string() : tokens[0]));
+            }
         }
     }
+
+    if (nUnexpectedLines > 0)
+        Logger::Write(Logger::WARNING, std::to_string(nUnexpectedLines) + " unexpected lines in genie tracker file " + m_genieTrackerFile);
+
+    if (m_useGenieFilter)
+    {
+        Logger::Write(Logger::INFO, "Genie filter accepted " + std::to_string(m_genieEvents.size()) + " of " + std::to_string(nSourceEvents) +
+            " events, rejected " + std::to_string(nFailVertex) + " by vertex, " + std::to_string(nFailNuanceCode) + " by nuance code and " +
+            std::to_string(nFailVisibleEnergy) + " by visible energy");
+    }
 }
 
 //------------------------------------------------------------------------------
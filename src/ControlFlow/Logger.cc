@@ -0,0 +1,120 @@
+/**
+ *  @file   src/ControlFlow/Logger.cc
+ *
+ *  @brief  Implementation of the Logger class.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+#include "ControlFlow/Logger.hh"
+
+Logger::Logger() :
+    m_level(INFO)
+{
+    m_buffer.reserve(BUFFER_SIZE);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+Logger::~Logger()
+{
+    Logger::Flush();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+Logger &Logger::GetInstance()
+{
+    static Logger logger;
+    return logger;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void Logger::SetLevel(const Severity level)
+{
+    Logger::GetInstance().m_level = level;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool Logger::IsEnabled(const Severity severity)
+{
+    return (severity >= Logger::GetInstance().m_level);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void Logger::Write(const Severity severity, const std::string &message)
+{
+    Logger &logger(Logger::GetInstance());
+
+    if (severity < logger.m_level)
+        return;
+
+    if (severity == WARNING)
+    {
+        logger.m_buffer += "WARNING : ";
+    }
+    else if (severity == ERROR)
+    {
+        logger.m_buffer += "ERROR : ";
+    }
+
+    logger.m_buffer += message;
+    logger.m_buffer += '\n';
+
+    // ATTN : Warnings and errors are flushed at once, as they often precede a crash or a killed job that would lose the buffered messages,
+    //        such as the seed of an event aborted by the watchdog, and should appear in order with the unbuffered geant4 output
+    if (severity >= WARNING || logger.m_buffer.size() >= BUFFER_SIZE)
+        Logger::Flush();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void Logger::Flush()
+{
+    Logger &logger(Logger::GetInstance());
+
+    if (logger.m_buffer.empty())
+        return;
+
+    std::cout.write(logger.m_buffer.data(), logger.m_buffer.size());
+    std::cout.flush();
+    logger.m_buffer.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool Logger::GetSeverity(const std::string &name, Severity &severity)
+{
+    std::string lowerName(name);
+    std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), [](unsigned char c){ return std::tolower(c);});
+
+    if (lowerName == "debug")
+    {
+        severity = DEBUG;
+    }
+    else if (lowerName == "info")
+    {
+        severity = INFO;
+    }
+    else if (lowerName == "warning")
+    {
+        severity = WARNING;
+    }
+    else if (lowerName == "error")
+    {
+        severity = ERROR;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,75 @@
+/**
+ *  @file   src/ControlFlow/ProgressReporter.cc
+ *
+ *  @brief  Implementation of the ProgressReporter class.
+ *
+ *  $Log: $
+ */
+
+#include <sstream>
+
+#include "ControlFlow/Logger.hh"
+#include "ControlFlow/ProgressReporter.hh"
+
+ProgressReporter::ProgressReporter(const double interval) :
+    m_interval(interval),
+    m_nEventsToProcess(0),
+    m_nEvents(0),
+    m_start(Clock::now()),
+    m_nextReport(m_start)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ProgressReporter::BeginOfRun(const int nEventsToProcess)
+{
+    m_nEventsToProcess = nEventsToProcess;
+    m_nEvents = 0;
+    m_start = Clock::now();
+    m_nextReport = m_start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_interval));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ProgressReporter::EndOfEvent()
+{
+    m_nEvents++;
+
+    const Clock::time_point now(Clock::now());
+
+    if (now < m_nextReport)
+        return;
+
+    // ATTN : Flushed with each report, so a job killed between reports loses at most one interval of buffered messages
+    this->Report(now);
+    Logger::Flush();
+    m_nextReport = now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_interval));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ProgressReporter::EndOfRun()
+{
+    this->Report(Clock::now());
+    Logger::Flush();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ProgressReporter::Report(const Clock::time_point &now) const
+{
+    if (!Logger::IsEnabled(Logger::INFO))
+        return;
+
+    const double elapsed(std::chrono::duration<double>(now - m_start).count());
+    const double rate(elapsed > 0. ? m_nEvents / elapsed : 0.);
+
+    std::ostringstream message;
+    message << "Processed " << m_nEvents << " / " << m_nEventsToProcess << " events in " << elapsed << " s, " << rate << " events/s";
+
+    if (m_nEvents < m_nEventsToProcess && rate > 0.)
+        message << ", ETA " << (m_nEventsToProcess - m_nEvents) / rate << " s";
+
+    Logger::Write(Logger::INFO, message.str());
+}
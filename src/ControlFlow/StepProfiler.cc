@@ -0,0 +1,159 @@
+/**
+ *  @file   src/ControlFlow/StepProfiler.cc
+ *
+ *  @brief  Implementation of the StepProfiler class.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+#include "ControlFlow/Logger.hh"
+#include "ControlFlow/StepProfiler.hh"
+
+bool StepProfiler::Key::operator==(const Key &rhs) const
+{
+    return (m_pParticleDefinition == rhs.m_pParticleDefinition && m_pCreatorProcess == rhs.m_pCreatorProcess && m_pVolume == rhs.m_pVolume);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+std::size_t StepProfiler::KeyHasher::operator()(const Key &key) const
+{
+    const std::hash<const void*> hasher;
+    std::size_t hash(hasher(key.m_pParticleDefinition));
+    hash = hash * 31 + hasher(key.m_pCreatorProcess);
+    hash = hash * 31 + hasher(key.m_pVolume);
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+StepProfiler::StepProfiler(const std::string &fileName, const unsigned int nRows) :
+    m_fileName(fileName),
+    m_nRows(nRows),
+    m_currentKey({nullptr, nullptr, nullptr}),
+    m_pCurrentCounters(nullptr),
+    m_lastTime(Clock::now())
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void StepProfiler::BeginOfTrack(const G4Track *pG4Track)
+{
+    m_currentKey.m_pParticleDefinition = pG4Track->GetDefinition();
+    m_currentKey.m_pCreatorProcess = pG4Track->GetCreatorProcess();
+    m_currentKey.m_pVolume = nullptr;
+    m_pCurrentCounters = nullptr;
+    m_lastTime = Clock::now();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void StepProfiler::AddStep(const G4Step *pG4Step)
+{
+    const Clock::time_point now(Clock::now());
+    const G4VPhysicalVolume *pVolume(pG4Step->GetPreStepPoint()->GetTouchableHandle()->GetVolume());
+
+    // ATTN : Tracks rarely change volume, so the map lookup is skipped for most steps
+    if (!m_pCurrentCounters || pVolume != m_currentKey.m_pVolume)
+    {
+        m_currentKey.m_pVolume = pVolume;
+        m_pCurrentCounters = &m_counters[m_currentKey];
+        m_pCurrentCounters->m_nTrackSegments++;
+    }
+
+    m_pCurrentCounters->m_nSteps++;
+    m_pCurrentCounters->m_trackLength += pG4Step->GetStepLength();
+    m_pCurrentCounters->m_time += std::chrono::duration<double>(now - m_lastTime).count();
+    m_lastTime = now;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void StepProfiler::EndOfTrack()
+{
+    m_pCurrentCounters = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void StepProfiler::WriteReport() const
+{
+    typedef std::pair<const Key*, const Counters*> KeyCountersPair;
+    std::vector<KeyCountersPair> rows;
+    std::uint64_t totalSteps(0);
+    double totalTime(0.);
+
+    for (const auto &iter : m_counters)
+    {
+        rows.emplace_back(&iter.first, &iter.second);
+        totalSteps += iter.second.m_nSteps;
+        totalTime += iter.second.m_time;
+    }
+
+    std::sort(rows.begin(), rows.end(), [](const KeyCountersPair &lhs, const KeyCountersPair &rhs){ return lhs.second->m_time > rhs.second->m_time;});
+
+    std::ofstream file;
+
+    if (!m_fileName.empty())
+    {
+        file.open(m_fileName);
+
+        if (!file.is_open())
+        {
+            Logger::Write(Logger::ERROR, "Unable to open step profile " + m_fileName);
+        }
+        else
+        {
+            file << "Particle,PDG,CreatorProcess,Volume,TrackSegments,Steps,TrackLength,Time" << std::endl;
+        }
+    }
+
+    // ATTN : The table is written as one message, so it stays in one piece whatever else is logged
+    std::ostringstream table;
+    table << "Step profile : " << totalSteps << " steps, " << totalTime << " s stepping time" << std::endl;
+    table << std::setw(12) << "Particle" << std::setw(20) << "CreatorProcess" << std::setw(16) << "Volume" << std::setw(12) << "Steps"
+          << std::setw(9) << "Steps %" << std::setw(14) << "Length (mm)" << std::setw(10) << "Time (s)" << std::setw(9) << "Time %";
+
+    for (unsigned int row = 0; row < rows.size(); row++)
+    {
+        const Key &key(*rows.at(row).first);
+        const Counters &counters(*rows.at(row).second);
+
+        const std::string particleName(key.m_pParticleDefinition ? std::string(key.m_pParticleDefinition->GetParticleName()) : "unknown");
+        const int pdg(key.m_pParticleDefinition ? key.m_pParticleDefinition->GetPDGEncoding() : 0);
+        const std::string processName(key.m_pCreatorProcess ? std::string(key.m_pCreatorProcess->GetProcessName()) : "primary");
+        const std::string volumeName(key.m_pVolume ? std::string(key.m_pVolume->GetName()) : "none");
+        const double trackLength(counters.m_trackLength / mm);
+
+        if (file.is_open())
+        {
+            file << particleName << "," << pdg << "," << processName << "," << volumeName << "," << counters.m_nTrackSegments << "," << counters.m_nSteps
+                 << "," << trackLength << "," << counters.m_time << "\n";
+        }
+
+        if (row < m_nRows)
+        {
+            table << std::endl << std::setw(12) << particleName << std::setw(20) << processName << std::setw(16) << volumeName << std::setw(12)
+                  << counters.m_nSteps << std::setw(9) << std::setprecision(3) << 100. * counters.m_nSteps / std::max<std::uint64_t>(totalSteps, 1)
+                  << std::setw(14) << std::setprecision(6) << trackLength << std::setw(10) << counters.m_time << std::setw(9)
+                  << std::setprecision(3) << (totalTime > 0. ? 100. * counters.m_time / totalTime : 0.) << std::setprecision(6);
+        }
+    }
+
+    Logger::Write(Logger::INFO, table.str());
+}
@@ -28,21 +28,10 @@
 /// \file exampleG4TPC.cc
 /// \brief Main program of the G4TPC example
 
-#include "G4TPCDetectorConstruction.hh"
-#include "G4TPCActionInitialization.hh"
+#include "G4TPCSimulation.hh"
 #include "ControlFlow/InputParameters.hh"
 
-#include "G4RunManager.hh"
-#include "G4UImanager.hh"
-#include "G4UIcommand.hh"
-#include "G4StepLimiterPhysics.hh"
-#include "FTFP_BERT.hh"
-#include "QGSP_BERT.hh"
-
-#include "Randomize.hh"
-
-#include "G4VisExecutive.hh"
-#include "G4UIExecutive.hh"
+#include "globals.hh"
 
 //------------------------------------------------------------------------------
 
@@ -68,7 +57,7 @@ int main(int argc,char** argv)
         return 1;
     }
 
-    const InputParameters inputParameters(argv[1]);
+    InputParameters inputParameters(argv[1]);
 
     if (!inputParameters.Valid())
     {
@@ -76,38 +65,12 @@ int main(int argc,char** argv)
         return 1;
     }
 
-    // Choose the Random engine
-    G4Random::setTheEngine(new CLHEP::RanecuEngine);
-
-    // Construct the default run manager
-    G4RunManager *pG4RunManager = new G4RunManager;
-
-    // Set mandatory and optional initialization classes
-    G4TPCDetectorConstruction *pG4TPCDetectorConstruction = new G4TPCDetectorConstruction(&inputParameters);
-    pG4RunManager->SetUserInitialization(pG4TPCDetectorConstruction);
-
-    G4VModularPhysicsList *pG4VModularPhysicsList = new QGSP_BERT;
-    pG4VModularPhysicsList->RegisterPhysics(new G4StepLimiterPhysics());
-    pG4RunManager->SetUserInitialization(pG4VModularPhysicsList);
+    G4TPCSimulation simulation(inputParameters);
 
-    G4TPCActionInitialization *pG4TPCActionInitialization = new G4TPCActionInitialization(pG4TPCDetectorConstruction, &inputParameters);
-    pG4RunManager->SetUserInitialization(pG4TPCActionInitialization);
-
-    // Initialize visualization
-    G4VisManager* pG4VisManager = new G4VisExecutive;
-    pG4VisManager->Initialize();
-
-    // Get the pointer to the User Interface manager
-    G4UImanager* pG4UImanager = G4UImanager::GetUIpointer();
-    pG4UImanager->ApplyCommand("/run/initialize");
-
-    unsigned int nEventsToProcess(inputParameters.GetUseParticleGun() ? inputParameters.GetMaxNEventsToProcess() :
-        std::min(inputParameters.GetGenieNEvents(), inputParameters.GetMaxNEventsToProcess()));
-
-    pG4UImanager->ApplyCommand("/run/beamOn " + std::to_string(nEventsToProcess));
+    if (!simulation.Initialize() || !simulation.Run())
+        return 1;
 
-    delete pG4VisManager;
-    delete pG4RunManager;
+    return 0;
 }
 
 //------------------------------------------------------------------------------
@@ -34,6 +34,7 @@
 #include "G4TPCPrimaryGeneratorAction.hh"
 #include "G4TPCRunAction.hh"
 #include "G4TPCEventAction.hh"
+#include "G4TPCStackingAction.hh"
 #include "G4TPCSteppingAction.hh"
 #include "G4TPCDetectorConstruction.hh"
 
@@ -60,10 +61,18 @@ void G4TPCActionInitialization::Build() const
     EventContainer *pEventContainer = new EventContainer(m_pInputParameters);
     G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction = new G4TPCMCParticleUserAction(pEventContainer, m_pInputParameters);
     SetUserAction(new G4TPCPrimaryGeneratorAction(pEventContainer, m_pInputParameters));
-    SetUserAction(new G4TPCRunAction(pEventContainer, pG4TPCMCParticleUserAction));
-    SetUserAction(new G4TPCEventAction(pEventContainer, pG4TPCMCParticleUserAction));
+    SetUserAction(new G4TPCRunAction(pEventContainer, pG4TPCMCParticleUserAction, m_pInputParameters));
+    SetUserAction(new G4TPCEventAction(pEventContainer, pG4TPCMCParticleUserAction, m_pG4TPCDetectorConstruction));
     G4UserTrackingAction *trackingAction = (G4UserTrackingAction*) pG4TPCMCParticleUserAction;
     SetUserAction(trackingAction);
-    SetUserAction(new G4TPCSteppingAction(m_pG4TPCDetectorConstruction, pEventContainer, pG4TPCMCParticleUserAction));
+    G4TPCSteppingAction *pG4TPCSteppingAction = new G4TPCSteppingAction(m_pG4TPCDetectorConstruction, pEventContainer, pG4TPCMCParticleUserAction,
+        m_pInputParameters);
+    SetUserAction(pG4TPCSteppingAction);
+
+    if (m_pInputParameters->GetUseStackingAction())
+        SetUserAction(new G4TPCStackingAction(m_pG4TPCDetectorConstruction, pEventContainer, pG4TPCSteppingAction, m_pInputParameters));
+
+    // ATTN : Fast simulation models deposit energy via the stepping action, and are created when the run is initialized
+    m_pG4TPCDetectorConstruction->SetSteppingAction(pG4TPCSteppingAction);
 }
 
@@ -0,0 +1,141 @@
+/**
+ *  @file   src/G4TPCBench.cxx
+ *
+ *  @brief  Run a benchmark workload and report its throughput, time per phase and peak memory as one json line.
+ *
+ *  $Log: $
+ */
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#include "G4TPCActionInitialization.hh"
+#include "G4TPCDetectorConstruction.hh"
+#include "G4TPCPhysicsListFactory.hh"
+#include "G4TPCRunAction.hh"
+#include "ControlFlow/EventCostReport.hh"
+#include "ControlFlow/InputParameters.hh"
+#include "Persistency/EventContainer.hh"
+
+#include "G4RunManager.hh"
+#include "G4VModularPhysicsList.hh"
+
+#include "Randomize.hh"
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+void PrintUsage()
+{
+    std::cout << " Usage: " << G4endl;
+    std::cout << " G4TPC_bench Workload.xml [Results.json]" << G4endl;
+}
+
+//------------------------------------------------------------------------------
+
+double Seconds(const Clock::time_point &start, const Clock::time_point &end)
+{
+    return std::chrono::duration<double>(end - start).count();
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc != 2 && argc != 3)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    const Clock::time_point start(Clock::now());
+    const InputParameters inputParameters(argv[1]);
+
+    if (!inputParameters.Valid())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    // ATTN : Workloads must be reproducible, and the event cost report is what counts the steps
+    if (inputParameters.GetRandomSeed() < 0 || !inputParameters.GetUseEventCostReport())
+    {
+        std::cout << "Benchmark workloads must set a RandomSeed and enable the EventCostReport" << G4endl;
+        return 1;
+    }
+
+    G4Random::setTheEngine(new CLHEP::RanecuEngine);
+    G4RunManager *pG4RunManager = new G4RunManager;
+
+    G4TPCDetectorConstruction *pG4TPCDetectorConstruction = new G4TPCDetectorConstruction(&inputParameters);
+    pG4RunManager->SetUserInitialization(pG4TPCDetectorConstruction);
+
+    G4VModularPhysicsList *pG4VModularPhysicsList = G4TPCPhysicsListFactory::Create(inputParameters);
+
+    if (!pG4VModularPhysicsList)
+    {
+        delete pG4RunManager;
+        return 1;
+    }
+
+    pG4RunManager->SetUserInitialization(pG4VModularPhysicsList);
+    pG4RunManager->SetUserInitialization(new G4TPCActionInitialization(pG4TPCDetectorConstruction, &inputParameters));
+    pG4RunManager->Initialize();
+
+    const Clock::time_point initialized(Clock::now());
+
+    const unsigned int nEventsToProcess(inputParameters.GetUseParticleGun() ? inputParameters.GetMaxNEventsToProcess() :
+        std::min(inputParameters.GetGenieNEvents(), inputParameters.GetMaxNEventsToProcess()));
+    pG4RunManager->BeamOn(nEventsToProcess);
+
+    const Clock::time_point finished(Clock::now());
+    G4TPCPhysicsListFactory::StorePhysicsTables(inputParameters, pG4VModularPhysicsList);
+
+    const G4TPCRunAction *pG4TPCRunAction(dynamic_cast<const G4TPCRunAction*>(pG4RunManager->GetUserRunAction()));
+    const EventContainer *pEventContainer(pG4TPCRunAction->GetEventContainer());
+    const EventCostReport *pEventCostReport(pEventContainer->GetEventCostReport());
+
+    // ATTN : Serialisation happens inside the run, at the end of each event and at the end of the run, so is taken out of the tracking time
+    const double initTime(Seconds(start, initialized));
+    const double serializationTime(pEventContainer->GetSerializationTime());
+    const double trackingTime(Seconds(initialized, finished) - serializationTime);
+
+    std::ostringstream result;
+    result << "{\"workload\": \"" << argv[1] << "\", "
+           << "\"events\": " << pEventCostReport->GetNEvents() << ", "
+           << "\"steps\": " << pEventCostReport->GetTotalSteps() << ", "
+           << "\"initTime\": " << initTime << ", "
+           << "\"trackingTime\": " << trackingTime << ", "
+           << "\"serializationTime\": " << serializationTime << ", "
+           << "\"eventsPerSecond\": " << (trackingTime > 0. ? pEventCostReport->GetNEvents() / trackingTime : 0.) << ", "
+           << "\"stepsPerSecond\": " << (trackingTime > 0. ? pEventCostReport->GetTotalSteps() / trackingTime : 0.) << ", "
+           << "\"peakRSS\": " << EventCostReport::GetPeakRSS() << "}";
+
+    std::cout << result.str() << std::endl;
+
+    if (argc == 3)
+    {
+        std::ofstream resultsFile(argv[2], std::ios::app);
+
+        if (!resultsFile.is_open())
+        {
+            std::cout << "Unable to open benchmark results file " << argv[2] << std::endl;
+            delete pG4RunManager;
+            return 1;
+        }
+
+        resultsFile << result.str() << std::endl;
+    }
+
+    delete pG4RunManager;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
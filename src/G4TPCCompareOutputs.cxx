@@ -0,0 +1,58 @@
+/**
+ *  @file   src/G4TPCCompareOutputs.cxx
+ *
+ *  @brief  Compare two xml outputs of the same sample event by event, such as simulations with a fast model switched on and off, printing
+ *          the differences in cell energy, cell multiplicity, energy centroid and shower profiles.
+ *
+ *  $Log: $
+ */
+
+#include <iostream>
+#include <string>
+
+#include "Analysis/OutputComparison.hh"
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+void PrintUsage()
+{
+    std::cout << " Usage: " << std::endl;
+    std::cout << " G4TPCCompareOutputs TestOutput.xml ReferenceOutput.xml [NProfileBins ProfileBinWidth(mm)]" << std::endl;
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc != 3 && argc != 5)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    const int nProfileBins(argc == 5 ? std::stoi(argv[3]) : 100);
+    const double profileBinWidth(argc == 5 ? std::stod(argv[4]) : 20.);
+
+    if (nProfileBins <= 0 || profileBinWidth <= 0.)
+    {
+        std::cout << "Shower profiles require a positive number of bins and bin width" << std::endl;
+        PrintUsage();
+        return 1;
+    }
+
+    const OutputComparison outputComparison(nProfileBins, profileBinWidth);
+    OutputComparison::EventSummaryMap testSummaries, referenceSummaries;
+
+    if (!outputComparison.ReadOutput(argv[1], testSummaries) || !outputComparison.ReadOutput(argv[2], referenceSummaries))
+        return 1;
+
+    outputComparison.Compare(testSummaries, referenceSummaries, "Test", "Reference");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,236 @@
+/**
+ *  @file   src/G4TPCDepositBufferTest.cxx
+ *
+ *  @brief  Test of the batched deposit reduction, run without geant4 tracking.  The radix sort and segmented reduction must give the same
+ *          cells and track contributions as filling the cell list step by step, as G4TPCSteppingAction does.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "Objects/Cell.hh"
+#include "Readout/DepositBuffer.hh"
+#include "Readout/VoxelGrid.hh"
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+/**
+ *  @brief  Fill a deposit stream with tracks of short steps that cross each other, some leaving the grid, so that cells collect energy from
+ *          several tracks in an interleaved order
+ *
+ *  @param  nTracks number of tracks
+ *  @param  nStepsPerTrack number of steps per track
+ *  @param  seed for the deposit positions and energies
+ *  @param  depositBuffer to receive the deposits
+ */
+void FillDeposits(const unsigned int nTracks, const unsigned int nStepsPerTrack, const unsigned int seed, DepositBuffer &depositBuffer)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> position(-60.f, 60.f), direction(-1.f, 1.f);
+    std::exponential_distribution<float> energy(5.f);
+
+    for (unsigned int track = 0; track < nTracks; ++track)
+    {
+        float x(position(generator)), y(position(generator)), z(position(generator));
+        float dx(direction(generator)), dy(direction(generator)), dz(direction(generator));
+        const float norm(std::sqrt(dx * dx + dy * dy + dz * dz) / 0.3f);
+        dx /= norm; dy /= norm; dz /= norm;
+
+        for (unsigned int step = 0; step < nStepsPerTrack; ++step)
+        {
+            // ATTN : Alternate between two track ids per track, so a cell sees the same track again after another one
+            depositBuffer.Add(x, y, z, x + dx, y + dy, z + dz, energy(generator), 2 * track + 1 + (step / 3) % 2);
+            x += dx; y += dy; z += dz;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Fill a cell list one deposit at a time, matching the step by step filling in G4TPCSteppingAction
+ *
+ *  @param  depositBuffer the deposits
+ *  @param  voxelGrid the readout grid
+ *  @param  cellList to receive the cells
+ */
+void FillUnbatched(const DepositBuffer &depositBuffer, const VoxelGrid &voxelGrid, CellList &cellList)
+{
+    for (std::size_t deposit = 0; deposit < depositBuffer.Size(); ++deposit)
+    {
+        Cell *pCell = new Cell(voxelGrid.GetCell(depositBuffer.GetX()[deposit], depositBuffer.GetY()[deposit], depositBuffer.GetZ()[deposit]));
+        pCell->AddEnergy(depositBuffer.GetEnergy()[deposit]);
+        cellList.AddEnergyDeposition(pCell, depositBuffer.GetTrackId()[deposit]);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Delete the cells owned by a cell list
+ *
+ *  @param  cellList the cell list
+ */
+void DeleteCells(CellList &cellList)
+{
+    for (const auto &iter : cellList.m_idCellMap)
+        delete iter.second;
+
+    cellList.m_idCellMap.clear();
+    cellList.m_mcComponents.clear();
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Whether two energies agree, up to the rounding from summing the same deposits in a different grouping
+ *
+ *  @param  lhs first energy
+ *  @param  rhs second energy
+ *
+ *  @return whether the energies agree
+ */
+bool EnergiesAgree(const float lhs, const float rhs)
+{
+    return (std::fabs(lhs - rhs) <= 1.e-5f * std::max(1.f, std::max(std::fabs(lhs), std::fabs(rhs))));
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Compare the cells and track contributions of two cell lists
+ *
+ *  @param  name of the test case
+ *  @param  expected the cell list filled step by step
+ *  @param  actual the cell list filled by the batched reduction
+ *
+ *  @return whether the cell lists agree
+ */
+bool Compare(const std::string &name, const CellList &expected, const CellList &actual)
+{
+    if (expected.m_idCellMap.size() != actual.m_idCellMap.size() || expected.m_mcComponents.size() != actual.m_mcComponents.size())
+    {
+        std::cout << name << ": " << actual.m_idCellMap.size() << " cells, expected " << expected.m_idCellMap.size() << std::endl;
+        return false;
+    }
+
+    for (const auto &iter : expected.m_idCellMap)
+    {
+        const CellIndexCellMap::const_iterator actualIter(actual.m_idCellMap.find(iter.first));
+
+        if (actualIter == actual.m_idCellMap.end())
+        {
+            std::cout << name << ": missing cell " << iter.first << std::endl;
+            return false;
+        }
+
+        const Cell *const pExpected(iter.second), *const pActual(actualIter->second);
+
+        if (pActual->GetIdx() != pExpected->GetIdx() || pActual->GetX() != pExpected->GetX() || pActual->GetY() != pExpected->GetY() ||
+            pActual->GetZ() != pExpected->GetZ() || !EnergiesAgree(pActual->GetEnergy(), pExpected->GetEnergy()))
+        {
+            std::cout << name << ": cell " << iter.first << " has energy " << pActual->GetEnergy() << ", expected " << pExpected->GetEnergy()
+                      << std::endl;
+            return false;
+        }
+
+        // ATTN : The sort is stable, so the tracks must also appear in the order of their first step in the cell
+        const IntFloatVector &expectedComponents(expected.m_mcComponents.at(iter.first));
+        const IntFloatVector &actualComponents(actual.m_mcComponents.at(iter.first));
+
+        if (expectedComponents.size() != actualComponents.size())
+        {
+            std::cout << name << ": cell " << iter.first << " has " << actualComponents.size() << " tracks, expected " << expectedComponents.size()
+                      << std::endl;
+            return false;
+        }
+
+        for (std::size_t component = 0; component < expectedComponents.size(); ++component)
+        {
+            if (actualComponents[component].first != expectedComponents[component].first ||
+                !EnergiesAgree(actualComponents[component].second, expectedComponents[component].second))
+            {
+                std::cout << name << ": cell " << iter.first << " track " << actualComponents[component].first << " has energy "
+                          << actualComponents[component].second << ", expected track " << expectedComponents[component].first << " with energy "
+                          << expectedComponents[component].second << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Reduce a deposit stream with and without batching and compare the cell lists
+ *
+ *  @param  name of the test case
+ *  @param  depositBuffer the deposits
+ *  @param  voxelGrid the readout grid
+ *  @param  nFills number of times the deposits are added to the same cell list, more than one merges into existing cells
+ *
+ *  @return whether the cell lists agree
+ */
+bool Test(const std::string &name, const DepositBuffer &depositBuffer, const VoxelGrid &voxelGrid, const unsigned int nFills)
+{
+    CellList expected, actual;
+
+    for (unsigned int fill = 0; fill < nFills; ++fill)
+    {
+        FillUnbatched(depositBuffer, voxelGrid, expected);
+        depositBuffer.Reduce(voxelGrid, actual);
+    }
+
+    const bool agree(Compare(name, expected, actual));
+    std::cout << (agree ? "PASS " : "FAIL ") << name << " (" << depositBuffer.Size() << " deposits, " << expected.m_idCellMap.size() << " cells)"
+              << std::endl;
+
+    DeleteCells(expected);
+    DeleteCells(actual);
+
+    return agree;
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+int main()
+{
+    // ATTN : More deposits than the reduction batch size, so positions are voxelized across several batches
+    DepositBuffer depositBuffer;
+    FillDeposits(40, 500, 12345, depositBuffer);
+
+    DepositBuffer singleDepositBuffer;
+    singleDepositBuffer.Add(1.f, 2.f, 3.f, 0.25f, 7);
+
+    // ATTN : The morton grid has indices spanning every byte the radix sort passes over, the linear grids only the low bytes
+    const VoxelGrid linearGrid(-50., -40., -30., 100., 80., 60., 50, 40, 30);
+    const VoxelGrid uniformCubicGrid(-50., -50., -50., 100., 100., 100., 64, 64, 64);
+    const VoxelGrid mortonGrid(-50., -50., -50., 100., 100., 100., 1 << 20, 1 << 20, 1 << 20, VoxelGrid::MORTON);
+    const VoxelGrid coarseMortonGrid(-50., -40., -30., 100., 80., 60., 10, 8, 6, VoxelGrid::MORTON);
+
+    bool success(true);
+    success = Test("Linear grid", depositBuffer, linearGrid, 1) && success;
+    success = Test("Linear uniform cubic grid", depositBuffer, uniformCubicGrid, 1) && success;
+    success = Test("Morton uniform cubic grid", depositBuffer, mortonGrid, 1) && success;
+    success = Test("Morton grid", depositBuffer, coarseMortonGrid, 1) && success;
+    success = Test("Linear grid, merged into existing cells", depositBuffer, linearGrid, 3) && success;
+    success = Test("Morton grid, merged into existing cells", depositBuffer, coarseMortonGrid, 3) && success;
+    success = Test("Single deposit", singleDepositBuffer, mortonGrid, 1) && success;
+    success = Test("No deposits", DepositBuffer(), linearGrid, 1) && success;
+
+    return (success ? 0 : 1);
+}
+
+//------------------------------------------------------------------------------
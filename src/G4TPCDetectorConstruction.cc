@@ -44,16 +44,24 @@
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UserLimits.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Region.hh"
 #include "G4Step.hh"
 
 #include "G4TPCDetectorConstruction.hh"
+#include "G4TPCEMShowerModel.hh"
+#include "G4TPCShowerLibraryModel.hh"
 
 #include "ControlFlow/InputParameters.hh"
+#include "Readout/VoxelGrid.hh"
 
 //------------------------------------------------------------------------------
 
 G4TPCDetectorConstruction::G4TPCDetectorConstruction(const InputParameters *pInputParameters) : G4VUserDetectorConstruction(),
     m_pG4LogicalVolumeLAr(nullptr),
+    m_pAbsorberRegion(nullptr),
+    m_pG4TPCSteppingAction(nullptr),
+    m_pInputParameters(pInputParameters),
     m_checkOverlaps(true)
 {
     m_xCenter = pInputParameters->GetCenterX() * mm;
@@ -66,15 +74,29 @@ G4TPCDetectorConstruction::G4TPCDetectorConstruction(const InputParameters *pInp
 
     m_nLayers = pInputParameters->GetNLayers();
 
-    m_xLow = m_xCenter - 0.5f * m_xWidth;
-    m_yLow = m_yCenter - 0.5f * m_yWidth;
-    m_zLow = m_zCenter - 0.5f * m_zWidth;
+    const double xLow(m_xCenter - 0.5f * m_xWidth), yLow(m_yCenter - 0.5f * m_yWidth), zLow(m_zCenter - 0.5f * m_zWidth);
+    const VoxelGrid::IndexScheme indexScheme(pInputParameters->GetUseMortonCellIndex() ? VoxelGrid::MORTON : VoxelGrid::LINEAR);
+
+    m_voxelGrids.push_back(new VoxelGrid(xLow, yLow, zLow, m_xWidth, m_yWidth, m_zWidth, pInputParameters->GetNBinsX(), pInputParameters->GetNBinsY(),
+        pInputParameters->GetNBinsZ(), indexScheme));
+
+    // ATTN : Additional grids keep their requested cell size, so the last cell along an axis may overhang the detector
+    for (const ReadoutGridParameters &readoutGrid : pInputParameters->GetReadoutGrids())
+    {
+        const double cellSize(readoutGrid.m_cellSize * mm);
+        const unsigned int nBinsX(std::ceil(m_xWidth / cellSize)), nBinsY(std::ceil(m_yWidth / cellSize)), nBinsZ(std::ceil(m_zWidth / cellSize));
+
+        m_voxelGrids.push_back(new VoxelGrid(xLow, yLow, zLow, nBinsX * cellSize, nBinsY * cellSize, nBinsZ * cellSize, nBinsX, nBinsY, nBinsZ,
+            indexScheme));
+    }
 }
 
 //------------------------------------------------------------------------------
 
 G4TPCDetectorConstruction::~G4TPCDetectorConstruction()
 {
+    for (VoxelGrid *pVoxelGrid : m_voxelGrids)
+        delete pVoxelGrid;
 }
 
 //------------------------------------------------------------------------------
@@ -87,6 +109,36 @@ G4VPhysicalVolume* G4TPCDetectorConstruction::Construct()
 
 //------------------------------------------------------------------------------
 
+void G4TPCDetectorConstruction::ConstructSDandField()
+{
+    if (!m_pInputParameters->GetUseShowerLibrary() && !m_pInputParameters->GetUseEMShowerParameterisation())
+        return;
+
+    if (!m_pG4TPCSteppingAction)
+    {
+        G4ExceptionDescription msg;
+        msg << "Stepping action must be set before the fast simulation models are created.";
+        G4Exception("G4TPCDetectorConstruction::ConstructSDandField()", "MyCode0002", FatalException, msg);
+    }
+
+    // ATTN : Models are tried in order of creation, so the library takes the low energy showers and the parameterisation the rest
+    if (m_pInputParameters->GetUseShowerLibrary())
+    {
+        G4TPCShowerLibraryModel *pG4TPCShowerLibraryModel = new G4TPCShowerLibraryModel("ShowerLibraryModel", m_pAbsorberRegion, this,
+            m_pG4TPCSteppingAction, m_pInputParameters);
+        G4AutoDelete::Register(pG4TPCShowerLibraryModel);
+    }
+
+    if (m_pInputParameters->GetUseEMShowerParameterisation())
+    {
+        G4TPCEMShowerModel *pG4TPCEMShowerModel = new G4TPCEMShowerModel("EMShowerModel", m_pAbsorberRegion, this, m_pG4TPCSteppingAction,
+            m_pInputParameters);
+        G4AutoDelete::Register(pG4TPCEMShowerModel);
+    }
+}
+
+//------------------------------------------------------------------------------
+
 void G4TPCDetectorConstruction::DefineMaterials()
 {
     // Lead material defined using NIST Manager
@@ -142,12 +194,16 @@ G4VPhysicalVolume* G4TPCDetectorConstruction::DefineVolumes()
     G4LogicalVolume* absorberLV = new G4LogicalVolume(absorberS, pG4Material_LAr, "Abso");
     m_pG4LogicalVolumeLAr = new G4PVPlacement(0, worldCenter, absorberLV, "Abso", layerLV, false, 0, m_checkOverlaps);
 
-    double maxStep = 0.001*mm;
-    G4UserLimits* fStepLimit = new G4UserLimits(maxStep);
-    worldLV->SetUserLimits(fStepLimit);
-    calorLV->SetUserLimits(fStepLimit);
-    layerLV->SetUserLimits(fStepLimit);
-    absorberLV->SetUserLimits(fStepLimit);
+    // Regions, the world cuts are applied to the default region via the physics list
+    G4UserLimits* pWorldUserLimits = this->CreateUserLimits(m_pInputParameters->GetWorldRegion());
+    worldLV->SetUserLimits(pWorldUserLimits);
+    calorLV->SetUserLimits(pWorldUserLimits);
+    layerLV->SetUserLimits(pWorldUserLimits);
+
+    m_pAbsorberRegion = new G4Region("Absorber");
+    m_pAbsorberRegion->AddRootLogicalVolume(absorberLV);
+    m_pAbsorberRegion->SetProductionCuts(this->CreateProductionCuts(m_pInputParameters->GetAbsorberRegion()));
+    absorberLV->SetUserLimits(this->CreateUserLimits(m_pInputParameters->GetAbsorberRegion()));
 
     // Visualization attributes
     worldLV->SetVisAttributes (G4VisAttributes::Invisible);
@@ -162,27 +218,34 @@ G4VPhysicalVolume* G4TPCDetectorConstruction::DefineVolumes()
 
 //------------------------------------------------------------------------------
 
-Cell G4TPCDetectorConstruction::GetCell(const G4Step *pG4Step) const
+G4ProductionCuts *G4TPCDetectorConstruction::CreateProductionCuts(const RegionParameters &regionParameters) const
 {
-    // ATTN: Cell index is zero at lowest x,y,z coordinate, then builds up along x then y then z
-    const int xIndex = m_nLayers * (pG4Step->GetPreStepPoint()->GetPosition().x() - m_xLow) / (m_xWidth);
-    const int yIndex = m_nLayers * (pG4Step->GetPreStepPoint()->GetPosition().y() - m_yLow) / (m_yWidth);
-    const int zIndex = m_nLayers * (pG4Step->GetPreStepPoint()->GetPosition().z() - m_zLow) / (m_zWidth);
-    const int index(xIndex + yIndex * m_nLayers + zIndex * m_nLayers * m_nLayers);
+    const double defaultCut(m_pInputParameters->GetDefaultProductionCut() * mm);
 
-    const float deltaX(m_xWidth / m_nLayers);
-    const int xBin(std::floor((pG4Step->GetPreStepPoint()->GetPosition().x() + 0.5f * deltaX)/deltaX));
-    const float xCell(xBin * deltaX);
+    // ATTN : Protons are only used to set the recoil threshold for hadronic elastic scattering, so keep the default cut
+    G4ProductionCuts *pG4ProductionCuts = new G4ProductionCuts();
+    pG4ProductionCuts->SetProductionCut(defaultCut);
+    pG4ProductionCuts->SetProductionCut(regionParameters.m_gammaCut > 0. ? regionParameters.m_gammaCut * mm : defaultCut, "gamma");
+    pG4ProductionCuts->SetProductionCut(regionParameters.m_electronCut > 0. ? regionParameters.m_electronCut * mm : defaultCut, "e-");
+    pG4ProductionCuts->SetProductionCut(regionParameters.m_positronCut > 0. ? regionParameters.m_positronCut * mm : defaultCut, "e+");
 
-    const float deltaY(m_yWidth / m_nLayers);
-    const int yBin(std::floor((pG4Step->GetPreStepPoint()->GetPosition().y() + 0.5f * deltaY)/deltaY));
-    const float yCell(yBin * deltaY);
+    return pG4ProductionCuts;
+}
 
-    const float deltaZ(m_zWidth / m_nLayers);
-    const int zBin(std::floor((pG4Step->GetPreStepPoint()->GetPosition().z() + 0.5f * deltaZ)/deltaZ));
-    const float zCell(zBin * deltaZ);
+//------------------------------------------------------------------------------
 
-    return Cell(xCell, yCell, zCell, index);
+G4UserLimits *G4TPCDetectorConstruction::CreateUserLimits(const RegionParameters &regionParameters) const
+{
+    return new G4UserLimits(regionParameters.m_maxStep * mm, DBL_MAX, DBL_MAX, regionParameters.m_minKineticEnergy * MeV);
+}
+
+//------------------------------------------------------------------------------
+
+Cell G4TPCDetectorConstruction::GetCell(const G4Step *pG4Step) const
+{
+    // ATTN: Cell index is zero at lowest x,y,z coordinate, then builds up along x then y then z (or along a z-order curve for Morton indices)
+    const G4ThreeVector &position(pG4Step->GetPreStepPoint()->GetPosition());
+    return m_voxelGrids.front()->GetCell(position.x(), position.y(), position.z());
 }
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,138 @@
+/**
+ *  @file   src/G4TPCEMShowerModel.cc
+ *
+ *  @brief  Implementation of the geant4 parameterised electromagnetic shower fast simulation model.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "G4Electron.hh"
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4Gamma.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Positron.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+#include "G4TPCDetectorConstruction.hh"
+#include "G4TPCEMShowerModel.hh"
+#include "G4TPCSteppingAction.hh"
+
+#include "ControlFlow/InputParameters.hh"
+#include "Readout/VoxelGrid.hh"
+
+G4TPCEMShowerModel::G4TPCEMShowerModel(const G4String &name, G4Region *pG4Region, const G4TPCDetectorConstruction *pG4TPCDetectorConstruction,
+        G4TPCSteppingAction *pG4TPCSteppingAction, const InputParameters *pInputParameters) :
+    G4VFastSimulationModel(name, pG4Region),
+    m_pG4TPCDetectorConstruction(pG4TPCDetectorConstruction),
+    m_pG4TPCSteppingAction(pG4TPCSteppingAction),
+    m_minEnergy(pInputParameters->GetEMShowerMinEnergy() * MeV),
+    m_spotEnergy(pInputParameters->GetEMShowerSpotEnergy() * MeV),
+    m_radiationLength(pInputParameters->GetEMShowerRadiationLength() * mm),
+    m_moliereRadius(pInputParameters->GetEMShowerMoliereRadius() * mm),
+    m_criticalEnergy(pInputParameters->GetEMShowerCriticalEnergy() * MeV),
+    m_effectiveZ(pInputParameters->GetEMShowerEffectiveZ())
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+G4TPCEMShowerModel::~G4TPCEMShowerModel()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+G4bool G4TPCEMShowerModel::IsApplicable(const G4ParticleDefinition &particleDefinition)
+{
+    return (&particleDefinition == G4Electron::ElectronDefinition() || &particleDefinition == G4Positron::PositronDefinition() ||
+        &particleDefinition == G4Gamma::GammaDefinition());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+G4bool G4TPCEMShowerModel::ModelTrigger(const G4FastTrack &fastTrack)
+{
+    return (fastTrack.GetPrimaryTrack()->GetKineticEnergy() > m_minEnergy);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void G4TPCEMShowerModel::DoIt(const G4FastTrack &fastTrack, G4FastStep &fastStep)
+{
+    const G4Track *pG4Track(fastTrack.GetPrimaryTrack());
+    const G4ParticleDefinition *pG4ParticleDefinition(pG4Track->GetDefinition());
+    const double kineticEnergy(pG4Track->GetKineticEnergy());
+    const int trackId(pG4Track->GetTrackID());
+    const G4ThreeVector &axis(pG4Track->GetMomentumDirection());
+
+    // ATTN : A positron annihilates once the shower has slowed it down, and the annihilation photons are absorbed within the shower
+    const double energy(kineticEnergy + (pG4ParticleDefinition == G4Positron::PositronDefinition() ? 2. * CLHEP::electron_mass_c2 : 0.));
+
+    // A photon shower only starts where the photon converts, the conversion length being 9/7 of a radiation length
+    G4ThreeVector start(pG4Track->GetPosition());
+
+    if (pG4ParticleDefinition == G4Gamma::GammaDefinition())
+        start += (CLHEP::RandExponential::shoot(9. / 7.) * m_radiationLength) * axis;
+
+    // ATTN : The spots are deposited here rather than via the killing step, which the stepping action would otherwise see as a point deposit
+    fastStep.KillPrimaryTrack();
+    fastStep.ProposePrimaryTrackPathLength(0.);
+    fastStep.ProposeTotalEnergyDeposited(0.);
+
+    // Longitudinal profile, a gamma distribution in depth (radiation lengths) with the mean shower maximum depth and shape of the Grindhammer
+    // parameterisation for homogeneous media, from the conversion point for photons
+    const double logY(std::log(energy / m_criticalEnergy));
+    const double showerMaxDepth(std::max(0.1, logY - 0.858));
+    const double alpha(std::max(1.1, 0.21 + (0.492 + 2.38 / m_effectiveZ) * logY));
+    const double beta((alpha - 1.) / showerMaxDepth);
+    const double logEnergyGeV(std::log(energy / GeV));
+
+    // Transverse basis for the shower axis
+    const G4ThreeVector uAxis(axis.orthogonal().unit());
+    const G4ThreeVector vAxis(axis.cross(uAxis));
+
+    const unsigned int nSpots(std::max(1, static_cast<int>(std::ceil(energy / m_spotEnergy))));
+    const double spotEnergy(energy / nSpots);
+    const VoxelGrid &voxelGrid(m_pG4TPCDetectorConstruction->GetVoxelGrid());
+
+    for (unsigned int spot = 0; spot < nSpots; ++spot)
+    {
+        const double depth(CLHEP::RandGamma::shoot(alpha, beta));
+        const double radius(this->SampleRadius(depth / showerMaxDepth, logEnergyGeV));
+        const double phi(CLHEP::twopi * G4UniformRand());
+
+        const G4ThreeVector position(start + (depth * m_radiationLength) * axis +
+            (radius * m_moliereRadius) * (std::cos(phi) * uAxis + std::sin(phi) * vAxis));
+
+        // ATTN : Spots outside the detector are leakage, as they would be in full simulation
+        if (!voxelGrid.Contains(position.x(), position.y(), position.z()))
+            continue;
+
+        m_pG4TPCSteppingAction->AddEnergyDeposition(position, spotEnergy, trackId);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double G4TPCEMShowerModel::SampleRadius(const double tau, const double logEnergy) const
+{
+    // Two component radial profile, 2 r R^2 / (r^2 + R^2)^2, for the core and the tail, Grindhammer and Peters (hep-ex/0001020)
+    const double coreRadius(0.0251 + 0.00319 * logEnergy + (0.1162 - 0.000381 * m_effectiveZ) * tau);
+    const double tailRadius((0.659 - 0.00309 * m_effectiveZ) * (std::exp(-2.59 * (tau - 0.645)) + std::exp((0.3585 + 0.0421 * logEnergy) *
+        (tau - 0.645))));
+
+    const double p2(0.401 + 0.00187 * m_effectiveZ), p3(1.313 - 0.0686 * logEnergy);
+    const double coreProbability(std::min(1., (2.632 - 0.00094 * m_effectiveZ) * std::exp((p2 - tau) / p3 - std::exp((p2 - tau) / p3))));
+
+    // Invert the cumulative distribution, r^2 / (r^2 + R^2)
+    const double radius(G4UniformRand() < coreProbability ? coreRadius : tailRadius);
+    const double u(std::min(G4UniformRand(), 0.999999));
+
+    return radius * std::sqrt(u / (1. - u));
+}
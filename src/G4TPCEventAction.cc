@@ -28,6 +28,7 @@
 /// \file G4TPCEventAction.cc
 /// \brief Implementation of the G4TPCEventAction class
 
+#include "G4TPCDetectorConstruction.hh"
 #include "G4TPCEventAction.hh"
 #include "G4TPCRunAction.hh"
 
@@ -40,10 +41,12 @@
 
 //------------------------------------------------------------------------------
 
-G4TPCEventAction::G4TPCEventAction(EventContainer *pEventContainer, G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction) :
+G4TPCEventAction::G4TPCEventAction(EventContainer *pEventContainer, G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction,
+        const G4TPCDetectorConstruction *pG4TPCDetectorConstruction) :
     G4UserEventAction(),
     m_pEventContainer(pEventContainer),
-    m_pG4TPCMCParticleUserAction(pG4TPCMCParticleUserAction)
+    m_pG4TPCMCParticleUserAction(pG4TPCMCParticleUserAction),
+    m_pG4TPCDetectorConstruction(pG4TPCDetectorConstruction)
 {
 }
 
@@ -66,6 +69,20 @@ void G4TPCEventAction::BeginOfEventAction(const G4Event *pG4Event)
 void G4TPCEventAction::EndOfEventAction(const G4Event *pG4Event)
 {
     m_pG4TPCMCParticleUserAction->EndOfEventAction(pG4Event);
+
+    if (pG4Event->IsAborted())
+        m_pEventContainer->SetCurrentEventAborted();
+
+    for (unsigned int gridIndex = 0; gridIndex < m_pG4TPCDetectorConstruction->GetNVoxelGrids(); gridIndex++)
+        m_pEventContainer->ReduceDeposits(m_pG4TPCDetectorConstruction->GetVoxelGrid(gridIndex), gridIndex);
+
+    // ATTN : Reducers run once the cells are complete, before the event container writes out or deletes the event
+    for (EventReducer *pEventReducer : m_pEventContainer->GetEventReducers())
+    {
+        pEventReducer->ProcessEvent(m_pEventContainer->GetEventNumber(), m_pEventContainer->GetCurrentCellList(),
+            m_pEventContainer->GetCurrentMCParticleList());
+    }
+
     m_pEventContainer->EndOfEventAction();
 }
 
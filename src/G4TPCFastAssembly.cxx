@@ -0,0 +1,226 @@
+/**
+ *  @file   src/G4TPCFastAssembly.cxx
+ *
+ *  @brief  Assemble approximate events from genie input without tracking, replacing each final state particle with a single particle response
+ *          sampled from a library built by G4TPCShowerLibraryBuilder, and optionally compare them with a full simulation of the same events.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "Analysis/OutputComparison.hh"
+#include "ControlFlow/InputParameters.hh"
+#include "Objects/Cell.hh"
+#include "Objects/GenieEvent.hh"
+#include "Objects/MCParticle.hh"
+#include "Persistency/EventContainer.hh"
+#include "Persistency/ShowerLibrary.hh"
+#include "Readout/DepositBuffer.hh"
+#include "Readout/VoxelGrid.hh"
+#include "Xml/tinyxml.hh"
+
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+void PrintUsage()
+{
+    std::cout << " Usage: " << std::endl;
+    std::cout << " G4TPCFastAssembly ConfigFile.xml ResponseLibrary.bin [FullSimulationOutput.xml]" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Add a single particle response, sampled from the library, for a particle starting at a position and travelling along an axis
+ *
+ *  @return whether the library has responses for the particle
+ */
+bool AddResponse(const ShowerLibraryReader &showerLibraryReader, const int pdg, const double kineticEnergy, const G4ThreeVector &start,
+    const G4ThreeVector &axis, const int trackId, const VoxelGrid &voxelGrid, std::mt19937_64 &generator, DepositBuffer &depositBuffer)
+{
+    const ShowerLibrary::Bin *pBin(showerLibraryReader.FindBin(pdg, kineticEnergy / MeV));
+
+    if (!pBin)
+        return false;
+
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    const ShowerLibrary::Shower &shower(showerLibraryReader.GetShower(*pBin, uniform(generator)));
+    const ShowerLibrary::Spot *pSpots(showerLibraryReader.GetSpots(shower));
+
+    // Library responses travel along +z, so turn them about their axis by a random angle then onto the particle direction, as
+    // G4TPCShowerLibraryModel does
+    const double phi(CLHEP::twopi * uniform(generator));
+    const double cosPhi(std::cos(phi)), sinPhi(std::sin(phi));
+
+    for (std::uint32_t spot = 0; spot < shower.m_nSpots; ++spot)
+    {
+        const ShowerLibrary::Spot &librarySpot(pSpots[spot]);
+        G4ThreeVector offset(librarySpot.m_x * cosPhi - librarySpot.m_y * sinPhi, librarySpot.m_x * sinPhi + librarySpot.m_y * cosPhi, librarySpot.m_z);
+        offset.rotateUz(axis);
+
+        const G4ThreeVector position(start + offset * mm);
+
+        if (!voxelGrid.Contains(position.x(), position.y(), position.z()))
+            continue;
+
+        depositBuffer.Add(position.x(), position.y(), position.z(), librarySpot.m_energyFraction * kineticEnergy, trackId);
+    }
+
+    return true;
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc != 3 && argc != 4)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    const InputParameters inputParameters(argv[1]);
+
+    if (!inputParameters.Valid() || !inputParameters.GetUseGenieInput())
+    {
+        std::cout << "Fast assembly requires a valid configuration with genie input" << std::endl;
+        PrintUsage();
+        return 1;
+    }
+
+    const ShowerLibraryReader showerLibraryReader(argv[2]);
+
+    if (!showerLibraryReader.IsValid())
+        return 1;
+
+    // Profiles in 2 cm bins out to 2 m, along and from the axis of the leading final state particle
+    const OutputComparison outputComparison(100, 20.);
+    OutputComparison::EventSummaryMap fullSummaries;
+
+    if (argc == 4 && !outputComparison.ReadOutput(argv[3], fullSummaries))
+        return 1;
+
+    // ATTN : Only the particle definitions are needed, for the masses of the genie final state particles, so no physics list is built
+    GenieEvent::ConstructParticleDefinitions();
+
+    const VoxelGrid voxelGrid(inputParameters.GetCenterX() - 0.5 * inputParameters.GetWidthX(), inputParameters.GetCenterY() - 0.5 * inputParameters.GetWidthY(),
+        inputParameters.GetCenterZ() - 0.5 * inputParameters.GetWidthZ(), inputParameters.GetWidthX(), inputParameters.GetWidthY(), inputParameters.GetWidthZ(),
+        inputParameters.GetNBinsX(), inputParameters.GetNBinsY(), inputParameters.GetNBinsZ(),
+        inputParameters.GetUseMortonCellIndex() ? VoxelGrid::MORTON : VoxelGrid::LINEAR);
+
+    const GenieEvents genieEvents(inputParameters.GetGenieEvents());
+    const unsigned int nEvents(std::min(inputParameters.GetGenieNEvents(), inputParameters.GetMaxNEventsToProcess()));
+
+    TiXmlDocument tiXmlDocument;
+    TiXmlElement *pRunTiXmlElement = new TiXmlElement("Run");
+    tiXmlDocument.LinkEndChild(pRunTiXmlElement);
+
+    DepositBuffer depositBuffer;
+    OutputComparison::EventSummaryMap fastSummaries;
+    unsigned int nMissingTracks(0);
+    double missingEnergy(0.);
+
+    for (unsigned int eventNumber = 0; eventNumber < nEvents; eventNumber++)
+    {
+        const GenieEvent &genieEvent(genieEvents.at(eventNumber));
+        const G4ThreeVector vertex(genieEvent.GetVertexX(), genieEvent.GetVertexY(), genieEvent.GetVertexZ());
+
+        // ATTN : Each event has a generator seeded from its event number, so an event is assembled the same way whichever events are run
+        std::seed_seq seedSequence{eventNumber};
+        std::mt19937_64 generator(seedSequence);
+
+        TiXmlElement *pEventTiXmlElement = new TiXmlElement("Event");
+        pEventTiXmlElement->SetAttribute("Number", eventNumber);
+        pEventTiXmlElement->SetAttribute("GenieIndex", genieEvent.GetSourceIndex());
+        pRunTiXmlElement->LinkEndChild(pEventTiXmlElement);
+
+        depositBuffer.Clear();
+        CellList cellList;
+        MCParticleList mcParticleList;
+        int trackId(0);
+
+        for (const GenieEvent::Track *pTrack : genieEvent.GetDaughterTracks())
+        {
+            const int pdg(pTrack->GetPDG());
+            const G4ParticleDefinition *pG4ParticleDefinition(G4ParticleTable::GetParticleTable()->FindParticle(pdg));
+
+            // ATTN : Track ids count from 1 in the order of the genie tracks, as geant4 numbers the primaries, so the cell MC attribution
+            //        matches the full simulation
+            trackId++;
+
+            // Neutrinos leave nothing in the detector
+            if (std::abs(pdg) == 12 || std::abs(pdg) == 14 || std::abs(pdg) == 16)
+                continue;
+
+            const double mass(pG4ParticleDefinition ? pG4ParticleDefinition->GetPDGMass() / GeV : 0.);
+            const double kineticEnergy((pTrack->GetEnergy() - mass) * GeV);
+            const G4ThreeVector direction(G4ThreeVector(pTrack->GetDirectionX(), pTrack->GetDirectionY(), pTrack->GetDirectionZ()).unit());
+
+            if (!pG4ParticleDefinition || !AddResponse(showerLibraryReader, pdg, kineticEnergy, vertex, direction, trackId, voxelGrid, generator,
+                depositBuffer))
+            {
+                nMissingTracks++;
+                missingEnergy += kineticEnergy;
+                continue;
+            }
+
+            mcParticleList.Add(new MCParticle(trackId, pdg, 0, mass));
+
+            const double momentum(std::sqrt(std::max(0., pTrack->GetEnergy() * pTrack->GetEnergy() - mass * mass)));
+            TiXmlElement *pTiXmlElement = new TiXmlElement("MCParticle");
+            pTiXmlElement->SetAttribute("Id", trackId);
+            pTiXmlElement->SetAttribute("PDG", pdg);
+            pTiXmlElement->SetAttribute("ParentId", 0);
+            pTiXmlElement->SetDoubleAttribute("Mass", mass);
+            pTiXmlElement->SetDoubleAttribute("Energy", pTrack->GetEnergy());
+            pTiXmlElement->SetDoubleAttribute("StartX", vertex.x());
+            pTiXmlElement->SetDoubleAttribute("StartY", vertex.y());
+            pTiXmlElement->SetDoubleAttribute("StartZ", vertex.z());
+            pTiXmlElement->SetDoubleAttribute("MomentumX", momentum * direction.x());
+            pTiXmlElement->SetDoubleAttribute("MomentumY", momentum * direction.y());
+            pTiXmlElement->SetDoubleAttribute("MomentumZ", momentum * direction.z());
+            pEventTiXmlElement->LinkEndChild(pTiXmlElement);
+        }
+
+        depositBuffer.Reduce(voxelGrid, cellList);
+        EventContainer::WriteCellsXml(cellList, mcParticleList, pEventTiXmlElement);
+        fastSummaries[eventNumber] = outputComparison.Summarise(pEventTiXmlElement);
+
+        for (const auto iter : cellList.m_idCellMap)
+            delete iter.second;
+
+        for (const auto iter : mcParticleList.m_mcParticles)
+            delete iter.second;
+    }
+
+    tiXmlDocument.SaveFile(inputParameters.GetOutputXmlFileName());
+    std::cout << "Assembled " << nEvents << " events into " << inputParameters.GetOutputXmlFileName() << std::endl;
+
+    if (nMissingTracks > 0)
+    {
+        std::cout << nMissingTracks << " particles, with " << missingEnergy / GeV << " GeV of kinetic energy, have no library response and were dropped"
+                  << std::endl;
+    }
+
+    if (argc == 4)
+        outputComparison.Compare(fastSummaries, fullSummaries, "Fast", "Full");
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
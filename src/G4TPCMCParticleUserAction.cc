@@ -12,6 +12,10 @@
 #include "G4Step.hh"
 #include "G4TPCMCParticleUserAction.hh"
 
+#include "ControlFlow/EventCostReport.hh"
+#include "ControlFlow/Logger.hh"
+#include "ControlFlow/StepProfiler.hh"
+
 G4TPCMCParticleUserAction::G4TPCMCParticleUserAction(EventContainer *pEventContainer, const InputParameters *pInputParameters) :
     m_pEventContainer(pEventContainer),
     m_pInputParameters(pInputParameters),
@@ -20,6 +24,13 @@ G4TPCMCParticleUserAction::G4TPCMCParticleUserAction(EventContainer *pEventConta
     m_currentPdgCode(0),
     m_currentTrackId(std::numeric_limits<int>::max())
 {
+    // ATTN : Events replayed in detail keep every MC particle.  The MC particle selection draws no random numbers, so the replayed event
+    //        is the same event as the one first simulated.
+    if (pInputParameters->GetUseReplay() && pInputParameters->GetReplayDetailedTrajectories())
+    {
+        m_keepEMShowerDaughters = true;
+        m_energyCut = 0.;
+    }
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
@@ -125,6 +136,12 @@ bool G4TPCMCParticleUserAction::KnownParticle(const int trackId) const
 
 void G4TPCMCParticleUserAction::PreUserTrackingAction(const G4Track *pG4Track)
 {
+    if (m_pEventContainer->GetEventCostReport())
+        m_pEventContainer->GetEventCostReport()->AddTrack();
+
+    if (m_pEventContainer->GetStepProfiler())
+        m_pEventContainer->GetStepProfiler()->BeginOfTrack(pG4Track);
+
     G4ParticleDefinition *pG4ParticleDefinition = pG4Track->GetDefinition();
     const int pdgCode(pG4ParticleDefinition->GetPDGEncoding());
     const int trackID(pG4Track->GetTrackID());
@@ -169,6 +186,7 @@ void G4TPCMCParticleUserAction::PreUserTrackingAction(const G4Track *pG4Track)
         {
             m_currentMCParticleInfo.Clear();
             m_trackIdParentMap[trackID] = parentTrackId;
+            return;
         }
 
         if (!this->KnownParticle(parentTrackId))
@@ -178,7 +196,7 @@ void G4TPCMCParticleUserAction::PreUserTrackingAction(const G4Track *pG4Track)
 
             if (!this->KnownParticle(pid))
             {
-                std::cout << "Unknown parent" << std::endl;
+                Logger::Write(Logger::WARNING, "Unknown parent");
             }
             else
             {
@@ -200,6 +218,8 @@ void G4TPCMCParticleUserAction::PreUserTrackingAction(const G4Track *pG4Track)
 
 void G4TPCMCParticleUserAction::PostUserTrackingAction(const G4Track * /*pG4Track*/)
 {
+    if (m_pEventContainer->GetStepProfiler())
+        m_pEventContainer->GetStepProfiler()->EndOfTrack();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
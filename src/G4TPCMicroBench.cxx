@@ -0,0 +1,350 @@
+/**
+ *  @file   src/G4TPCMicroBench.cxx
+ *
+ *  @brief  Micro-benchmarks of the readout, persistency and input parsing hot paths, run without geant4 tracking.  Reports the time and
+ *          number of heap allocations per operation.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+
+#include "ControlFlow/InputParameters.hh"
+#include "Objects/Cell.hh"
+#include "Objects/MCParticle.hh"
+#include "Persistency/DepositArchive.hh"
+#include "Persistency/EventContainer.hh"
+#include "Readout/DepositBuffer.hh"
+#include "Readout/VoxelGrid.hh"
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+std::size_t g_nAllocations(0);   ///< Number of calls to the global operator new
+
+}
+
+//------------------------------------------------------------------------------
+
+// ATTN : Replacing the global allocation functions counts every heap allocation made by the benchmarked code, including the standard library
+void *operator new(std::size_t size)
+{
+    ++g_nAllocations;
+
+    if (void *pMemory = std::malloc(size ? size : 1))
+        return pMemory;
+
+    throw std::bad_alloc();
+}
+
+//------------------------------------------------------------------------------
+
+void operator delete(void *pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+//------------------------------------------------------------------------------
+
+void operator delete(void *pMemory, std::size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+const char *const CONFIG_FILE_NAME("MicroBench_Config.xml");
+const char *const GENIE_FILE_NAME("MicroBench_Genie.txt");
+const char *const OUTPUT_FILE_NAME("MicroBench_Output.xml");
+
+void PrintUsage()
+{
+    std::cout << " Usage: " << std::endl;
+    std::cout << " G4TPCMicroBench [DepositArchive.bin]" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Time a benchmark and print its time and allocations per operation
+ *
+ *  @param  name of the benchmark
+ *  @param  nOperations number of operations performed by the benchmark
+ *  @param  benchmark the benchmark
+ */
+template <typename T>
+void Run(const std::string &name, const std::size_t nOperations, const T &benchmark)
+{
+    const std::size_t nAllocations(g_nAllocations);
+    const Clock::time_point start(Clock::now());
+    benchmark();
+    const double nanoseconds(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    const double nOps(std::max<std::size_t>(nOperations, 1));
+
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(12) << nOperations << std::setw(14) << std::fixed
+              << std::setprecision(1) << nanoseconds / nOps << std::setw(14) << std::setprecision(3) << (g_nAllocations - nAllocations) / nOps
+              << std::defaultfloat << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Fill a deposit stream with straight tracks of short steps through the detector, as a muon or electron leaves in the liquid argon
+ *
+ *  @param  nTracks number of tracks
+ *  @param  nStepsPerTrack number of steps per track
+ *  @param  depositBuffer to receive the deposits
+ */
+void FillSyntheticDeposits(const unsigned int nTracks, const unsigned int nStepsPerTrack, DepositBuffer &depositBuffer)
+{
+    std::mt19937 generator(12345);
+    std::uniform_real_distribution<float> position(-400.f, 400.f), direction(-1.f, 1.f);
+    std::exponential_distribution<float> energy(5.f);
+
+    for (unsigned int track = 0; track < nTracks; ++track)
+    {
+        float x(position(generator)), y(position(generator)), z(position(generator));
+        float dx(direction(generator)), dy(direction(generator)), dz(direction(generator));
+        const float norm(std::sqrt(dx * dx + dy * dy + dz * dz) / 0.3f);
+        dx /= norm; dy /= norm; dz /= norm;
+
+        for (unsigned int step = 0; step < nStepsPerTrack; ++step)
+        {
+            depositBuffer.Add(x, y, z, x + dx, y + dy, z + dz, energy(generator), track + 1);
+            x += dx; y += dy; z += dz;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Delete the cells owned by a cell list
+ *
+ *  @param  cellList the cell list
+ */
+void DeleteCells(CellList &cellList)
+{
+    for (const auto &iter : cellList.m_idCellMap)
+        delete iter.second;
+
+    cellList.m_idCellMap.clear();
+    cellList.m_mcComponents.clear();
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Write a configuration reading a synthetic genie tracker file, and the tracker file itself
+ *
+ *  @param  nEvents number of genie events
+ */
+void WriteGenieInput(const unsigned int nEvents)
+{
+    std::ofstream configFile(CONFIG_FILE_NAME);
+    configFile << "<G4TPC>\n    <Output3DXmlFileName>" << OUTPUT_FILE_NAME << "</Output3DXmlFileName>\n"
+               << "    <GenieInput>\n        <Use>true</Use>\n        <TrackerFile>" << GENIE_FILE_NAME << "</TrackerFile>\n    </GenieInput>\n"
+               << "</G4TPC>\n";
+
+    std::ofstream genieFile(GENIE_FILE_NAME);
+
+    for (unsigned int event = 0; event < nEvents; ++event)
+    {
+        genieFile << "$ begin\n$ nuance 1\n$ vertex 10.5 -20.25 -200 0\n$ track 14 2000 0 0 1 -1\n$ track 18040 37215.5 0 0 1 -1\n"
+                  << "$ track 13 1650.3 0.099381 0.04969 0.993808 0\n$ track 2212 1250.2 -0.282216 0.188144 0.940721 0\n"
+                  << "$ track 211 620.2 -0.4 0.2 0.894427 0\n$ end\n";
+    }
+
+    genieFile << "$ stop\n";
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    // Deposit stream, recorded or synthetic
+    DepositBuffer depositBuffer;
+
+    if (argc == 2)
+    {
+        DepositArchiveReader depositArchiveReader(argv[1]);
+
+        if (!depositArchiveReader.IsValid())
+        {
+            std::cout << "Unable to read deposit archive " << argv[1] << std::endl;
+            return 1;
+        }
+
+        DepositBuffer eventDepositBuffer;
+        int eventNumber(0);
+        IntIntMap trackIdParentMap;
+        IntVector knownParticles;
+
+        for (unsigned int index = 0; index < depositArchiveReader.GetNEvents(); ++index)
+        {
+            if (!depositArchiveReader.ReadEvent(index, eventNumber, eventDepositBuffer, trackIdParentMap, knownParticles))
+                return 1;
+
+            for (std::size_t deposit = 0; deposit < eventDepositBuffer.Size(); ++deposit)
+            {
+                depositBuffer.Add(eventDepositBuffer.GetX()[deposit], eventDepositBuffer.GetY()[deposit], eventDepositBuffer.GetZ()[deposit],
+                    eventDepositBuffer.GetPostX()[deposit], eventDepositBuffer.GetPostY()[deposit], eventDepositBuffer.GetPostZ()[deposit],
+                    eventDepositBuffer.GetEnergy()[deposit], eventDepositBuffer.GetTrackId()[deposit]);
+            }
+        }
+    }
+    else
+    {
+        FillSyntheticDeposits(100, 2000, depositBuffer);
+    }
+
+    const std::size_t nDeposits(depositBuffer.Size());
+    const VoxelGrid voxelGrid(-500., -500., -500., 1000., 1000., 1000., 1000, 1000, 1000);
+
+    std::cout << std::left << std::setw(40) << "Benchmark" << std::right << std::setw(12) << "Operations" << std::setw(14) << "ns/op"
+              << std::setw(14) << "allocs/op" << std::endl;
+
+    // Readout
+    Run("VoxelGrid::GetCell", nDeposits, [&]()
+    {
+        CellIndex sum(0);
+
+        for (std::size_t deposit = 0; deposit < nDeposits; ++deposit)
+            sum += voxelGrid.GetCell(depositBuffer.GetX()[deposit], depositBuffer.GetY()[deposit], depositBuffer.GetZ()[deposit]).GetIdx();
+
+        volatile CellIndex result(sum);
+        (void) result;
+    });
+
+    CellList cellList;
+    Run("CellList::AddEnergyDeposition", nDeposits, [&]()
+    {
+        // ATTN : Matches the step by step filling in G4TPCSteppingAction, the cell list deletes cells it only takes the energy of
+        for (std::size_t deposit = 0; deposit < nDeposits; ++deposit)
+        {
+            Cell *pCell = new Cell(voxelGrid.GetCell(depositBuffer.GetX()[deposit], depositBuffer.GetY()[deposit], depositBuffer.GetZ()[deposit]));
+            pCell->AddEnergy(depositBuffer.GetEnergy()[deposit]);
+            cellList.AddEnergyDeposition(pCell, depositBuffer.GetTrackId()[deposit]);
+        }
+    });
+    const std::size_t nCells(cellList.m_idCellMap.size());
+    DeleteCells(cellList);
+
+    Run("DepositBuffer::Reduce", nDeposits, [&]()
+    {
+        depositBuffer.Reduce(voxelGrid, cellList);
+    });
+    DeleteCells(cellList);
+
+    // MC particles
+    const unsigned int nMCParticles(10000);
+    MCParticleList mcParticleList;
+
+    for (unsigned int trackId = 1; trackId <= nMCParticles; ++trackId)
+    {
+        // ATTN : Keep every other track, as the MC particle user action drops most shower daughters
+        MCParticle *pMCParticle = new MCParticle(2 * trackId, 11, 2 * trackId - 2, 0.000511);
+        pMCParticle->AddTrajectoryPoint(G4LorentzVector(0., 0., 0., 0.), G4LorentzVector(0., 0., 0.01, 0.01));
+        pMCParticle->AddTrajectoryPoint(G4LorentzVector(1., 1., 1., 1.), G4LorentzVector(0., 0., 0.005, 0.005));
+        mcParticleList.Add(pMCParticle);
+    }
+
+    Run("MCParticleList::KnownParticle", 2 * nMCParticles, [&]()
+    {
+        unsigned int nKnown(0);
+
+        for (unsigned int trackId = 1; trackId <= 2 * nMCParticles; ++trackId)
+            nKnown += mcParticleList.KnownParticle(trackId);
+
+        volatile unsigned int result(nKnown);
+        (void) result;
+    });
+
+    // Input parsing
+    const unsigned int nGenieEvents(2000);
+    WriteGenieInput(nGenieEvents);
+
+    StringVector lines;
+    {
+        std::ifstream genieFile(GENIE_FILE_NAME);
+        std::string line;
+
+        while (std::getline(genieFile, line))
+            lines.push_back(line);
+    }
+
+    Run("InputParameters::TokeniseLine", lines.size(), [&]()
+    {
+        std::size_t nTokens(0);
+
+        for (const std::string &line : lines)
+            nTokens += InputParameters::TokeniseLine(line, " $").size();
+
+        volatile std::size_t result(nTokens);
+        (void) result;
+    });
+
+    // ATTN : Loading the configuration loads the genie events with it, so the time is per genie event
+    Run("InputParameters::LoadGenieEvents", nGenieEvents, [&]()
+    {
+        const InputParameters inputParameters(CONFIG_FILE_NAME);
+        volatile int result(inputParameters.GetGenieNEvents());
+        (void) result;
+    });
+
+    // Output
+    const InputParameters inputParameters(CONFIG_FILE_NAME);
+    const unsigned int nEvents(10);
+    EventContainer eventContainer(&inputParameters);
+
+    for (unsigned int event = 0; event < nEvents; ++event)
+    {
+        eventContainer.BeginOfEventAction();
+        depositBuffer.Reduce(voxelGrid, eventContainer.GetCurrentCellList());
+
+        MCParticleList eventMCParticleList;
+
+        for (const auto &iter : mcParticleList.m_mcParticles)
+            eventMCParticleList.Add(new MCParticle(*iter.second));
+
+        eventContainer.SetCurrentMCParticleList(eventMCParticleList);
+        eventContainer.EndOfEventAction();
+    }
+
+    Run("EventContainer::SaveXml (per cell)", nEvents * nCells, [&]()
+    {
+        eventContainer.SaveXml();
+    });
+
+    std::remove(CONFIG_FILE_NAME);
+    std::remove(GENIE_FILE_NAME);
+    std::remove(OUTPUT_FILE_NAME);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
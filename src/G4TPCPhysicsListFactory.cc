@@ -0,0 +1,180 @@
+/**
+ *  @file   src/G4TPCPhysicsListFactory.cc
+ *
+ *  @brief  Implementation of the geant4 physics list factory class.
+ *
+ *  $Log: $
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "G4FastSimulationPhysics.hh"
+#include "G4PhysListFactory.hh"
+#include "G4StepLimiterPhysics.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VModularPhysicsList.hh"
+#include "G4Version.hh"
+
+#include "G4TPCPhysicsListFactory.hh"
+
+#include "ControlFlow/InputParameters.hh"
+
+G4VModularPhysicsList *G4TPCPhysicsListFactory::Create(const InputParameters &inputParameters)
+{
+    // ATTN : The factory understands EM option suffixes, e.g. FTFP_BERT_EMV selects G4EmStandardPhysics_option1
+    G4PhysListFactory physListFactory;
+    const std::string physicsListName(inputParameters.GetPhysicsListName());
+
+    if (!physListFactory.IsReferencePhysList(physicsListName))
+    {
+        std::cout << "Unknown physics list : " << physicsListName << G4endl;
+        return nullptr;
+    }
+
+    G4VModularPhysicsList *pG4VModularPhysicsList = physListFactory.GetReferencePhysList(physicsListName);
+
+    for (const std::string &physicsName : inputParameters.GetPhysicsToRemove())
+        pG4VModularPhysicsList->RemovePhysics(physicsName);
+
+    pG4VModularPhysicsList->RegisterPhysics(new G4StepLimiterPhysics());
+
+    if (inputParameters.GetUseEMShowerParameterisation() || inputParameters.GetUseShowerLibrary())
+    {
+        G4FastSimulationPhysics *pG4FastSimulationPhysics = new G4FastSimulationPhysics();
+        pG4FastSimulationPhysics->ActivateFastSimulation("e-");
+        pG4FastSimulationPhysics->ActivateFastSimulation("e+");
+        pG4FastSimulationPhysics->ActivateFastSimulation("gamma");
+        pG4VModularPhysicsList->RegisterPhysics(pG4FastSimulationPhysics);
+    }
+
+    pG4VModularPhysicsList->SetDefaultCutValue(inputParameters.GetDefaultProductionCut() * mm);
+
+    // ATTN : The world cuts apply to the default region, the absorber region sets its own cuts in the detector construction
+    const RegionParameters &worldRegion(inputParameters.GetWorldRegion());
+
+    if (worldRegion.m_gammaCut > 0.)
+        pG4VModularPhysicsList->SetCutValue(worldRegion.m_gammaCut * mm, "gamma");
+
+    if (worldRegion.m_electronCut > 0.)
+        pG4VModularPhysicsList->SetCutValue(worldRegion.m_electronCut * mm, "e-");
+
+    if (worldRegion.m_positronCut > 0.)
+        pG4VModularPhysicsList->SetCutValue(worldRegion.m_positronCut * mm, "e+");
+
+    // ATTN : Geant4 falls back to building any table it cannot retrieve, but only complete cache directories are used, as a job storing
+    // tables concurrently would otherwise be read part way through
+    if (inputParameters.GetUsePhysicsTableCache())
+    {
+        const std::string directory(G4TPCPhysicsListFactory::GetPhysicsTableDirectory(inputParameters));
+
+        if (G4TPCPhysicsListFactory::IsComplete(directory))
+        {
+            std::cout << "Retrieving physics tables from " << directory << G4endl;
+            pG4VModularPhysicsList->SetPhysicsTableRetrieved(directory);
+        }
+    }
+
+    return pG4VModularPhysicsList;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void G4TPCPhysicsListFactory::StorePhysicsTables(const InputParameters &inputParameters, G4VModularPhysicsList *pG4VModularPhysicsList)
+{
+    if (!inputParameters.GetUsePhysicsTableCache())
+        return;
+
+    const std::string directory(G4TPCPhysicsListFactory::GetPhysicsTableDirectory(inputParameters));
+
+    if (G4TPCPhysicsListFactory::IsComplete(directory))
+        return;
+
+    // ATTN : Tables are stored in a directory private to this job and renamed into place once complete, so concurrent jobs on a node never
+    // see a partial set of tables and the first job to finish wins
+    mkdir(inputParameters.GetPhysicsTableCacheDirectory().c_str(), 0755);
+    const std::string jobDirectory(directory + ".tmp." + std::to_string(getpid()));
+
+    if (mkdir(jobDirectory.c_str(), 0755) != 0)
+    {
+        std::cout << "Unable to create physics table directory " << jobDirectory << G4endl;
+        return;
+    }
+
+    if (!pG4VModularPhysicsList->StorePhysicsTable(jobDirectory))
+    {
+        std::cout << "Unable to store physics tables in " << jobDirectory << G4endl;
+        G4TPCPhysicsListFactory::RemoveDirectory(jobDirectory);
+        return;
+    }
+
+    std::ofstream completeFile(jobDirectory + "/Complete");
+    completeFile << G4VERSION_TAG << std::endl;
+    completeFile.close();
+
+    if (std::rename(jobDirectory.c_str(), directory.c_str()) != 0)
+    {
+        G4TPCPhysicsListFactory::RemoveDirectory(jobDirectory);
+        return;
+    }
+
+    std::cout << "Stored physics tables in " << directory << G4endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string G4TPCPhysicsListFactory::GetPhysicsTableDirectory(const InputParameters &inputParameters)
+{
+    // ATTN : The materials are fixed by the detector construction, so the tables depend only on the geant4 version, the physics and the cuts
+    std::ostringstream key;
+    key << G4VERSION_TAG << ";" << inputParameters.GetPhysicsListName() << ";";
+
+    for (const std::string &physicsName : inputParameters.GetPhysicsToRemove())
+        key << "-" << physicsName << ";";
+
+    key << (inputParameters.GetUseEMShowerParameterisation() || inputParameters.GetUseShowerLibrary()) << ";"
+        << inputParameters.GetDefaultProductionCut() << ";";
+
+    for (const RegionParameters *pRegionParameters : {&inputParameters.GetWorldRegion(), &inputParameters.GetAbsorberRegion()})
+        key << pRegionParameters->m_gammaCut << "," << pRegionParameters->m_electronCut << "," << pRegionParameters->m_positronCut << ";";
+
+    std::ostringstream directory;
+    directory << inputParameters.GetPhysicsTableCacheDirectory() << "/" << inputParameters.GetPhysicsListName() << "_" << std::hex
+              << std::hash<std::string>()(key.str());
+
+    return directory.str();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool G4TPCPhysicsListFactory::IsComplete(const std::string &directory)
+{
+    struct stat fileStatus;
+    return (stat((directory + "/Complete").c_str(), &fileStatus) == 0);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void G4TPCPhysicsListFactory::RemoveDirectory(const std::string &directory)
+{
+    if (DIR *pDirectory = opendir(directory.c_str()))
+    {
+        while (const dirent *pEntry = readdir(pDirectory))
+        {
+            const std::string name(pEntry->d_name);
+
+            if (name != "." && name != "..")
+                std::remove((directory + "/" + name).c_str());
+        }
+
+        closedir(pDirectory);
+    }
+
+    rmdir(directory.c_str());
+}
@@ -45,7 +45,10 @@
 
 #include "G4TPCPrimaryGeneratorAction.hh"
 
-G4TPCPrimaryGeneratorAction::G4TPCPrimaryGeneratorAction(const EventContainer *pEventContainer, const InputParameters *pInputParameters) :
+#include "ControlFlow/Logger.hh"
+#include "Persistency/RandomSnapshot.hh"
+
+G4TPCPrimaryGeneratorAction::G4TPCPrimaryGeneratorAction(EventContainer *pEventContainer, const InputParameters *pInputParameters) :
     G4VUserPrimaryGeneratorAction(),
     m_pG4ParticleGun(nullptr),
     m_pInputParameters(pInputParameters),
@@ -66,7 +69,8 @@ G4TPCPrimaryGeneratorAction::~G4TPCPrimaryGeneratorAction()
 
 void G4TPCPrimaryGeneratorAction::GeneratePrimaries(G4Event *pG4Event)
 {
-    std::cout << "Event Number : " << m_pEventContainer->GetEventNumber() << std::endl;
+    if (Logger::IsEnabled(Logger::DEBUG))
+        Logger::Write(Logger::DEBUG, "Event Number : " + std::to_string(m_pEventContainer->GetEventNumber()));
 
     G4LogicalVolume *worlLV = G4LogicalVolumeStore::GetInstance()->GetVolume("World");
     G4LogicalVolume *tpcLV = G4LogicalVolumeStore::GetInstance()->GetVolume("Calorimeter");
@@ -86,8 +90,31 @@ void G4TPCPrimaryGeneratorAction::GeneratePrimaries(G4Event *pG4Event)
         G4Exception("G4TPCPrimaryGeneratorAction::GeneratePrimaries()", "MyCode0002", EventMustBeAborted, msg);
     }
 
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    CLHEP::HepRandom::setTheSeed(seed);
+    // ATTN : Each event is seeded on its own so that any one event can be replayed from its seed
+    long seed(0);
+    const RandomSnapshotReader *pRandomSnapshotReader(m_pEventContainer->GetRandomSnapshotReader());
+
+    if (pRandomSnapshotReader)
+    {
+        // ATTN : A replayed event starts from the engine status recorded when it was first simulated, however that job was seeded
+        if (!pRandomSnapshotReader->RestoreEngineStatus(m_pEventContainer->GetEventNumber(), seed))
+        {
+            G4ExceptionDescription msg;
+            msg << "Unable to restore the random engine status for event " << m_pEventContainer->GetEventNumber() << G4endl;
+            G4Exception("G4TPCPrimaryGeneratorAction::GeneratePrimaries()", "MyCode0003", FatalException, msg);
+        }
+    }
+    else
+    {
+        seed = m_pInputParameters->GetRandomSeed() >= 0 ? GetEventSeed(m_pInputParameters->GetRandomSeed(), m_pEventContainer->GetEventNumber()) :
+            static_cast<long>(MixBits(std::chrono::system_clock::now().time_since_epoch().count()));
+        G4TPCPrimaryGeneratorAction::SetEngineSeeds(seed);
+    }
+
+    m_pEventContainer->SetCurrentSeed(seed);
+
+    if (m_pEventContainer->GetRandomSnapshotWriter())
+        m_pEventContainer->GetRandomSnapshotWriter()->WriteEvent(m_pEventContainer->GetEventNumber(), seed);
 
     if (m_pInputParameters->GetUseParticleGun())
     {
@@ -137,3 +164,33 @@ void G4TPCPrimaryGeneratorAction::LoadNextGenieEvent(G4Event *pG4Event)
         m_pG4ParticleGun->GeneratePrimaryVertex(pG4Event);
     }
 }
+
+//------------------------------------------------------------------------------
+
+long G4TPCPrimaryGeneratorAction::GetEventSeed(const long randomSeed, const int eventNumber)
+{
+    // ATTN : Hashing, rather than adding, the event number keeps the events of jobs with neighbouring seeds apart
+    return static_cast<long>(MixBits(MixBits(static_cast<std::uint64_t>(randomSeed)) + static_cast<std::uint64_t>(eventNumber)));
+}
+
+//------------------------------------------------------------------------------
+
+void G4TPCPrimaryGeneratorAction::SetEngineSeeds(const long seed)
+{
+    // ATTN : A single seed only selects one of the 215 rows of the ranecu seed table, so events would repeat every 215 seeds.  Both ranecu
+    //        seeds are set instead, each from 32 bits of the hashed event seed, non zero and within the ranges of the two generators.  The
+    //        seed list is zero terminated, as engines taking a variable number of seeds expect.
+    const std::uint64_t bits(MixBits(static_cast<std::uint64_t>(seed)));
+    const long seeds[3] = {static_cast<long>(1 + (bits & 0xffffffffULL) % 2147483562ULL), static_cast<long>(1 + (bits >> 32) % 2147483398ULL), 0};
+    CLHEP::HepRandom::setTheSeeds(seeds);
+}
+
+//------------------------------------------------------------------------------
+
+std::uint64_t G4TPCPrimaryGeneratorAction::MixBits(const std::uint64_t value)
+{
+    std::uint64_t bits(value + 0x9e3779b97f4a7c15ULL);
+    bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    bits = (bits ^ (bits >> 27)) * 0x94d049bb133111ebULL;
+    return bits ^ (bits >> 31);
+}
@@ -0,0 +1,182 @@
+/**
+ *  @file   src/G4TPCRebin.cxx
+ *
+ *  @brief  Re-bin a raw step deposit archive into the readout segmentation given in a configuration file, without re-running the simulation.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ControlFlow/InputParameters.hh"
+#include "Objects/Cell.hh"
+#include "Objects/MCParticle.hh"
+#include "Persistency/DepositArchive.hh"
+#include "Persistency/EventContainer.hh"
+#include "Readout/DepositBuffer.hh"
+#include "Readout/VoxelGrid.hh"
+#include "Xml/tinyxml.hh"
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+/**
+ *  @brief  Re-binned output for one archived event
+ */
+struct RebinnedEvent
+{
+    RebinnedEvent() : m_eventNumber(-1), m_isValid(false) {}
+
+    int             m_eventNumber;      ///< Event number in the simulation job
+    bool            m_isValid;          ///< Whether the event was read successfully
+    CellList        m_cellList;         ///< The re-binned cells
+    MCParticleList  m_mcParticleList;   ///< Placeholder MC particles and parent links, used for the cell MC attribution
+};
+
+typedef std::vector<RebinnedEvent> RebinnedEventVector;
+
+//------------------------------------------------------------------------------
+
+void PrintUsage()
+{
+    std::cout << " Usage: " << std::endl;
+    std::cout << " G4TPCRebin [-split] ConfigFile.xml DepositArchive.bin [NThreads]" << std::endl;
+    std::cout << " By default each step is binned at its pre step position, as the simulation bins it, so re-binning at the simulated granularity" << std::endl;
+    std::cout << " reproduces the simulation output.  With -split, steps longer than half the smallest cell share their energy between the cells" << std::endl;
+    std::cout << " they cross, which is closer to the true deposit for cells finer than the simulation steps, but differs from the simulation output." << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+void RebinEvents(const std::string &archiveFileName, const VoxelGrid &voxelGrid, const float maxStepLength, std::atomic<unsigned int> &nextEvent,
+    RebinnedEventVector &events)
+{
+    // ATTN : Each worker owns a reader, so file positions and decompression buffers are never shared
+    DepositArchiveReader depositArchiveReader(archiveFileName);
+    DepositBuffer depositBuffer, splitBuffer;
+    IntVector knownParticles;
+
+    if (!depositArchiveReader.IsValid())
+        return;
+
+    for (unsigned int index = nextEvent++; index < events.size(); index = nextEvent++)
+    {
+        RebinnedEvent &event(events.at(index));
+
+        if (!depositArchiveReader.ReadEvent(index, event.m_eventNumber, depositBuffer, event.m_mcParticleList.m_trackIdParentMap, knownParticles))
+        {
+            std::cout << "Unable to read event record " << index << " from deposit archive " << archiveFileName << std::endl;
+            continue;
+        }
+
+        // Only the track ids of the kept MC particles are needed to reproduce the cell MC attribution
+        for (const int trackId : knownParticles)
+            event.m_mcParticleList.Add(new MCParticle(trackId, 0, 0, 0.));
+
+        // ATTN : The simulation bins each step at its pre step position, so steps are only split on request, using the archived post step
+        //        positions to share the energy of long steps between the cells they cross
+        if (maxStepLength > 0.f)
+        {
+            splitBuffer.Clear();
+            depositBuffer.SplitSteps(maxStepLength, splitBuffer);
+            splitBuffer.Reduce(voxelGrid, event.m_cellList);
+        }
+        else
+        {
+            depositBuffer.Reduce(voxelGrid, event.m_cellList);
+        }
+
+        event.m_isValid = true;
+    }
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    const bool splitSteps(argc > 1 && std::string(argv[1]) == "-split");
+    const int nArguments(splitSteps ? argc - 1 : argc);
+    char **pArguments(splitSteps ? argv + 1 : argv);
+
+    if (nArguments != 3 && nArguments != 4)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    // ATTN : Only the output file name and readout segmentation are used, so the rest of the configuration need not be valid
+    const InputParameters inputParameters(pArguments[1], true);
+    const std::string archiveFileName(pArguments[2]);
+
+    if (!inputParameters.ValidReadout())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    const DepositArchiveReader depositArchiveReader(archiveFileName);
+
+    if (!depositArchiveReader.IsValid())
+        return 1;
+
+    unsigned int nThreads(nArguments == 4 ? std::stoi(pArguments[3]) : std::thread::hardware_concurrency());
+    nThreads = std::max(1u, std::min(nThreads, depositArchiveReader.GetNEvents()));
+
+    const VoxelGrid voxelGrid(inputParameters.GetCenterX() - 0.5 * inputParameters.GetWidthX(), inputParameters.GetCenterY() - 0.5 * inputParameters.GetWidthY(),
+        inputParameters.GetCenterZ() - 0.5 * inputParameters.GetWidthZ(), inputParameters.GetWidthX(), inputParameters.GetWidthY(), inputParameters.GetWidthZ(),
+        inputParameters.GetNBinsX(), inputParameters.GetNBinsY(), inputParameters.GetNBinsZ(),
+        inputParameters.GetUseMortonCellIndex() ? VoxelGrid::MORTON : VoxelGrid::LINEAR);
+
+    // Split steps are divided into segments of at most half the smallest cell size, a non-positive length keeps every step whole
+    const float maxStepLength(!splitSteps ? 0.f : 0.5 * std::min(inputParameters.GetWidthX() / inputParameters.GetNBinsX(),
+        std::min(inputParameters.GetWidthY() / inputParameters.GetNBinsY(), inputParameters.GetWidthZ() / inputParameters.GetNBinsZ())));
+
+    // Events are independent, so workers take them from a shared counter and write to their own slot
+    RebinnedEventVector events(depositArchiveReader.GetNEvents());
+    std::atomic<unsigned int> nextEvent(0);
+    std::vector<std::thread> workers;
+
+    for (unsigned int thread = 0; thread < nThreads; ++thread)
+        workers.push_back(std::thread(RebinEvents, std::cref(archiveFileName), std::cref(voxelGrid), maxStepLength, std::ref(nextEvent), std::ref(events)));
+
+    for (std::thread &worker : workers)
+        worker.join();
+
+    TiXmlDocument tiXmlDocument;
+    TiXmlElement *pRunTiXmlElement = new TiXmlElement("Run");
+    tiXmlDocument.LinkEndChild(pRunTiXmlElement);
+
+    for (RebinnedEvent &event : events)
+    {
+        if (!event.m_isValid)
+            continue;
+
+        TiXmlElement *pEventTiXmlElement = new TiXmlElement("Event");
+        pEventTiXmlElement->SetAttribute("Number", event.m_eventNumber);
+        pRunTiXmlElement->LinkEndChild(pEventTiXmlElement);
+
+        EventContainer::WriteCellsXml(event.m_cellList, event.m_mcParticleList, pEventTiXmlElement);
+
+        for (const auto iter : event.m_cellList.m_idCellMap)
+            delete iter.second;
+
+        for (const auto iter : event.m_mcParticleList.m_mcParticles)
+            delete iter.second;
+    }
+
+    tiXmlDocument.SaveFile(inputParameters.GetOutputXmlFileName());
+    std::cout << "Re-binned " << events.size() << " events from " << archiveFileName << " into " << inputParameters.GetOutputXmlFileName() << std::endl;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
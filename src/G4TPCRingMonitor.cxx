@@ -0,0 +1,65 @@
+/**
+ *  @file   src/G4TPCRingMonitor.cxx
+ *
+ *  @brief  Example consumer of the shared memory ring output, reading events in place from a running simulation on the same host.
+ *
+ *  $Log: $
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "Persistency/SharedMemoryRing.hh"
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+void PrintUsage()
+{
+    std::cout << " Usage: " << std::endl;
+    std::cout << " G4TPCRingMonitor [SharedMemoryName]" << std::endl;
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    SharedMemoryRingReader sharedMemoryRingReader(argc == 2 ? argv[1] : "/g4tpc");
+
+    if (!sharedMemoryRingReader.IsValid())
+        return 1;
+
+    const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+    SharedMemoryRing::EventView eventView;
+    unsigned int nEvents(0);
+
+    // Events are read in place and released by the next call, so the simulation can reuse their space
+    while (sharedMemoryRingReader.NextEvent(eventView))
+    {
+        double totalEnergy(0.);
+
+        for (std::uint32_t cell = 0; cell < eventView.m_pHeader->m_nCells; cell++)
+            totalEnergy += eventView.m_pCells[cell].m_energy;
+
+        nEvents++;
+        const double elapsedTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        std::cout << "Event " << eventView.m_pHeader->m_eventNumber << (eventView.m_pHeader->m_aborted ? " (aborted)" : "") << " : "
+                  << eventView.m_pHeader->m_nCells << " cells, " << eventView.m_pHeader->m_nMCParticles << " MC particles, energy "
+                  << totalEnergy << " MeV, " << (elapsedTime > 0. ? nEvents / elapsedTime : 0.) << " events/s" << std::endl;
+    }
+
+    std::cout << "Read " << nEvents << " events" << std::endl;
+    return 0;
+}
@@ -32,6 +32,10 @@
 
 #include "G4TPCRunAction.hh"
 
+#include "ControlFlow/EventCostReport.hh"
+#include "ControlFlow/ProgressReporter.hh"
+#include "ControlFlow/StepProfiler.hh"
+
 #include "G4Run.hh"
 #include "G4RunManager.hh"
 #include "G4UnitsTable.hh"
@@ -39,10 +43,12 @@
 
 //------------------------------------------------------------------------------
 
-G4TPCRunAction::G4TPCRunAction(EventContainer *pEventContainer, G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction) :
+G4TPCRunAction::G4TPCRunAction(EventContainer *pEventContainer, G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction,
+        const InputParameters *pInputParameters) :
     G4UserRunAction(),
     m_pEventContainer(pEventContainer),
-    m_pG4TPCMCParticleUserAction(pG4TPCMCParticleUserAction)
+    m_pG4TPCMCParticleUserAction(pG4TPCMCParticleUserAction),
+    m_pInputParameters(pInputParameters)
 {
 }
 
@@ -58,13 +64,30 @@ void G4TPCRunAction::BeginOfRunAction(const G4Run *pG4Run)
 {
     m_pG4TPCMCParticleUserAction->BeginOfRunAction(pG4Run);
 
-    long seeds[2];
-    time_t systime = time(NULL);
-    seeds[0] = (long) systime;
-    seeds[1] = (long) (systime*G4UniformRand());
-    G4Random::setTheSeeds(seeds);
+    if (m_pInputParameters->GetRandomSeed() >= 0)
+    {
+        G4Random::setTheSeed(m_pInputParameters->GetRandomSeed());
+    }
+    else
+    {
+        long seeds[2];
+        time_t systime = time(NULL);
+        seeds[0] = (long) systime;
+        seeds[1] = (long) (systime*G4UniformRand());
+        G4Random::setTheSeeds(seeds);
+    }
+
     G4Random::showEngineStatus();
 
+    // ATTN : After seeding, as a run resumed from a checkpoint restores the random engine status
+    m_pEventContainer->BeginOfRunAction(pG4Run->GetNumberOfEventToBeProcessed());
+
+    if (m_pEventContainer->GetProgressReporter())
+        m_pEventContainer->GetProgressReporter()->BeginOfRun(pG4Run->GetNumberOfEventToBeProcessed());
+
+    for (EventReducer *pEventReducer : m_pEventContainer->GetEventReducers())
+        pEventReducer->BeginOfRun(m_pInputParameters->GetRunLabel());
+
     m_pG4TPCMCParticleUserAction->BeginOfRunAction(pG4Run);
 }
 
@@ -74,5 +97,17 @@ void G4TPCRunAction::EndOfRunAction(const G4Run *pG4Run)
 {
     m_pG4TPCMCParticleUserAction->EndOfRunAction(pG4Run);
     m_pEventContainer->SaveXml();
+
+    for (EventReducer *pEventReducer : m_pEventContainer->GetEventReducers())
+        pEventReducer->EndOfRun();
+
+    if (m_pEventContainer->GetProgressReporter())
+        m_pEventContainer->GetProgressReporter()->EndOfRun();
+
+    if (m_pEventContainer->GetEventCostReport())
+        m_pEventContainer->GetEventCostReport()->PrintSummary();
+
+    if (m_pEventContainer->GetStepProfiler())
+        m_pEventContainer->GetStepProfiler()->WriteReport();
 }
 
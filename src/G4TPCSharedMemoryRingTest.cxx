@@ -0,0 +1,330 @@
+/**
+ *  @file   src/G4TPCSharedMemoryRingTest.cxx
+ *
+ *  @brief  Test of the shared memory ring, run without geant4.  Events of varying size are written through a small ring, so that records
+ *          wrap around the end of the ring after padding records and after tails too short for a record header, and are read back.
+ *
+ *  $Log: $
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Persistency/SharedMemoryRing.hh"
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+typedef std::vector<SharedMemoryRing::CellRecord> CellRecordVector;
+typedef std::vector<SharedMemoryRing::MCParticleRecord> MCParticleRecordVector;
+
+/**
+ *  @brief  Event written to the ring, its contents being derived from its sequence number so the reader can check them
+ */
+struct TestEvent
+{
+    int                     m_eventNumber;      ///< Event number
+    long                    m_seed;             ///< Random seed
+    bool                    m_aborted;          ///< Whether the event was aborted
+    CellRecordVector        m_cells;            ///< Cells
+    MCParticleRecordVector  m_mcParticles;      ///< MC particles
+};
+
+/**
+ *  @brief  Make the event with a given sequence number
+ *
+ *  @param  sequence the sequence number
+ *  @param  nCells number of cells
+ *  @param  nMCParticles number of MC particles
+ *
+ *  @return the event
+ */
+TestEvent MakeEvent(const std::uint64_t sequence, const std::size_t nCells, const std::size_t nMCParticles)
+{
+    TestEvent testEvent;
+    testEvent.m_eventNumber = static_cast<int>(3 * sequence + 1);
+    testEvent.m_seed = static_cast<long>(sequence * 7919 + 11);
+    testEvent.m_aborted = (sequence % 5 == 4);
+
+    for (std::size_t cell = 0; cell < nCells; ++cell)
+    {
+        SharedMemoryRing::CellRecord cellRecord = {sequence * 1000 + cell, 1.f * cell, 2.f * cell, 3.f * cell, 0.5f * sequence,
+            static_cast<std::int32_t>(cell + 1), 0};
+        testEvent.m_cells.push_back(cellRecord);
+    }
+
+    for (std::size_t mcParticle = 0; mcParticle < nMCParticles; ++mcParticle)
+    {
+        SharedMemoryRing::MCParticleRecord mcParticleRecord = {static_cast<std::int32_t>(mcParticle + 1), 13, 0, 0, 0.105658, 1. * sequence,
+            0., 0., 0., 1., 2., 3., 0., 0., 1. * sequence};
+        testEvent.m_mcParticles.push_back(mcParticleRecord);
+    }
+
+    return testEvent;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Write an event to the ring
+ *
+ *  @param  sharedMemoryRingWriter the writer
+ *  @param  testEvent the event
+ *
+ *  @return whether the event was written, or why not
+ */
+SharedMemoryRing::WriteResult Write(SharedMemoryRingWriter &sharedMemoryRingWriter, const TestEvent &testEvent)
+{
+    return sharedMemoryRingWriter.WriteEvent(testEvent.m_eventNumber, testEvent.m_seed, testEvent.m_aborted, testEvent.m_cells.data(),
+        testEvent.m_cells.size(), testEvent.m_mcParticles.data(), testEvent.m_mcParticles.size());
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check an event read from the ring against the event written
+ *
+ *  @param  eventView the event read
+ *  @param  sequence the expected sequence number
+ *  @param  testEvent the event written
+ *
+ *  @return whether the events match
+ */
+bool Check(const SharedMemoryRing::EventView &eventView, const std::uint64_t sequence, const TestEvent &testEvent)
+{
+    const SharedMemoryRing::RecordHeader *const pHeader(eventView.m_pHeader);
+
+    if (pHeader->m_type != SharedMemoryRing::EVENT || pHeader->m_sequence != sequence || pHeader->m_eventNumber != testEvent.m_eventNumber ||
+        pHeader->m_seed != testEvent.m_seed || (pHeader->m_aborted != 0) != testEvent.m_aborted || pHeader->m_nCells != testEvent.m_cells.size() ||
+        pHeader->m_nMCParticles != testEvent.m_mcParticles.size())
+    {
+        std::cout << "Event record " << pHeader->m_sequence << " (event " << pHeader->m_eventNumber << ") read, expected " << sequence << " (event "
+                  << testEvent.m_eventNumber << ")" << std::endl;
+        return false;
+    }
+
+    for (std::size_t cell = 0; cell < testEvent.m_cells.size(); ++cell)
+    {
+        const SharedMemoryRing::CellRecord &expected(testEvent.m_cells[cell]), &actual(eventView.m_pCells[cell]);
+
+        if (actual.m_id != expected.m_id || actual.m_x != expected.m_x || actual.m_y != expected.m_y || actual.m_z != expected.m_z ||
+            actual.m_energy != expected.m_energy || actual.m_mcId != expected.m_mcId)
+        {
+            std::cout << "Event record " << sequence << " cell " << cell << " differs" << std::endl;
+            return false;
+        }
+    }
+
+    for (std::size_t mcParticle = 0; mcParticle < testEvent.m_mcParticles.size(); ++mcParticle)
+    {
+        const SharedMemoryRing::MCParticleRecord &expected(testEvent.m_mcParticles[mcParticle]), &actual(eventView.m_pMCParticles[mcParticle]);
+
+        if (actual.m_id != expected.m_id || actual.m_pdg != expected.m_pdg || actual.m_energy != expected.m_energy ||
+            actual.m_endZ != expected.m_endZ || actual.m_momentumZ != expected.m_momentumZ)
+        {
+            std::cout << "Event record " << sequence << " MC particle " << mcParticle << " differs" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get the size of the record holding an event
+ *
+ *  @param  testEvent the event
+ *
+ *  @return the record size in bytes
+ */
+std::uint64_t GetRecordSize(const TestEvent &testEvent)
+{
+    return (sizeof(SharedMemoryRing::RecordHeader) + testEvent.m_cells.size() * sizeof(SharedMemoryRing::CellRecord) +
+        testEvent.m_mcParticles.size() * sizeof(SharedMemoryRing::MCParticleRecord));
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Write events through a small ring from a single thread, reading one event back whenever the ring is full
+ *
+ *  @param  name the shared memory object name
+ *
+ *  @return whether every event was read back, and the events wrapped both after padding records and after short tails
+ */
+bool TestWrapAround(const std::string &name)
+{
+    const std::uint64_t capacity(1000);
+    const std::uint64_t nEvents(500);
+
+    // ATTN : A zero timeout makes a write to a full ring return at once, so one thread can play both sides
+    SharedMemoryRingWriter sharedMemoryRingWriter(name, capacity, 0);
+    SharedMemoryRingReader sharedMemoryRingReader(name);
+
+    if (!sharedMemoryRingWriter.IsValid() || !sharedMemoryRingReader.IsValid())
+        return false;
+
+    if (Write(sharedMemoryRingWriter, MakeEvent(0, 40, 0)) != SharedMemoryRing::TOO_LARGE)
+    {
+        std::cout << "Event larger than the ring was not rejected" << std::endl;
+        return false;
+    }
+
+    std::mt19937 generator(12345);
+    std::uniform_int_distribution<unsigned int> nCellsDistribution(0, 20), nMCParticlesDistribution(0, 2);
+    std::vector<TestEvent> testEvents;
+    std::uint64_t nRead(0), writeOffset(0);
+    unsigned int nPaddingRecords(0), nShortTails(0);
+    SharedMemoryRing::EventView eventView;
+
+    for (std::uint64_t sequence = 0; sequence < nEvents; ++sequence)
+    {
+        testEvents.push_back(MakeEvent(sequence, nCellsDistribution(generator), nMCParticlesDistribution(generator)));
+        const std::uint64_t recordSize(GetRecordSize(testEvents.back()));
+
+        // Follow where the record lands, to count how the ring wrapped
+        if (writeOffset + recordSize > capacity)
+        {
+            ++(capacity - writeOffset >= sizeof(SharedMemoryRing::RecordHeader) ? nPaddingRecords : nShortTails);
+            writeOffset = 0;
+        }
+
+        writeOffset += recordSize;
+
+        // ATTN : Finding no event may still free space, as the reader skips a padding record the writer published before timing out
+        bool drained(false);
+
+        while (true)
+        {
+            const SharedMemoryRing::WriteResult writeResult(Write(sharedMemoryRingWriter, testEvents.back()));
+
+            if (writeResult == SharedMemoryRing::WRITTEN)
+                break;
+
+            if (writeResult != SharedMemoryRing::TIMED_OUT || drained)
+            {
+                std::cout << "Unable to write event record " << sequence << std::endl;
+                return false;
+            }
+
+            if (!sharedMemoryRingReader.NextEvent(eventView, 0))
+            {
+                drained = true;
+                continue;
+            }
+
+            if (!Check(eventView, nRead, testEvents[nRead]))
+                return false;
+
+            // The reader only releases an event on the next call, so release it now to make space for the write
+            sharedMemoryRingReader.Release();
+            ++nRead;
+        }
+    }
+
+    while (sharedMemoryRingReader.NextEvent(eventView, 0))
+    {
+        if (nRead >= nEvents || !Check(eventView, nRead, testEvents[nRead]))
+            return false;
+
+        ++nRead;
+    }
+
+    std::cout << (nRead == nEvents && nPaddingRecords > 0 && nShortTails > 0 ? "PASS " : "FAIL ") << "Wrap around (" << nRead << " of " << nEvents
+              << " events read, " << nPaddingRecords << " padding records, " << nShortTails << " short tails)" << std::endl;
+
+    return (nRead == nEvents && nPaddingRecords > 0 && nShortTails > 0);
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Write events through a small ring from one thread and read them from another, each waiting on the other
+ *
+ *  @param  name the shared memory object name
+ *
+ *  @return whether every event was read back in order, and the ring finished once the writer closed it
+ */
+bool TestConcurrent(const std::string &name)
+{
+    const std::uint64_t capacity(4096);
+    const std::uint64_t nEvents(20000);
+
+    std::vector<TestEvent> testEvents;
+    std::mt19937 generator(54321);
+    std::uniform_int_distribution<unsigned int> nCellsDistribution(0, 60), nMCParticlesDistribution(0, 4);
+
+    for (std::uint64_t sequence = 0; sequence < nEvents; ++sequence)
+        testEvents.push_back(MakeEvent(sequence, nCellsDistribution(generator), nMCParticlesDistribution(generator)));
+
+    SharedMemoryRingWriter *pSharedMemoryRingWriter(new SharedMemoryRingWriter(name, capacity));
+    SharedMemoryRingReader sharedMemoryRingReader(name);
+
+    if (!pSharedMemoryRingWriter->IsValid() || !sharedMemoryRingReader.IsValid())
+    {
+        delete pSharedMemoryRingWriter;
+        return false;
+    }
+
+    // ATTN : The writer closes the ring when it is deleted, which ends the reader once it has read every event
+    bool written(true);
+    std::thread writerThread([&]()
+    {
+        for (const TestEvent &testEvent : testEvents)
+            written = (Write(*pSharedMemoryRingWriter, testEvent) == SharedMemoryRing::WRITTEN) && written;
+
+        delete pSharedMemoryRingWriter;
+    });
+
+    SharedMemoryRing::EventView eventView;
+    std::uint64_t nRead(0);
+    bool success(true);
+
+    while (sharedMemoryRingReader.NextEvent(eventView))
+    {
+        if (nRead >= nEvents || !Check(eventView, nRead, testEvents[nRead]))
+        {
+            success = false;
+            break;
+        }
+
+        ++nRead;
+    }
+
+    // ATTN : Leave the reader blocking the writer no longer
+    while (!success && sharedMemoryRingReader.NextEvent(eventView))
+        ;
+
+    writerThread.join();
+    success = success && written && nRead == nEvents && sharedMemoryRingReader.IsFinished();
+    std::cout << (success ? "PASS " : "FAIL ") << "Concurrent (" << nRead << " of " << nEvents << " events read)" << std::endl;
+
+    return success;
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+int main()
+{
+    const std::string name("/g4tpc_test_" + std::to_string(getpid()));
+
+    bool success(true);
+    success = TestWrapAround(name) && success;
+    success = TestConcurrent(name) && success;
+
+    return (success ? 0 : 1);
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,280 @@
+/**
+ *  @file   src/G4TPCShowerLibraryBuilder.cxx
+ *
+ *  @brief  Build a frozen shower library by fully simulating the library particles, by default electrons, positrons and photons, in each
+ *          library energy bin.  A library of other particles, such as muons, pions and protons, is the single particle response library
+ *          used by G4TPCFastAssembly.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+#include "G4TPCDetectorConstruction.hh"
+#include "G4TPCPhysicsListFactory.hh"
+#include "ControlFlow/InputParameters.hh"
+#include "Persistency/ShowerLibrary.hh"
+
+#include "G4Event.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleGun.hh"
+#include "G4ParticleTable.hh"
+#include "G4RunManager.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "G4UserEventAction.hh"
+#include "G4UserSteppingAction.hh"
+#include "G4VModularPhysicsList.hh"
+#include "G4VUserPrimaryGeneratorAction.hh"
+
+#include "Randomize.hh"
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+void PrintUsage()
+{
+    std::cout << " Usage: " << G4endl;
+    std::cout << " G4TPCShowerLibraryBuilder ConfigFile.xml" << G4endl;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Shoots single particles, with energies distributed logarithmically across the current library bin, from the centre of the low
+ *          z face of the detector along +z
+ */
+class LibraryPrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
+{
+public:
+    LibraryPrimaryGeneratorAction(const G4ThreeVector &start) : m_start(start), m_minEnergy(0.), m_maxEnergy(0.), m_energy(0.) {}
+
+    void SetBin(G4ParticleDefinition *pG4ParticleDefinition, const double minEnergy, const double maxEnergy)
+    {
+        m_particleGun.SetParticleDefinition(pG4ParticleDefinition);
+        m_minEnergy = minEnergy;
+        m_maxEnergy = maxEnergy;
+    }
+
+    void GeneratePrimaries(G4Event *pG4Event) override
+    {
+        m_energy = m_minEnergy * std::pow(m_maxEnergy / m_minEnergy, G4UniformRand());
+        m_particleGun.SetParticlePosition(m_start);
+        m_particleGun.SetParticleMomentumDirection(G4ThreeVector(0., 0., 1.));
+        m_particleGun.SetParticleEnergy(m_energy);
+        m_particleGun.GeneratePrimaryVertex(pG4Event);
+    }
+
+    const G4ThreeVector &GetStart() const { return m_start; }
+    double GetEnergy() const { return m_energy; }
+
+private:
+    G4ParticleGun   m_particleGun;  ///< The particle gun
+    G4ThreeVector   m_start;        ///< Shower start position
+    double          m_minEnergy;    ///< Lower edge of the current library bin
+    double          m_maxEnergy;    ///< Upper edge of the current library bin
+    double          m_energy;       ///< Kinetic energy of the current primary
+};
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Merges the energy deposited in the absorber into cubic spots around the shower start, selecting deposits as G4TPCSteppingAction
+ */
+class LibrarySteppingAction : public G4UserSteppingAction
+{
+public:
+    LibrarySteppingAction(const G4TPCDetectorConstruction *pG4TPCDetectorConstruction, const LibraryPrimaryGeneratorAction *pPrimaryGeneratorAction,
+            const double spotSize) :
+        m_pG4TPCDetectorConstruction(pG4TPCDetectorConstruction),
+        m_pPrimaryGeneratorAction(pPrimaryGeneratorAction),
+        m_inverseSpotSize(1. / spotSize)
+    {
+    }
+
+    void UserSteppingAction(const G4Step *pG4Step) override
+    {
+        if (pG4Step->GetTrack()->GetDefinition()->GetPDGCharge() == 0.)
+            return;
+
+        if (pG4Step->GetPreStepPoint()->GetTouchableHandle()->GetVolume() != m_pG4TPCDetectorConstruction->GetLArPV())
+            return;
+
+        const double energy(pG4Step->GetTotalEnergyDeposit());
+
+        if (energy <= 0.)
+            return;
+
+        const G4ThreeVector offset(pG4Step->GetPreStepPoint()->GetPosition() - m_pPrimaryGeneratorAction->GetStart());
+        const long long ix(std::floor(offset.x() * m_inverseSpotSize)), iy(std::floor(offset.y() * m_inverseSpotSize)),
+            iz(std::floor(offset.z() * m_inverseSpotSize));
+
+        // ATTN : Spots hold the energy weighted centroid of their deposits, so merging does not bias the shower shape
+        ShowerLibrary::Spot &spot(m_spots[std::make_tuple(ix, iy, iz)]);
+        spot.m_x += energy * offset.x();
+        spot.m_y += energy * offset.y();
+        spot.m_z += energy * offset.z();
+        spot.m_energyFraction += energy;
+    }
+
+    void FillSpots(const double primaryEnergy, ShowerLibrary::SpotVector &spots) const
+    {
+        spots.clear();
+
+        for (const auto &iter : m_spots)
+        {
+            const ShowerLibrary::Spot &spot(iter.second);
+            ShowerLibrary::Spot librarySpot;
+            librarySpot.m_x = (spot.m_x / spot.m_energyFraction) / mm;
+            librarySpot.m_y = (spot.m_y / spot.m_energyFraction) / mm;
+            librarySpot.m_z = (spot.m_z / spot.m_energyFraction) / mm;
+            librarySpot.m_energyFraction = spot.m_energyFraction / primaryEnergy;
+            spots.push_back(librarySpot);
+        }
+    }
+
+    void Clear() { m_spots.clear(); }
+
+private:
+    typedef std::map<std::tuple<long long, long long, long long>, ShowerLibrary::Spot> SpotMap;
+
+    const G4TPCDetectorConstruction        *m_pG4TPCDetectorConstruction;   ///< Detector construction class
+    const LibraryPrimaryGeneratorAction    *m_pPrimaryGeneratorAction;      ///< Primary generator, holds the shower start
+    double                                  m_inverseSpotSize;              ///< Inverse of the spot cube size
+    SpotMap                                 m_spots;                        ///< Summed spots for the current shower
+};
+
+//------------------------------------------------------------------------------
+
+/**
+ *  @brief  Adds each simulated shower to the library
+ */
+class LibraryEventAction : public G4UserEventAction
+{
+public:
+    LibraryEventAction(const LibraryPrimaryGeneratorAction *pPrimaryGeneratorAction, LibrarySteppingAction *pSteppingAction,
+            ShowerLibraryWriter *pShowerLibraryWriter) :
+        m_pPrimaryGeneratorAction(pPrimaryGeneratorAction),
+        m_pSteppingAction(pSteppingAction),
+        m_pShowerLibraryWriter(pShowerLibraryWriter)
+    {
+    }
+
+    void BeginOfEventAction(const G4Event *) override
+    {
+        m_pSteppingAction->Clear();
+    }
+
+    void EndOfEventAction(const G4Event *) override
+    {
+        const double energy(m_pPrimaryGeneratorAction->GetEnergy());
+        m_pSteppingAction->FillSpots(energy, m_spots);
+        m_pShowerLibraryWriter->AddShower(energy / MeV, m_spots);
+    }
+
+private:
+    const LibraryPrimaryGeneratorAction    *m_pPrimaryGeneratorAction;      ///< Primary generator, holds the primary energy
+    LibrarySteppingAction                  *m_pSteppingAction;              ///< Stepping action, holds the shower spots
+    ShowerLibraryWriter                    *m_pShowerLibraryWriter;         ///< The library being built
+    ShowerLibrary::SpotVector               m_spots;                        ///< Reused buffer for the shower spots
+};
+
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    const InputParameters inputParameters(argv[1]);
+
+    if (!inputParameters.Valid() || !inputParameters.ValidShowerLibrary())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    if (inputParameters.GetUseShowerLibrary() || inputParameters.GetUseEMShowerParameterisation())
+    {
+        std::cout << "The shower library must be built with full simulation, disable the shower library and parameterisation" << G4endl;
+        return 1;
+    }
+
+    G4Random::setTheEngine(new CLHEP::RanecuEngine);
+    G4RunManager *pG4RunManager = new G4RunManager;
+
+    G4TPCDetectorConstruction *pG4TPCDetectorConstruction = new G4TPCDetectorConstruction(&inputParameters);
+    pG4RunManager->SetUserInitialization(pG4TPCDetectorConstruction);
+
+    G4VModularPhysicsList *pG4VModularPhysicsList = G4TPCPhysicsListFactory::Create(inputParameters);
+
+    if (!pG4VModularPhysicsList)
+    {
+        delete pG4RunManager;
+        return 1;
+    }
+
+    pG4RunManager->SetUserInitialization(pG4VModularPhysicsList);
+
+    // ATTN : Showers start just inside the absorber, so the detector must be long enough in z to contain the most energetic library showers
+    const G4ThreeVector start(inputParameters.GetCenterX() * mm, inputParameters.GetCenterY() * mm,
+        (inputParameters.GetCenterZ() - 0.5 * inputParameters.GetWidthZ()) * mm + 1. * um);
+
+    ShowerLibraryWriter showerLibraryWriter;
+    LibraryPrimaryGeneratorAction *pPrimaryGeneratorAction = new LibraryPrimaryGeneratorAction(start);
+    LibrarySteppingAction *pSteppingAction = new LibrarySteppingAction(pG4TPCDetectorConstruction, pPrimaryGeneratorAction,
+        inputParameters.GetShowerLibrarySpotSize() * mm);
+    pG4RunManager->SetUserAction(pPrimaryGeneratorAction);
+    pG4RunManager->SetUserAction(pSteppingAction);
+    pG4RunManager->SetUserAction(new LibraryEventAction(pPrimaryGeneratorAction, pSteppingAction, &showerLibraryWriter));
+    pG4RunManager->Initialize();
+
+    // ATTN : Bins are added in order of pdg code then energy, as the library lookup requires
+    std::vector<int> pdgCodes(inputParameters.GetShowerLibraryPDGCodes());
+    std::sort(pdgCodes.begin(), pdgCodes.end());
+    pdgCodes.erase(std::unique(pdgCodes.begin(), pdgCodes.end()), pdgCodes.end());
+
+    const double minEnergy(inputParameters.GetShowerLibraryMinEnergy()), maxEnergy(inputParameters.GetShowerLibraryMaxEnergy());
+    const int nEnergyBins(inputParameters.GetShowerLibraryNEnergyBins());
+
+    for (const int pdg : pdgCodes)
+    {
+        G4ParticleDefinition *pG4ParticleDefinition(G4ParticleTable::GetParticleTable()->FindParticle(pdg));
+
+        if (!pG4ParticleDefinition)
+        {
+            std::cout << "Unknown shower library particle, pdg " << pdg << G4endl;
+            delete pG4RunManager;
+            return 1;
+        }
+
+        for (int energyBin = 0; energyBin < nEnergyBins; energyBin++)
+        {
+            const double binMinEnergy(minEnergy * std::pow(maxEnergy / minEnergy, static_cast<double>(energyBin) / nEnergyBins));
+            const double binMaxEnergy(minEnergy * std::pow(maxEnergy / minEnergy, static_cast<double>(energyBin + 1) / nEnergyBins));
+
+            std::cout << "Building shower library bin : pdg " << pdg << ", " << binMinEnergy << " - " << binMaxEnergy << " MeV" << G4endl;
+            showerLibraryWriter.AddBin(pdg, binMinEnergy, binMaxEnergy);
+            pPrimaryGeneratorAction->SetBin(pG4ParticleDefinition, binMinEnergy * MeV, binMaxEnergy * MeV);
+            pG4RunManager->BeamOn(inputParameters.GetShowerLibraryNShowersPerBin());
+        }
+    }
+
+    const bool success(showerLibraryWriter.Write(inputParameters.GetShowerLibraryFileName()));
+    delete pG4RunManager;
+
+    return success ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
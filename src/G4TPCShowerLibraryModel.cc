@@ -0,0 +1,115 @@
+/**
+ *  @file   src/G4TPCShowerLibraryModel.cc
+ *
+ *  @brief  Implementation of the geant4 frozen shower library fast simulation model.
+ *
+ *  $Log: $
+ */
+
+#include <cmath>
+
+#include "G4Electron.hh"
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4Gamma.hh"
+#include "G4Positron.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+#include "G4TPCDetectorConstruction.hh"
+#include "G4TPCShowerLibraryModel.hh"
+#include "G4TPCSteppingAction.hh"
+
+#include "ControlFlow/InputParameters.hh"
+#include "Persistency/ShowerLibrary.hh"
+#include "Readout/VoxelGrid.hh"
+
+G4TPCShowerLibraryModel::G4TPCShowerLibraryModel(const G4String &name, G4Region *pG4Region, const G4TPCDetectorConstruction *pG4TPCDetectorConstruction,
+        G4TPCSteppingAction *pG4TPCSteppingAction, const InputParameters *pInputParameters) :
+    G4VFastSimulationModel(name, pG4Region),
+    m_pG4TPCDetectorConstruction(pG4TPCDetectorConstruction),
+    m_pG4TPCSteppingAction(pG4TPCSteppingAction),
+    m_pShowerLibraryReader(new ShowerLibraryReader(pInputParameters->GetShowerLibraryFileName())),
+    m_minEnergy(pInputParameters->GetShowerLibraryMinEnergy() * MeV),
+    m_maxEnergy(pInputParameters->GetShowerLibraryMaxEnergy() * MeV)
+{
+    if (!m_pShowerLibraryReader->IsValid())
+    {
+        G4ExceptionDescription msg;
+        msg << "Unable to load shower library " << pInputParameters->GetShowerLibraryFileName() << ".";
+        G4Exception("G4TPCShowerLibraryModel::G4TPCShowerLibraryModel()", "MyCode0003", FatalException, msg);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+G4TPCShowerLibraryModel::~G4TPCShowerLibraryModel()
+{
+    delete m_pShowerLibraryReader;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+G4bool G4TPCShowerLibraryModel::IsApplicable(const G4ParticleDefinition &particleDefinition)
+{
+    return (&particleDefinition == G4Electron::ElectronDefinition() || &particleDefinition == G4Positron::PositronDefinition() ||
+        &particleDefinition == G4Gamma::GammaDefinition());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+G4bool G4TPCShowerLibraryModel::ModelTrigger(const G4FastTrack &fastTrack)
+{
+    const G4Track *pG4Track(fastTrack.GetPrimaryTrack());
+    const double energy(pG4Track->GetKineticEnergy());
+
+    if (energy <= m_minEnergy || energy >= m_maxEnergy)
+        return false;
+
+    return (m_pShowerLibraryReader->FindBin(pG4Track->GetDefinition()->GetPDGEncoding(), energy / MeV) != nullptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void G4TPCShowerLibraryModel::DoIt(const G4FastTrack &fastTrack, G4FastStep &fastStep)
+{
+    const G4Track *pG4Track(fastTrack.GetPrimaryTrack());
+    const double energy(pG4Track->GetKineticEnergy());
+    const int trackId(pG4Track->GetTrackID());
+    const G4ThreeVector &start(pG4Track->GetPosition());
+    const G4ThreeVector &axis(pG4Track->GetMomentumDirection());
+
+    // ATTN : The spots are deposited here rather than via the killing step, which the stepping action would otherwise see as a point deposit
+    fastStep.KillPrimaryTrack();
+    fastStep.ProposePrimaryTrackPathLength(0.);
+    fastStep.ProposeTotalEnergyDeposited(0.);
+
+    const ShowerLibrary::Bin *pBin(m_pShowerLibraryReader->FindBin(pG4Track->GetDefinition()->GetPDGEncoding(), energy / MeV));
+
+    if (!pBin)
+        return;
+
+    const ShowerLibrary::Shower &shower(m_pShowerLibraryReader->GetShower(*pBin, G4UniformRand()));
+    const ShowerLibrary::Spot *pSpots(m_pShowerLibraryReader->GetSpots(shower));
+
+    // Library showers travel along +z, so turn them about their axis by a random angle then onto the track direction
+    const double phi(CLHEP::twopi * G4UniformRand());
+    const double cosPhi(std::cos(phi)), sinPhi(std::sin(phi));
+    const VoxelGrid &voxelGrid(m_pG4TPCDetectorConstruction->GetVoxelGrid());
+
+    for (std::uint32_t spot = 0; spot < shower.m_nSpots; ++spot)
+    {
+        const ShowerLibrary::Spot &librarySpot(pSpots[spot]);
+        G4ThreeVector offset(librarySpot.m_x * cosPhi - librarySpot.m_y * sinPhi, librarySpot.m_x * sinPhi + librarySpot.m_y * cosPhi, librarySpot.m_z);
+        offset.rotateUz(axis);
+
+        const G4ThreeVector position(start + offset * mm);
+
+        // ATTN : Spots outside the detector are leakage, as they would be in full simulation
+        if (!voxelGrid.Contains(position.x(), position.y(), position.z()))
+            continue;
+
+        m_pG4TPCSteppingAction->AddEnergyDeposition(position, librarySpot.m_energyFraction * energy, trackId);
+    }
+}
@@ -0,0 +1,158 @@
+/**
+ *  @file   src/G4TPCSimulation.cc
+ *
+ *  @brief  Implementation of the G4TPCSimulation class.
+ *
+ *  $Log: $
+ */
+
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4VModularPhysicsList.hh"
+#include "G4VisExecutive.hh"
+
+#include "Randomize.hh"
+
+#include "G4TPCActionInitialization.hh"
+#include "G4TPCDetectorConstruction.hh"
+#include "G4TPCPhysicsListFactory.hh"
+#include "G4TPCRunAction.hh"
+#include "G4TPCSimulation.hh"
+
+#include "Persistency/Checkpoint.hh"
+#include "Persistency/RandomSnapshot.hh"
+
+G4TPCSimulation::G4TPCSimulation(InputParameters &inputParameters) :
+    m_inputParameters(inputParameters),
+    m_pG4RunManager(nullptr),
+    m_pG4VisManager(nullptr),
+    m_pG4VModularPhysicsList(nullptr),
+    m_pEventContainer(nullptr)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+G4TPCSimulation::~G4TPCSimulation()
+{
+    delete m_pG4VisManager;
+    delete m_pG4RunManager;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool G4TPCSimulation::Initialize()
+{
+    if (m_pG4RunManager)
+        return true;
+
+    // Choose the Random engine
+    G4Random::setTheEngine(new CLHEP::RanecuEngine);
+
+    // Construct the default run manager
+    m_pG4RunManager = new G4RunManager;
+
+    // Set mandatory and optional initialization classes
+    G4TPCDetectorConstruction *pG4TPCDetectorConstruction = new G4TPCDetectorConstruction(&m_inputParameters);
+    m_pG4RunManager->SetUserInitialization(pG4TPCDetectorConstruction);
+
+    m_pG4VModularPhysicsList = G4TPCPhysicsListFactory::Create(m_inputParameters);
+
+    if (!m_pG4VModularPhysicsList)
+        return false;
+
+    m_pG4RunManager->SetUserInitialization(m_pG4VModularPhysicsList);
+    m_pG4RunManager->SetUserInitialization(new G4TPCActionInitialization(pG4TPCDetectorConstruction, &m_inputParameters));
+
+    // ATTN : The sequential run manager builds the user actions as soon as the action initialization is set
+    m_pEventContainer = dynamic_cast<const G4TPCRunAction*>(m_pG4RunManager->GetUserRunAction())->GetEventContainer();
+    m_pEventContainer->SetEventCallback(m_eventCallback);
+
+    if (m_inputParameters.GetUseOverlay() && !m_pEventContainer->GetOverlayLibrary())
+        return false;
+
+    // Initialize visualization, only if requested as constructing the vis manager registers every driver and slows the startup of batch jobs
+    if (m_inputParameters.GetUseVisualization())
+    {
+        m_pG4VisManager = new G4VisExecutive;
+        m_pG4VisManager->Initialize();
+    }
+
+    G4UImanager::GetUIpointer()->ApplyCommand("/run/initialize");
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void G4TPCSimulation::SetEventCallback(const EventContainer::EventCallback &eventCallback)
+{
+    m_eventCallback = eventCallback;
+
+    if (m_pEventContainer)
+        m_pEventContainer->SetEventCallback(m_eventCallback);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool G4TPCSimulation::Run()
+{
+    unsigned int nEventsToProcess(0);
+
+    if (!m_pG4RunManager || !this->GetNEventsToProcess(nEventsToProcess))
+        return false;
+
+    // ATTN : Each particle gun configuration is a separate run of the same initialized kernel, geometry and physics are not rebuilt
+    const unsigned int nRuns(m_inputParameters.GetUseParticleGun() ? m_inputParameters.GetNParticleGuns() : 1);
+
+    for (unsigned int run = 0; run < nRuns; run++)
+    {
+        if (m_inputParameters.GetUseParticleGun())
+        {
+            m_inputParameters.SelectParticleGun(run);
+            std::cout << "Simulating " << m_inputParameters.GetParticleGunSpecies() << " at " << m_inputParameters.GetParticleGunEnergy()
+                      << " GeV, saving to " << m_inputParameters.GetOutputXmlFileName() << G4endl;
+        }
+
+        G4UImanager::GetUIpointer()->ApplyCommand("/run/beamOn " + std::to_string(nEventsToProcess));
+    }
+
+    // The tables are built by the first run, so can only be stored after it
+    G4TPCPhysicsListFactory::StorePhysicsTables(m_inputParameters, m_pG4VModularPhysicsList);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool G4TPCSimulation::GetNEventsToProcess(unsigned int &nEventsToProcess) const
+{
+    nEventsToProcess = m_inputParameters.GetUseParticleGun() ? m_inputParameters.GetMaxNEventsToProcess() :
+        std::min(m_inputParameters.GetGenieNEvents(), m_inputParameters.GetMaxNEventsToProcess());
+
+    // A job resumed from a checkpoint only processes the events after it
+    Checkpoint checkpoint(m_inputParameters.GetCheckpointFileName());
+
+    if (m_inputParameters.GetUseCheckpoint() && checkpoint.Load())
+        nEventsToProcess -= std::min(nEventsToProcess, static_cast<unsigned int>(checkpoint.GetNEventsCompleted()));
+
+    // A replay job only processes the replay events, each of which must have a random snapshot
+    if (m_inputParameters.GetUseReplay())
+    {
+        const RandomSnapshotReader randomSnapshotReader(m_inputParameters.GetReplaySnapshotFileName());
+
+        if (!randomSnapshotReader.IsValid())
+            return false;
+
+        for (const int eventNumber : m_inputParameters.GetReplayEvents())
+        {
+            if (!randomSnapshotReader.HasEvent(eventNumber))
+            {
+                std::cout << "No random snapshot for replay event " << eventNumber << std::endl;
+                return false;
+            }
+        }
+
+        nEventsToProcess = m_inputParameters.GetReplayEvents().size();
+    }
+
+    return true;
+}
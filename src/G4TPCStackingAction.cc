@@ -0,0 +1,110 @@
+/**
+ *  @file   src/G4TPCStackingAction.cc
+ *
+ *  @brief  Implementation of the geant4 stacking action class.
+ *
+ *  $Log: $
+ */
+
+#include <cstdlib>
+
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+
+#include "G4TPCDetectorConstruction.hh"
+#include "G4TPCStackingAction.hh"
+#include "G4TPCSteppingAction.hh"
+
+#include "ControlFlow/EventCostReport.hh"
+#include "ControlFlow/InputParameters.hh"
+#include "ControlFlow/Logger.hh"
+#include "Persistency/EventContainer.hh"
+
+G4TPCStackingAction::G4TPCStackingAction(const G4TPCDetectorConstruction *pG4TPCDetectorConstruction, EventContainer *pEventContainer,
+        G4TPCSteppingAction *pG4TPCSteppingAction, const InputParameters *pInputParameters) :
+    G4UserStackingAction(),
+    m_pG4TPCDetectorConstruction(pG4TPCDetectorConstruction),
+    m_pEventContainer(pEventContainer),
+    m_pG4TPCSteppingAction(pG4TPCSteppingAction),
+    m_neutronTimeWindow(pInputParameters->GetNeutronTimeWindow() * ns),
+    m_killNeutrinos(pInputParameters->GetKillNeutrinos())
+{
+    // ATTN : Particles are constructed with the physics list, which must be set before the user actions are built
+    for (const KillThresholdParameters &killThreshold : pInputParameters->GetKillThresholds())
+    {
+        const G4ParticleDefinition *pG4ParticleDefinition(G4ParticleTable::GetParticleTable()->FindParticle(killThreshold.m_species));
+
+        if (!pG4ParticleDefinition)
+        {
+            Logger::Write(Logger::WARNING, "Unknown particle species for kill threshold : " + killThreshold.m_species);
+            continue;
+        }
+
+        m_pdgKillThresholds[pG4ParticleDefinition->GetPDGEncoding()] = killThreshold.m_energy * MeV;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+G4TPCStackingAction::~G4TPCStackingAction()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+G4ClassificationOfNewTrack G4TPCStackingAction::ClassifyNewTrack(const G4Track *pG4Track)
+{
+    const G4ClassificationOfNewTrack classification(this->Classify(pG4Track));
+
+    if (classification == fKill && m_pEventContainer->GetEventCostReport())
+        m_pEventContainer->GetEventCostReport()->AddKilledTrack();
+
+    return classification;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void G4TPCStackingAction::PrepareNewEvent()
+{
+    m_neutronTrackIds.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+G4ClassificationOfNewTrack G4TPCStackingAction::Classify(const G4Track *pG4Track)
+{
+    const int pdgCode(pG4Track->GetDefinition()->GetPDGEncoding());
+    const int absPdgCode(std::abs(pdgCode));
+
+    if (m_killNeutrinos && (absPdgCode == 12 || absPdgCode == 14 || absPdgCode == 16))
+        return fKill;
+
+    if (m_neutronTimeWindow > 0.)
+    {
+        // ATTN : The stepping action only stops a neutron after the step crossing the time window, so a capture in that step has already
+        //        happened.  Its gammas, and anything else a neutron produces after the window, are killed here instead of being tracked.
+        if ((absPdgCode == 2112 || m_neutronTrackIds.count(pG4Track->GetParentID())) && pG4Track->GetGlobalTime() > m_neutronTimeWindow)
+            return fKill;
+
+        // ATTN : Track ids are assigned before the track is classified
+        if (absPdgCode == 2112)
+            m_neutronTrackIds.insert(pG4Track->GetTrackID());
+    }
+
+    // ATTN : Primaries are always tracked, so the thresholds never remove a generated particle from the MC particle list
+    if (pG4Track->GetParentID() <= 0)
+        return fUrgent;
+
+    const IntDoubleMap::const_iterator iter(m_pdgKillThresholds.find(pdgCode));
+
+    if (iter == m_pdgKillThresholds.end() || pG4Track->GetKineticEnergy() >= iter->second)
+        return fUrgent;
+
+    // ATTN : The killed track never reaches the tracking action, so its deposit is attributed to its parent.  Positron annihilation photons
+    //        are not produced, so only the kinetic energy is deposited, in each readout grid containing the track.
+    m_pG4TPCSteppingAction->AddContainedEnergyDeposition(pG4Track->GetPosition(), pG4Track->GetKineticEnergy(), pG4Track->GetParentID());
+
+    return fKill;
+}
@@ -28,23 +28,38 @@
 /// \file G4TPCSteppingAction.cc
 /// \brief Implementation of the G4TPCSteppingAction class
 
+#include <sstream>
+
 #include "G4TPCSteppingAction.hh"
 #include "G4TPCDetectorConstruction.hh"
 
+#include "ControlFlow/EventCostReport.hh"
+#include "ControlFlow/EventWatchdog.hh"
+#include "ControlFlow/InputParameters.hh"
+#include "ControlFlow/Logger.hh"
+#include "ControlFlow/StepProfiler.hh"
 #include "Persistency/EventContainer.hh"
+#include "Readout/VoxelGrid.hh"
 
 #include "G4Step.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
 #include "G4RunManager.hh"
 
 //------------------------------------------------------------------------------
 
 G4TPCSteppingAction::G4TPCSteppingAction(const G4TPCDetectorConstruction *pG4TPCDetectorConstruction, EventContainer *pEventContainer,
-    G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction) :
+    G4TPCMCParticleUserAction *pG4TPCMCParticleUserAction, const InputParameters *pInputParameters) :
     G4UserSteppingAction(),
     m_pG4TPCDetectorConstruction(pG4TPCDetectorConstruction),
     m_pEventContainer(pEventContainer),
-    m_pG4TPCMCParticleUserAction(pG4TPCMCParticleUserAction)
+    m_pG4TPCMCParticleUserAction(pG4TPCMCParticleUserAction),
+    m_useBatchedDeposits(pInputParameters->GetUseBatchedDeposits()),
+    m_useDepositArchive(pInputParameters->GetUseDepositArchive()),
+    m_neutronTimeWindow(pInputParameters->GetUseStackingAction() ? pInputParameters->GetNeutronTimeWindow() * ns : -1.),
+    m_pEventWatchdog(pEventContainer->GetEventWatchdog()),
+    m_pEventCostReport(pEventContainer->GetEventCostReport()),
+    m_pStepProfiler(pEventContainer->GetStepProfiler())
 {
 }
 
@@ -58,19 +73,112 @@ G4TPCSteppingAction::~G4TPCSteppingAction()
 
 void G4TPCSteppingAction::UserSteppingAction(const G4Step *pG4Step)
 {
+    // ATTN : Aborting only stops the event after this step, the event action still runs and the event is written out flagged as aborted
+    if (m_pEventWatchdog && m_pEventWatchdog->Check())
+    {
+        std::ostringstream message;
+        message << "Event " << m_pEventContainer->GetEventNumber() << " exceeded its time budget after " << m_pEventWatchdog->GetWallTime()
+                << " s wall time, " << m_pEventWatchdog->GetCPUTime() << " s CPU time, aborting.  Random seed : " << m_pEventContainer->GetCurrentSeed();
+        Logger::Write(Logger::WARNING, message.str());
+        G4RunManager::GetRunManager()->AbortEvent();
+    }
+
     m_pG4TPCMCParticleUserAction->UserSteppingAction(pG4Step);
 
     // Collect energy and track length step by step
     G4VPhysicalVolume* pG4VPhysicalVolume = pG4Step->GetPreStepPoint()->GetTouchableHandle()->GetVolume();
 
-    if (pG4Step->GetTrack()->GetDefinition()->GetPDGCharge() == 0.)
+    if (m_pEventCostReport)
+        m_pEventCostReport->AddStep(pG4VPhysicalVolume == m_pG4TPCDetectorConstruction->GetLArPV());
+
+    if (m_pStepProfiler)
+        m_pStepProfiler->AddStep(pG4Step);
+
+    G4Track *pG4Track(pG4Step->GetTrack());
+
+    // ATTN : The stacking action only sees neutrons when they are created, so neutrons thermalising past the time window are killed here.
+    //        Anything produced in this step, such as capture gammas, is killed by the stacking action.
+    if (m_neutronTimeWindow > 0. && pG4Track->GetDefinition()->GetPDGEncoding() == 2112 &&
+        pG4Step->GetPostStepPoint()->GetGlobalTime() > m_neutronTimeWindow)
+    {
+        pG4Track->SetTrackStatus(fStopAndKill);
+        return;
+    }
+
+    if (pG4Track->GetDefinition()->GetPDGCharge() == 0.)
         return;
 
     if (pG4VPhysicalVolume == m_pG4TPCDetectorConstruction->GetLArPV())
     {
+        this->AddEnergyDeposition(pG4Step->GetPreStepPoint()->GetPosition(), pG4Step->GetPostStepPoint()->GetPosition(),
+            pG4Step->GetTotalEnergyDeposit(), pG4Step->GetTrack()->GetTrackID());
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void G4TPCSteppingAction::AddEnergyDeposition(const G4ThreeVector &position, const double energy, const int trackId)
+{
+    this->AddEnergyDeposition(position, position, energy, trackId);
+}
+
+//------------------------------------------------------------------------------
+
+void G4TPCSteppingAction::AddEnergyDeposition(const G4ThreeVector &preStepPosition, const G4ThreeVector &postStepPosition, const double energy,
+    const int trackId)
+{
+    // ATTN : Steps depositing no energy would only create empty cells, which are never written out, so neither path records them
+    if (energy <= 0.)
+        return;
+
+    if (m_useBatchedDeposits || m_useDepositArchive)
+    {
+        m_pEventContainer->GetCurrentDepositBuffer().Add(preStepPosition.x(), preStepPosition.y(), preStepPosition.z(), postStepPosition.x(),
+            postStepPosition.y(), postStepPosition.z(), energy, trackId);
+    }
+
+    if (m_useBatchedDeposits)
+        return;
+
+    // Every readout grid is filled from the same deposit
+    for (unsigned int gridIndex = 0; gridIndex < m_pG4TPCDetectorConstruction->GetNVoxelGrids(); gridIndex++)
+    {
+        const VoxelGrid &voxelGrid(m_pG4TPCDetectorConstruction->GetVoxelGrid(gridIndex));
+
+        // ATTN : Positions are voxelized at the float precision of the deposit buffer, so batching does not move boundary deposits between cells
         // ATTN : Cell is deleted if only used to add energy to pre-existing cell, retained otherwise
-        Cell *pCell = new Cell(m_pG4TPCDetectorConstruction->GetCell(pG4Step));
-        pCell->AddEnergy(pG4Step->GetTotalEnergyDeposit());
-        m_pEventContainer->GetCurrentCellList().AddEnergyDeposition(pCell, pG4Step->GetTrack()->GetTrackID());
+        Cell *pCell = new Cell(voxelGrid.GetCell(static_cast<float>(preStepPosition.x()), static_cast<float>(preStepPosition.y()),
+            static_cast<float>(preStepPosition.z())));
+        pCell->AddEnergy(energy);
+        m_pEventContainer->GetCurrentCellList(gridIndex).AddEnergyDeposition(pCell, trackId);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void G4TPCSteppingAction::AddContainedEnergyDeposition(const G4ThreeVector &position, const double energy, const int trackId)
+{
+    // ATTN : Every additional grid covers the default grid, so a position in the default grid is recorded as a normal deposit
+    if (m_pG4TPCDetectorConstruction->GetVoxelGrid().Contains(position.x(), position.y(), position.z()))
+    {
+        this->AddEnergyDeposition(position, energy, trackId);
+        return;
+    }
+
+    if (energy <= 0.)
+        return;
+
+    // ATTN : Additional grids may overhang the default grid.  Deposits there go straight to the cell lists of the grids containing them, as the
+    //        deposit buffer and archive are binned into every grid, where positions outside a grid would be clamped to its edge cells.
+    for (unsigned int gridIndex = 1; gridIndex < m_pG4TPCDetectorConstruction->GetNVoxelGrids(); gridIndex++)
+    {
+        const VoxelGrid &voxelGrid(m_pG4TPCDetectorConstruction->GetVoxelGrid(gridIndex));
+
+        if (!voxelGrid.Contains(position.x(), position.y(), position.z()))
+            continue;
+
+        Cell *pCell = new Cell(voxelGrid.GetCell(static_cast<float>(position.x()), static_cast<float>(position.y()), static_cast<float>(position.z())));
+        pCell->AddEnergy(energy);
+        m_pEventContainer->GetCurrentCellList(gridIndex).AddEnergyDeposition(pCell, trackId);
     }
 }
@@ -10,7 +10,7 @@
 
 #include "Objects/Cell.hh"
 
-Cell::Cell(const float x, const float y, const float z, const int idx) :
+Cell::Cell(const float x, const float y, const float z, const CellIndex idx) :
     m_idx(idx),
     m_x(x),
     m_y(y),
@@ -44,7 +44,7 @@ void CellList::AddEnergyDeposition(Cell *pCell, const int geantTrackId)
 {
     if (m_idCellMap.find(pCell->GetIdx()) == m_idCellMap.end())
     {
-        m_idCellMap.insert(IntCellMap::value_type(pCell->GetIdx(), pCell));
+        m_idCellMap.insert(CellIndexCellMap::value_type(pCell->GetIdx(), pCell));
 
         IntFloatVector mcToEnergyVector;
         mcToEnergyVector.push_back(IntFloatPair(geantTrackId, pCell->GetEnergy()));
@@ -54,7 +54,7 @@ void CellList::AddEnergyDeposition(Cell *pCell, const int geantTrackId)
     {
         m_idCellMap.at(pCell->GetIdx())->AddEnergy(pCell->GetEnergy());
 
-        IntFloatVector mcToEnergyVector(m_mcComponents.at(pCell->GetIdx()));
+        IntFloatVector &mcToEnergyVector(m_mcComponents.at(pCell->GetIdx()));
         auto it = std::find_if(mcToEnergyVector.begin(), mcToEnergyVector.end(), [&geantTrackId](IntFloatPair& iter){ return iter.first == geantTrackId;} );
 
         if (it == mcToEnergyVector.end())
@@ -70,3 +70,38 @@ void CellList::AddEnergyDeposition(Cell *pCell, const int geantTrackId)
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void CellList::AddEnergyDepositions(Cell *pCell, const IntFloatVector &mcComponents)
+{
+    CellIndexCellMap::iterator cellIter(m_idCellMap.lower_bound(pCell->GetIdx()));
+
+    if (cellIter == m_idCellMap.end() || cellIter->first != pCell->GetIdx())
+    {
+        m_idCellMap.insert(cellIter, CellIndexCellMap::value_type(pCell->GetIdx(), pCell));
+        m_mcComponents.insert(MCComponents::value_type(pCell->GetIdx(), mcComponents));
+    }
+    else
+    {
+        cellIter->second->AddEnergy(pCell->GetEnergy());
+
+        IntFloatVector &mcToEnergyVector(m_mcComponents.at(pCell->GetIdx()));
+
+        for (const IntFloatPair &mcComponent : mcComponents)
+        {
+            const int geantTrackId(mcComponent.first);
+            auto it = std::find_if(mcToEnergyVector.begin(), mcToEnergyVector.end(), [&geantTrackId](IntFloatPair& iter){ return iter.first == geantTrackId;} );
+
+            if (it == mcToEnergyVector.end())
+            {
+                mcToEnergyVector.push_back(mcComponent);
+            }
+            else
+            {
+                (*it).second += mcComponent.second;
+            }
+        }
+
+        delete pCell;
+    }
+}
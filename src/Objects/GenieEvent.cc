@@ -5,10 +5,22 @@
  *
  *  $Log: $
  */
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <string>
 #include <iostream>
 #include <limits>
 
+#include "G4BaryonConstructor.hh"
+#include "G4BosonConstructor.hh"
+#include "G4IonConstructor.hh"
+#include "G4LeptonConstructor.hh"
+#include "G4MesonConstructor.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4SystemOfUnits.hh"
+
 #include "Objects/GenieEvent.hh"
 
 GenieEvent::GenieEvent() :
@@ -16,7 +28,8 @@ GenieEvent::GenieEvent() :
     m_daughterTracks(TrackList()),
     m_vertexX(std::numeric_limits<double>::max()),
     m_vertexY(std::numeric_limits<double>::max()),
-    m_vertexZ(std::numeric_limits<double>::max())
+    m_vertexZ(std::numeric_limits<double>::max()),
+    m_sourceIndex(-1)
 {
 }
 
@@ -26,7 +39,8 @@ GenieEvent::GenieEvent(const GenieEvent &rhs) :
     m_nuanceCode(rhs.m_nuanceCode),
     m_vertexX(rhs.m_vertexX),
     m_vertexY(rhs.m_vertexY),
-    m_vertexZ(rhs.m_vertexZ)
+    m_vertexZ(rhs.m_vertexZ),
+    m_sourceIndex(rhs.m_sourceIndex)
 {
     m_pNeutrinoTrack = new Track(*(rhs.m_pNeutrinoTrack));
 
@@ -44,6 +58,7 @@ GenieEvent &GenieEvent::operator=(const GenieEvent &rhs)
         m_vertexX = rhs.m_vertexX;
         m_vertexY = rhs.m_vertexY;
         m_vertexZ = rhs.m_vertexZ;
+        m_sourceIndex = rhs.m_sourceIndex;
         m_pNeutrinoTrack = (rhs.m_pNeutrinoTrack ?  new Track(*(rhs.m_pNeutrinoTrack)) : nullptr);
 
         for (const Track *pDaughterTrack : rhs.m_daughterTracks)
@@ -65,6 +80,47 @@ GenieEvent::~GenieEvent()
     m_daughterTracks.clear();
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+double GenieEvent::GetVisibleEnergy() const
+{
+    double visibleEnergy(0.);
+
+    for (const Track *pDaughterTrack : m_daughterTracks)
+    {
+        const int absPdg(std::abs(pDaughterTrack->GetPDG()));
+
+        // ATTN : Neutrinos and neutrons leave the event without a track, and nuclear fragments are too heavy to travel far
+        if (absPdg == 12 || absPdg == 14 || absPdg == 16 || absPdg == 2112 || absPdg > 1000000000)
+            continue;
+
+        // ATTN : Species missing from the particle table are left out rather than counted with their rest mass
+        const G4ParticleDefinition *pG4ParticleDefinition(G4ParticleTable::GetParticleTable()->FindParticle(pDaughterTrack->GetPDG()));
+
+        if (!pG4ParticleDefinition)
+            continue;
+
+        // ATTN : Tracker file energies are total energies.  A neutral pion decays to photons depositing its total energy, so only the other
+        //        species have their rest mass subtracted.
+        const double mass(absPdg == 111 ? 0. : pG4ParticleDefinition->GetPDGMass() / GeV);
+        visibleEnergy += std::max(0., pDaughterTrack->GetEnergy() - mass);
+    }
+
+    return visibleEnergy;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void GenieEvent::ConstructParticleDefinitions()
+{
+    // ATTN : Constructing a particle that already exists returns the existing definition, so the physics list can construct them again
+    G4BosonConstructor::ConstructParticle();
+    G4LeptonConstructor::ConstructParticle();
+    G4MesonConstructor::ConstructParticle();
+    G4BaryonConstructor::ConstructParticle();
+    G4IonConstructor::ConstructParticle();
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
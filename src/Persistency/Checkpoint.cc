@@ -0,0 +1,97 @@
+/**
+ *  @file   src/Persistency/Checkpoint.cc
+ *
+ *  @brief  Implementation of the Checkpoint class.
+ *
+ *  $Log: $
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+#include "Persistency/Checkpoint.hh"
+
+#include "Randomize.hh"
+
+Checkpoint::Checkpoint(const std::string &fileName) :
+    m_fileName(fileName),
+    m_loaded(false),
+    m_nEventsCompleted(0),
+    m_outputPosition(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool Checkpoint::Load()
+{
+    std::ifstream checkpointFile(m_fileName);
+
+    if (!checkpointFile.is_open())
+        return false;
+
+    std::string nEventsCompletedKey, outputPositionKey;
+    int nEventsCompleted(0);
+    std::uint64_t outputPosition(0);
+    checkpointFile >> nEventsCompletedKey >> nEventsCompleted >> outputPositionKey >> outputPosition;
+
+    if (!checkpointFile || nEventsCompletedKey != "NEventsCompleted" || outputPositionKey != "OutputPosition")
+    {
+        std::cout << "Not a checkpoint : " << m_fileName << std::endl;
+        return false;
+    }
+
+    checkpointFile >> std::ws;
+    m_engineStatus.assign(std::istreambuf_iterator<char>(checkpointFile), std::istreambuf_iterator<char>());
+
+    m_loaded = true;
+    m_nEventsCompleted = nEventsCompleted;
+    m_outputPosition = outputPosition;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void Checkpoint::Save(const int nEventsCompleted, const std::uint64_t outputPosition)
+{
+    const std::string temporaryFileName(m_fileName + ".tmp");
+    std::ofstream checkpointFile(temporaryFileName, std::ios::trunc);
+
+    if (!checkpointFile.is_open())
+    {
+        std::cout << "Unable to write checkpoint : " << temporaryFileName << std::endl;
+        return;
+    }
+
+    checkpointFile << "NEventsCompleted " << nEventsCompleted << "\nOutputPosition " << outputPosition << "\n";
+    G4Random::getTheEngine()->put(checkpointFile);
+    checkpointFile.close();
+
+    if (!checkpointFile || std::rename(temporaryFileName.c_str(), m_fileName.c_str()) != 0)
+        std::cout << "Unable to write checkpoint : " << m_fileName << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void Checkpoint::RestoreEngineStatus() const
+{
+    if (!m_loaded)
+        return;
+
+    std::istringstream engineStatus(m_engineStatus);
+    G4Random::getTheEngine()->get(engineStatus);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void Checkpoint::Remove()
+{
+    std::remove(m_fileName.c_str());
+    m_loaded = false;
+    m_nEventsCompleted = 0;
+    m_outputPosition = 0;
+}
@@ -0,0 +1,268 @@
+/**
+ *  @file   src/Persistency/DepositArchive.cc
+ *
+ *  @brief  Implementation of the DepositArchiveWriter and DepositArchiveReader classes.
+ *
+ *  $Log: $
+ */
+
+#include <cstring>
+#include <iostream>
+
+#include <zlib.h>
+
+#include "ControlFlow/Logger.hh"
+#include "Persistency/DepositArchive.hh"
+
+namespace
+{
+
+template <typename T>
+void AppendArray(std::vector<char> &payload, const T *pData, const std::size_t nEntries)
+{
+    const std::size_t nBytes(nEntries * sizeof(T));
+    const std::size_t start(payload.size());
+    payload.resize(start + nBytes);
+
+    if (nBytes > 0)
+        std::memcpy(&payload[start], pData, nBytes);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+bool ExtractArray(const std::vector<char> &payload, std::size_t &position, T *pData, const std::size_t nEntries)
+{
+    const std::size_t nBytes(nEntries * sizeof(T));
+
+    if (position + nBytes > payload.size())
+        return false;
+
+    if (nBytes > 0)
+        std::memcpy(pData, &payload[position], nBytes);
+
+    position += nBytes;
+    return true;
+}
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+DepositArchiveWriter::DepositArchiveWriter(const std::string &fileName, const int compressionLevel) :
+    m_file(fileName, std::ios::binary | std::ios::trunc),
+    m_compressionLevel(compressionLevel),
+    m_nBytesWritten(0)
+{
+    if (!m_file.is_open())
+    {
+        std::cout << "Unable to open deposit archive for writing : " << fileName << std::endl;
+        return;
+    }
+
+    m_file.write(DepositArchive::MAGIC, sizeof(DepositArchive::MAGIC));
+    m_file.write(reinterpret_cast<const char*>(&DepositArchive::VERSION), sizeof(DepositArchive::VERSION));
+    m_nBytesWritten += sizeof(DepositArchive::MAGIC) + sizeof(DepositArchive::VERSION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+DepositArchiveWriter::~DepositArchiveWriter()
+{
+    m_file.close();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DepositArchiveWriter::WriteEvent(const int eventNumber, const DepositBuffer &depositBuffer, const MCParticleList &mcParticleList)
+{
+    if (!m_file.is_open())
+        return;
+
+    const std::size_t nDeposits(depositBuffer.Size());
+
+    m_payload.clear();
+    AppendArray(m_payload, depositBuffer.GetX().data(), nDeposits);
+    AppendArray(m_payload, depositBuffer.GetY().data(), nDeposits);
+    AppendArray(m_payload, depositBuffer.GetZ().data(), nDeposits);
+    AppendArray(m_payload, depositBuffer.GetPostX().data(), nDeposits);
+    AppendArray(m_payload, depositBuffer.GetPostY().data(), nDeposits);
+    AppendArray(m_payload, depositBuffer.GetPostZ().data(), nDeposits);
+    AppendArray(m_payload, depositBuffer.GetEnergy().data(), nDeposits);
+    AppendArray(m_payload, depositBuffer.GetTrackId().data(), nDeposits);
+
+    for (const auto &iter : mcParticleList.m_trackIdParentMap)
+    {
+        const std::int32_t link[2] = {iter.first, iter.second};
+        AppendArray(m_payload, link, 2);
+    }
+
+    for (const auto &iter : mcParticleList.m_mcParticles)
+    {
+        const std::int32_t trackId(iter.first);
+        AppendArray(m_payload, &trackId, 1);
+    }
+
+    uLongf compressedSize(compressBound(m_payload.size()));
+    m_compressedPayload.resize(compressedSize);
+
+    if (compress2(m_compressedPayload.data(), &compressedSize, reinterpret_cast<const Bytef*>(m_payload.data()), m_payload.size(), m_compressionLevel) != Z_OK)
+    {
+        Logger::Write(Logger::ERROR, "Failed to compress deposits for event " + std::to_string(eventNumber));
+        return;
+    }
+
+    DepositArchive::EventHeader eventHeader;
+    eventHeader.m_eventNumber = eventNumber;
+    eventHeader.m_nParentLinks = mcParticleList.m_trackIdParentMap.size();
+    eventHeader.m_nKnownParticles = mcParticleList.m_mcParticles.size();
+    eventHeader.m_padding = 0;
+    eventHeader.m_nDeposits = nDeposits;
+    eventHeader.m_compressedSize = compressedSize;
+    eventHeader.m_uncompressedSize = m_payload.size();
+
+    m_file.write(reinterpret_cast<const char*>(&eventHeader), sizeof(eventHeader));
+    m_file.write(reinterpret_cast<const char*>(m_compressedPayload.data()), compressedSize);
+    m_nBytesWritten += sizeof(eventHeader) + compressedSize;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+DepositArchiveReader::DepositArchiveReader(const std::string &fileName) :
+    m_file(fileName, std::ios::binary),
+    m_isValid(false)
+{
+    if (!m_file.is_open())
+    {
+        std::cout << "Unable to open deposit archive for reading : " << fileName << std::endl;
+        return;
+    }
+
+    char magic[sizeof(DepositArchive::MAGIC)];
+    std::uint32_t version(0);
+    m_file.read(magic, sizeof(magic));
+    m_file.read(reinterpret_cast<char*>(&version), sizeof(version));
+
+    if (!m_file || std::memcmp(magic, DepositArchive::MAGIC, sizeof(magic)) != 0 || version != DepositArchive::VERSION)
+    {
+        std::cout << "Not a deposit archive, or unsupported version : " << fileName << std::endl;
+        return;
+    }
+
+    const std::streamoff headerEnd(m_file.tellg());
+    m_file.seekg(0, std::ios::end);
+    const std::streamoff fileLength(m_file.tellg());
+    m_file.seekg(headerEnd);
+
+    // Index the event records by skipping over each compressed payload
+    DepositArchive::EventHeader eventHeader;
+
+    while (true)
+    {
+        const std::streamoff offset(m_file.tellg());
+
+        if (!m_file.read(reinterpret_cast<char*>(&eventHeader), sizeof(eventHeader)))
+            break;
+
+        const std::uint64_t nRemainingBytes(fileLength - offset - sizeof(eventHeader));
+
+        if (eventHeader.m_compressedSize > nRemainingBytes)
+        {
+            std::cout << "Truncated event record at end of deposit archive : " << fileName << std::endl;
+            break;
+        }
+
+        // ATTN : The payload sizes are checked before anything is allocated, so a corrupt header cannot request an arbitrarily large buffer.
+        //        zlib cannot compress by more than a factor of 1032, which bounds the uncompressed size by the file length.
+        const std::uint64_t maxUncompressedSize(1032 * eventHeader.m_compressedSize + 64);
+
+        if (eventHeader.m_uncompressedSize > maxUncompressedSize || eventHeader.m_nDeposits > eventHeader.m_uncompressedSize ||
+            eventHeader.m_uncompressedSize != DepositArchiveReader::GetPayloadSize(eventHeader))
+        {
+            std::cout << "Corrupt event record " << m_eventOffsets.size() << " in deposit archive : " << fileName << std::endl;
+            break;
+        }
+
+        m_file.seekg(eventHeader.m_compressedSize, std::ios::cur);
+
+        m_eventOffsets.push_back(offset);
+    }
+
+    m_file.clear();
+    m_isValid = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+DepositArchiveReader::~DepositArchiveReader()
+{
+    m_file.close();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::uint64_t DepositArchiveReader::GetPayloadSize(const DepositArchive::EventHeader &eventHeader)
+{
+    const std::uint64_t depositSize(6 * sizeof(float) + sizeof(float) + sizeof(int));
+    return eventHeader.m_nDeposits * depositSize + eventHeader.m_nParentLinks * 2 * sizeof(std::int32_t) +
+        eventHeader.m_nKnownParticles * sizeof(std::int32_t);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool DepositArchiveReader::ReadEvent(const unsigned int index, int &eventNumber, DepositBuffer &depositBuffer, IntIntMap &trackIdParentMap,
+    IntVector &knownParticles)
+{
+    if (!m_isValid || index >= m_eventOffsets.size())
+        return false;
+
+    DepositArchive::EventHeader eventHeader;
+    m_file.seekg(m_eventOffsets.at(index));
+    m_file.read(reinterpret_cast<char*>(&eventHeader), sizeof(eventHeader));
+
+    m_compressedPayload.resize(eventHeader.m_compressedSize);
+    m_file.read(reinterpret_cast<char*>(m_compressedPayload.data()), eventHeader.m_compressedSize);
+
+    if (!m_file)
+        return false;
+
+    uLongf uncompressedSize(eventHeader.m_uncompressedSize);
+    m_payload.resize(uncompressedSize);
+
+    if (uncompress(reinterpret_cast<Bytef*>(m_payload.data()), &uncompressedSize, m_compressedPayload.data(), eventHeader.m_compressedSize) != Z_OK ||
+        uncompressedSize != eventHeader.m_uncompressedSize)
+    {
+        std::cout << "Failed to decompress deposit archive record " << index << std::endl;
+        return false;
+    }
+
+    const std::size_t nDeposits(eventHeader.m_nDeposits);
+    depositBuffer.Resize(nDeposits);
+
+    std::size_t position(0);
+    bool success(true);
+    success = success && ExtractArray(m_payload, position, depositBuffer.m_x.data(), nDeposits);
+    success = success && ExtractArray(m_payload, position, depositBuffer.m_y.data(), nDeposits);
+    success = success && ExtractArray(m_payload, position, depositBuffer.m_z.data(), nDeposits);
+    success = success && ExtractArray(m_payload, position, depositBuffer.m_postX.data(), nDeposits);
+    success = success && ExtractArray(m_payload, position, depositBuffer.m_postY.data(), nDeposits);
+    success = success && ExtractArray(m_payload, position, depositBuffer.m_postZ.data(), nDeposits);
+    success = success && ExtractArray(m_payload, position, depositBuffer.m_energy.data(), nDeposits);
+    success = success && ExtractArray(m_payload, position, depositBuffer.m_trackId.data(), nDeposits);
+
+    trackIdParentMap.clear();
+
+    for (std::uint32_t link = 0; success && link < eventHeader.m_nParentLinks; ++link)
+    {
+        std::int32_t trackIdParent[2] = {0, 0};
+        success = ExtractArray(m_payload, position, trackIdParent, 2);
+        trackIdParentMap[trackIdParent[0]] = trackIdParent[1];
+    }
+
+    knownParticles.resize(eventHeader.m_nKnownParticles);
+    success = success && ExtractArray(m_payload, position, knownParticles.data(), knownParticles.size());
+
+    eventNumber = eventHeader.m_eventNumber;
+    return success;
+}
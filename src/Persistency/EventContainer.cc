@@ -6,19 +6,204 @@
  *  $Log: $
  */
 
+#include <chrono>
+#include <random>
+
+#include <unistd.h>
+
+#include "G4RunManager.hh"
+
+#include "Analysis/EventReducerFactory.hh"
+#include "ControlFlow/EventCostReport.hh"
+#include "ControlFlow/EventWatchdog.hh"
+#include "ControlFlow/Logger.hh"
+#include "ControlFlow/ProgressReporter.hh"
+#include "ControlFlow/StepProfiler.hh"
+#include "Persistency/Checkpoint.hh"
+#include "Persistency/DepositArchive.hh"
 #include "Persistency/EventContainer.hh"
+#include "Persistency/OverlayLibrary.hh"
+#include "Persistency/RandomSnapshot.hh"
+#include "Readout/VoxelGrid.hh"
 #include "Xml/tinyxml.hh"
 
 EventContainer::EventContainer(const InputParameters *pInputParameters) :
     m_eventNumber(0),
+    m_endEventNumber(0),
+    m_replayIndex(0),
+    m_pDepositArchive(nullptr),
+    m_pEventWatchdog(nullptr),
+    m_pEventCostReport(nullptr),
+    m_pStepProfiler(nullptr),
+    m_pProgressReporter(nullptr),
+    m_serializationTime(0.),
+    m_currentSeed(0),
+    m_pCheckpoint(nullptr),
+    m_pRandomSnapshotWriter(nullptr),
+    m_pRandomSnapshotReader(nullptr),
+    m_pSharedMemoryRing(nullptr),
+    m_pOverlayLibrary(nullptr),
     m_pInputParameters(pInputParameters)
 {
+    if (m_pInputParameters->GetUseDepositArchive())
+        m_pDepositArchive = new DepositArchiveWriter(m_pInputParameters->GetDepositArchiveFileName(), m_pInputParameters->GetDepositArchiveCompressionLevel());
+
+    if (m_pInputParameters->GetMaxEventWallTime() > 0. || m_pInputParameters->GetMaxEventCPUTime() > 0.)
+    {
+        m_pEventWatchdog = new EventWatchdog(m_pInputParameters->GetMaxEventWallTime(), m_pInputParameters->GetMaxEventCPUTime(),
+            m_pInputParameters->GetEventTimeBudgetCheckInterval());
+    }
+
+    if (m_pInputParameters->GetUseEventCostReport())
+        m_pEventCostReport = new EventCostReport(m_pInputParameters->GetEventCostReportFileName());
+
+    if (m_pInputParameters->GetUseStepProfiler())
+        m_pStepProfiler = new StepProfiler(m_pInputParameters->GetStepProfilerFileName(), m_pInputParameters->GetStepProfilerNRows());
+
+    if (m_pInputParameters->GetProgressInterval() > 0.)
+        m_pProgressReporter = new ProgressReporter(m_pInputParameters->GetProgressInterval());
+
+    if (m_pInputParameters->GetUseCheckpoint())
+    {
+        m_pCheckpoint = new Checkpoint(m_pInputParameters->GetCheckpointFileName());
+        m_pCheckpoint->Load();
+    }
+
+    if (m_pInputParameters->GetUseRandomSnapshots())
+        m_pRandomSnapshotWriter = new RandomSnapshotWriter(m_pInputParameters->GetRandomSnapshotFileName());
+
+    if (m_pInputParameters->GetUseReplay())
+        m_pRandomSnapshotReader = new RandomSnapshotReader(m_pInputParameters->GetReplaySnapshotFileName());
+
+    for (const EventReducerParameters &eventReducerParameters : m_pInputParameters->GetEventReducers())
+    {
+        EventReducer *pEventReducer(EventReducerFactory::Create(eventReducerParameters));
+
+        if (pEventReducer)
+            m_eventReducers.push_back(pEventReducer);
+    }
+
+    // ATTN : The shared memory ring is only built on linux, elsewhere the input parameters reject the shared memory output
+#ifdef G4TPC_SHARED_MEMORY_RING
+    if (m_pInputParameters->GetUseSharedMemoryOutput())
+    {
+        const double timeout(m_pInputParameters->GetSharedMemoryTimeout());
+        m_pSharedMemoryRing = new SharedMemoryRingWriter(m_pInputParameters->GetSharedMemoryName(),
+            static_cast<std::uint64_t>(m_pInputParameters->GetSharedMemoryCapacity()) * 1024 * 1024, timeout < 0. ? -1 : static_cast<int>(timeout * 1000.));
+
+        if (!m_pSharedMemoryRing->IsValid())
+        {
+            Logger::Write(Logger::WARNING, "Shared memory output disabled");
+            delete m_pSharedMemoryRing;
+            m_pSharedMemoryRing = nullptr;
+        }
+    }
+#endif
+
+    if (m_pInputParameters->GetUseOverlay())
+    {
+        m_pOverlayLibrary = new OverlayLibrary(m_pInputParameters->GetOverlayLibraryFileName());
+
+        if (!m_pOverlayLibrary->IsValid())
+        {
+            delete m_pOverlayLibrary;
+            m_pOverlayLibrary = nullptr;
+        }
+    }
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
 EventContainer::~EventContainer()
 {
+    delete m_pDepositArchive;
+    delete m_pEventWatchdog;
+    delete m_pEventCostReport;
+    delete m_pStepProfiler;
+    delete m_pProgressReporter;
+    delete m_pCheckpoint;
+    delete m_pRandomSnapshotWriter;
+    delete m_pRandomSnapshotReader;
+#ifdef G4TPC_SHARED_MEMORY_RING
+    delete m_pSharedMemoryRing;
+#endif
+    delete m_pOverlayLibrary;
+
+    for (EventReducer *pEventReducer : m_eventReducers)
+        delete pEventReducer;
+
+    this->DeleteEvents();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void EventContainer::BeginOfRunAction(const int nEventsToProcess)
+{
+    this->DeleteEvents();
+    m_depositBuffer.Clear();
+
+    // ATTN : A resumed run continues from the first event after the checkpoint, with the random engine as it was at the checkpoint
+    const bool resume(m_pCheckpoint && m_pCheckpoint->IsLoaded());
+    m_eventNumber = resume ? m_pCheckpoint->GetNEventsCompleted() : 0;
+    m_endEventNumber = m_eventNumber + nEventsToProcess;
+    m_replayIndex = 0;
+
+    if (m_pRandomSnapshotReader)
+        m_eventNumber = m_pInputParameters->GetReplayEvents().front();
+
+    if (resume)
+    {
+        std::cout << "Resuming from checkpoint after event " << m_eventNumber << std::endl;
+        m_pCheckpoint->RestoreEngineStatus();
+    }
+
+    if (!m_pInputParameters->GetStreamOutput() || !m_pInputParameters->GetWriteEventOutput())
+        return;
+
+    const std::string fileName(m_pInputParameters->GetOutputXmlFileName());
+
+    // ATTN : Events written after the checkpoint are discarded, the resumed run writes them again
+    if (resume && truncate(fileName.c_str(), m_pCheckpoint->GetOutputPosition()) != 0)
+        std::cout << "Unable to truncate output file to the checkpoint : " << fileName << std::endl;
+
+    m_outputFile.open(fileName, resume ? std::ios::app : std::ios::trunc);
+
+    if (!m_outputFile.is_open())
+    {
+        std::cout << "Unable to open output file : " << fileName << std::endl;
+        return;
+    }
+
+    if (!resume)
+        m_outputFile << "<Run>\n";
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void EventContainer::DeleteEvents()
+{
+    // ATTN : The event container is the only owner of the cells and MC particles once an event has ended
+    for (CellListVector &cellLists : m_cells)
+    {
+        for (CellList &cellList : cellLists)
+        {
+            for (const auto &iter : cellList.m_idCellMap)
+                delete iter.second;
+        }
+    }
+
+    for (MCParticleList &mcParticleList : m_mcParticles)
+    {
+        for (const auto &iter : mcParticleList.m_mcParticles)
+            delete iter.second;
+    }
+
+    m_mcParticles.clear();
+    m_cells.clear();
+    m_eventNumbers.clear();
+    m_seeds.clear();
+    m_abortedEvents.clear();
+    m_overlaidEvents.clear();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
@@ -26,104 +211,433 @@ EventContainer::~EventContainer()
 void EventContainer::BeginOfEventAction()
 {
     m_mcParticles.push_back(MCParticleList());
-    m_cells.push_back(CellList());
+    // ATTN : One cell list for the default readout, then one per additional readout grid
+    m_cells.push_back(CellListVector(1 + m_pInputParameters->GetReadoutGrids().size()));
+    m_eventNumbers.push_back(m_eventNumber);
+    m_seeds.push_back(m_currentSeed);
+    m_abortedEvents.push_back(false);
+    m_overlaidEvents.push_back(OverlaidEventVector());
+
+    if (m_pOverlayLibrary)
+        this->SampleOverlay();
+
+    if (m_pEventWatchdog)
+        m_pEventWatchdog->Start();
+
+    if (m_pEventCostReport)
+        m_pEventCostReport->BeginOfEvent();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
 void EventContainer::EndOfEventAction()
 {
-    m_eventNumber++;
+    if (m_eventCallback)
+    {
+        EventView eventView;
+        eventView.m_eventNumber = m_eventNumber;
+        eventView.m_seed = m_seeds.back();
+        eventView.m_aborted = m_abortedEvents.back();
+        eventView.m_pCellLists = &m_cells.back();
+        eventView.m_pMCParticleList = &m_mcParticles.back();
+        m_eventCallback(eventView);
+    }
+
+#ifdef G4TPC_SHARED_MEMORY_RING
+    if (m_pSharedMemoryRing)
+    {
+        const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+        this->WriteSharedMemoryEvent();
+        m_serializationTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+#endif
+
+    const std::uint64_t nBytesWritten(m_pDepositArchive ? m_pDepositArchive->GetNBytesWritten() : 0);
+
+    if (m_pDepositArchive)
+    {
+        const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+        m_pDepositArchive->WriteEvent(m_eventNumber, m_depositBuffer, this->GetCurrentMCParticleList());
+        m_serializationTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::uint64_t nXmlBytesWritten(0);
+
+    if (m_outputFile.is_open())
+    {
+        const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+        const std::streampos startPosition(m_outputFile.tellp());
+
+        TiXmlElement *pEventTiXmlElement(this->CreateEventXml(m_cells.size() - 1));
+        TiXmlPrinter tiXmlPrinter;
+        pEventTiXmlElement->Accept(&tiXmlPrinter);
+        delete pEventTiXmlElement;
+
+        m_outputFile.write(tiXmlPrinter.CStr(), tiXmlPrinter.Size());
+        nXmlBytesWritten = m_outputFile.tellp() - startPosition;
+        m_serializationTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    if (m_pEventCostReport)
+    {
+        std::size_t nCells(0);
+
+        for (const CellList &cellList : m_cells.back())
+            nCells += cellList.m_idCellMap.size();
+
+        // ATTN : Unless the output is streamed, the xml output is only written at the end of the run, so only the deposit archive counts
+        m_pEventCostReport->EndOfEvent(m_eventNumber, this->GetCurrentMCParticleList().m_mcParticles.size(), nCells,
+            (m_pDepositArchive ? m_pDepositArchive->GetNBytesWritten() : 0) - nBytesWritten + nXmlBytesWritten);
+    }
+
+    if (m_pProgressReporter)
+        m_pProgressReporter->EndOfEvent();
+
+    m_depositBuffer.Clear();
+
+    if (m_pRandomSnapshotReader)
+    {
+        const std::vector<int> &replayEvents(m_pInputParameters->GetReplayEvents());
+        m_replayIndex++;
+        m_eventNumber = (m_replayIndex < replayEvents.size()) ? replayEvents.at(m_replayIndex) : m_eventNumber + 1;
+    }
+    else
+    {
+        m_eventNumber++;
+    }
+
+    if (!m_outputFile.is_open() && m_pInputParameters->GetWriteEventOutput())
+        return;
+
+    // ATTN : A streamed event is no longer needed once written, nor is any event once reduced when there is no event output, so the
+    //        container only ever holds the current event
+    this->DeleteEvents();
+
+    // ATTN : No checkpoint after the last event, as a job resumed with no events left would never complete the output file
+    if (m_pCheckpoint && (m_eventNumber < m_endEventNumber) && (m_eventNumber % m_pInputParameters->GetCheckpointInterval() == 0))
+    {
+        m_outputFile.flush();
+        m_pCheckpoint->Save(m_eventNumber, m_outputFile.tellp());
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void EventContainer::ReduceDeposits(const VoxelGrid &voxelGrid, const unsigned int gridIndex)
+{
+    // ATTN : Without batched deposits the cells were filled step by step and the buffer, if used, only feeds the deposit archive
+    if (m_pInputParameters->GetUseBatchedDeposits())
+        m_depositBuffer.Reduce(voxelGrid, this->GetCurrentCellList(gridIndex));
+
+    // ATTN : Overlaid deposits are kept apart from the deposit buffer, so they are never written to the deposit archive
+    m_overlayBuffer.Reduce(voxelGrid, this->GetCurrentCellList(gridIndex));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------ 
 
 void EventContainer::SaveXml()
 {
+    const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+
+    if (m_outputFile.is_open())
+    {
+        m_outputFile << "</Run>\n";
+        m_outputFile.close();
+
+        if (m_pCheckpoint)
+            m_pCheckpoint->Remove();
+
+        m_serializationTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return;
+    }
+
+    if (!m_pInputParameters->GetWriteEventOutput())
+        return;
+
     TiXmlDocument tiXmlDocument;
 
     TiXmlElement *pRunTiXmlElement = new TiXmlElement("Run");
     tiXmlDocument.LinkEndChild(pRunTiXmlElement);
 
-    for (int eventNumber = 0; eventNumber < m_eventNumber; eventNumber++)
+    for (unsigned int eventIndex = 0; eventIndex < m_cells.size(); eventIndex++)
+        pRunTiXmlElement->LinkEndChild(this->CreateEventXml(eventIndex));
+
+    tiXmlDocument.SaveFile(m_pInputParameters->GetOutputXmlFileName());
+    tiXmlDocument.Clear();
+    m_serializationTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+TiXmlElement *EventContainer::CreateEventXml(const unsigned int eventIndex) const
+{
+    TiXmlElement *pEventTiXmlElement = new TiXmlElement("Event");
+    pEventTiXmlElement->SetAttribute("Number", m_eventNumbers.at(eventIndex));
+    pEventTiXmlElement->SetAttribute("Seed", std::to_string(m_seeds.at(eventIndex)));
+
+    // ATTN : Filtered genie events are not simulated, so the event number is mapped back to the index in the tracker file
+    if (m_pInputParameters->GetUseGenieInput())
+        pEventTiXmlElement->SetAttribute("GenieIndex", m_pInputParameters->GetGenieSourceIndex(m_eventNumbers.at(eventIndex)));
+
+    // ATTN : Aborted events hold whatever was simulated before the abort, so must not be used as complete events
+    if (m_abortedEvents.at(eventIndex))
+        pEventTiXmlElement->SetAttribute("Aborted", 1);
+
+    const CellListVector &cellLists(m_cells.at(eventIndex));
+    const MCParticleList &mcParticleList(m_mcParticles.at(eventIndex));
+
+    // Cells
+    EventContainer::WriteCellsXml(cellLists.front(), mcParticleList, pEventTiXmlElement);
+
+    // Cells for additional readout grids
+    const ReadoutGridParametersVector &readoutGrids(m_pInputParameters->GetReadoutGrids());
+
+    for (unsigned int gridIndex = 0; gridIndex < readoutGrids.size(); gridIndex++)
+    {
+        TiXmlElement *pGridTiXmlElement = new TiXmlElement("ReadoutGrid");
+        pGridTiXmlElement->SetAttribute("Name", readoutGrids.at(gridIndex).m_name);
+        pGridTiXmlElement->SetDoubleAttribute("CellSize", readoutGrids.at(gridIndex).m_cellSize);
+        pEventTiXmlElement->LinkEndChild(pGridTiXmlElement);
+
+        EventContainer::WriteCellsXml(cellLists.at(gridIndex + 1), mcParticleList, pGridTiXmlElement);
+    }
+
+    // Overlaid background events, whose cell contributions are labelled by the negative track id of each overlaid event
+    for (const OverlaidEvent &overlaidEvent : m_overlaidEvents.at(eventIndex))
+    {
+        TiXmlElement *pTiXmlElement = new TiXmlElement("Overlay");
+        pTiXmlElement->SetAttribute("Id", overlaidEvent.m_trackId);
+        pTiXmlElement->SetAttribute("LibraryEventNumber", overlaidEvent.m_libraryEventNumber);
+        pTiXmlElement->SetDoubleAttribute("TimeShift", overlaidEvent.m_timeShift);
+        pTiXmlElement->SetDoubleAttribute("ShiftX", overlaidEvent.m_shiftX);
+        pTiXmlElement->SetDoubleAttribute("ShiftY", overlaidEvent.m_shiftY);
+        pTiXmlElement->SetDoubleAttribute("ShiftZ", overlaidEvent.m_shiftZ);
+        pEventTiXmlElement->LinkEndChild(pTiXmlElement);
+    }
+
+    // MCParticles, with their full trajectories for events replayed in detail
+    const bool writeTrajectories(m_pRandomSnapshotReader && m_pInputParameters->GetReplayDetailedTrajectories());
+
+    for (const auto iter : mcParticleList.m_mcParticles)
+    {
+        const MCParticle *pMCParticle(iter.second);
+
+        TiXmlElement *pTiXmlElement = new TiXmlElement("MCParticle");
+        pTiXmlElement->SetAttribute("Id", pMCParticle->GetTrackId());
+        pTiXmlElement->SetAttribute("PDG", pMCParticle->GetPDGCode());
+        pTiXmlElement->SetAttribute("ParentId", pMCParticle->GetParent());
+        pTiXmlElement->SetDoubleAttribute("Mass", pMCParticle->GetMass());
+        pTiXmlElement->SetDoubleAttribute("Energy", pMCParticle->GetEnergy());
+        pTiXmlElement->SetDoubleAttribute("StartX", pMCParticle->GetPositionX());
+        pTiXmlElement->SetDoubleAttribute("StartY", pMCParticle->GetPositionY());
+        pTiXmlElement->SetDoubleAttribute("StartZ", pMCParticle->GetPositionZ());
+        pTiXmlElement->SetDoubleAttribute("EndX", pMCParticle->GetEndPositionX());
+        pTiXmlElement->SetDoubleAttribute("EndY", pMCParticle->GetEndPositionY());
+        pTiXmlElement->SetDoubleAttribute("EndZ", pMCParticle->GetEndPositionZ());
+        pTiXmlElement->SetDoubleAttribute("MomentumX", pMCParticle->GetMomentumX());
+        pTiXmlElement->SetDoubleAttribute("MomentumY", pMCParticle->GetMomentumY());
+        pTiXmlElement->SetDoubleAttribute("MomentumZ", pMCParticle->GetMomentumZ());
+        pEventTiXmlElement->LinkEndChild(pTiXmlElement);
+
+        if (!writeTrajectories)
+            continue;
+
+        for (int point = 0; point < pMCParticle->GetNumberOfTrajectoryPoints(); point++)
+        {
+            TiXmlElement *pPointTiXmlElement = new TiXmlElement("TrajectoryPoint");
+            pPointTiXmlElement->SetDoubleAttribute("X", pMCParticle->GetPositionX(point));
+            pPointTiXmlElement->SetDoubleAttribute("Y", pMCParticle->GetPositionY(point));
+            pPointTiXmlElement->SetDoubleAttribute("Z", pMCParticle->GetPositionZ(point));
+            pPointTiXmlElement->SetDoubleAttribute("T", pMCParticle->GetTime(point));
+            pPointTiXmlElement->SetDoubleAttribute("MomentumX", pMCParticle->GetMomentumX(point));
+            pPointTiXmlElement->SetDoubleAttribute("MomentumY", pMCParticle->GetMomentumY(point));
+            pPointTiXmlElement->SetDoubleAttribute("MomentumZ", pMCParticle->GetMomentumZ(point));
+            pPointTiXmlElement->SetDoubleAttribute("Energy", pMCParticle->GetEnergy(point));
+            pTiXmlElement->LinkEndChild(pPointTiXmlElement);
+        }
+    }
+
+    return pEventTiXmlElement;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void EventContainer::WriteCellsXml(const CellList &cellList, const MCParticleList &mcParticleList, TiXmlElement *pEventTiXmlElement)
+{
+    for (const auto iter : cellList.m_idCellMap)
+    {
+        const Cell *pCell(iter.second);
+        int mainVisibleMCTrackId(0);
+
+        if (!EventContainer::GetMainVisibleMCTrackId(cellList, pCell, mcParticleList, mainVisibleMCTrackId))
+            continue;
+
+        TiXmlElement *pTiXmlElement = new TiXmlElement("Cell");
+        pTiXmlElement->SetAttribute("Id", std::to_string(pCell->GetIdx()));
+        pTiXmlElement->SetAttribute("MCId", mainVisibleMCTrackId);
+        pTiXmlElement->SetDoubleAttribute("X", pCell->GetX());
+        pTiXmlElement->SetDoubleAttribute("Y", pCell->GetY());
+        pTiXmlElement->SetDoubleAttribute("Z", pCell->GetZ());
+        pTiXmlElement->SetDoubleAttribute("Energy", pCell->GetEnergy());
+        pEventTiXmlElement->LinkEndChild(pTiXmlElement);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+#ifdef G4TPC_SHARED_MEMORY_RING
+void EventContainer::WriteSharedMemoryEvent()
+{
+    const CellList &cellList(m_cells.back().front());
+    const MCParticleList &mcParticleList(m_mcParticles.back());
+
+    m_cellRecords.clear();
+    m_mcParticleRecords.clear();
+
+    for (const auto iter : cellList.m_idCellMap)
+    {
+        const Cell *pCell(iter.second);
+        int mainVisibleMCTrackId(0);
+
+        if (!EventContainer::GetMainVisibleMCTrackId(cellList, pCell, mcParticleList, mainVisibleMCTrackId))
+            continue;
+
+        SharedMemoryRing::CellRecord cellRecord;
+        cellRecord.m_id = pCell->GetIdx();
+        cellRecord.m_x = pCell->GetX();
+        cellRecord.m_y = pCell->GetY();
+        cellRecord.m_z = pCell->GetZ();
+        cellRecord.m_energy = pCell->GetEnergy();
+        cellRecord.m_mcId = mainVisibleMCTrackId;
+        cellRecord.m_padding = 0;
+        m_cellRecords.push_back(cellRecord);
+    }
+
+    for (const auto iter : mcParticleList.m_mcParticles)
+    {
+        const MCParticle *pMCParticle(iter.second);
+
+        SharedMemoryRing::MCParticleRecord mcParticleRecord;
+        mcParticleRecord.m_id = pMCParticle->GetTrackId();
+        mcParticleRecord.m_pdg = pMCParticle->GetPDGCode();
+        mcParticleRecord.m_parentId = pMCParticle->GetParent();
+        mcParticleRecord.m_padding = 0;
+        mcParticleRecord.m_mass = pMCParticle->GetMass();
+        mcParticleRecord.m_energy = pMCParticle->GetEnergy();
+        mcParticleRecord.m_startX = pMCParticle->GetPositionX();
+        mcParticleRecord.m_startY = pMCParticle->GetPositionY();
+        mcParticleRecord.m_startZ = pMCParticle->GetPositionZ();
+        mcParticleRecord.m_endX = pMCParticle->GetEndPositionX();
+        mcParticleRecord.m_endY = pMCParticle->GetEndPositionY();
+        mcParticleRecord.m_endZ = pMCParticle->GetEndPositionZ();
+        mcParticleRecord.m_momentumX = pMCParticle->GetMomentumX();
+        mcParticleRecord.m_momentumY = pMCParticle->GetMomentumY();
+        mcParticleRecord.m_momentumZ = pMCParticle->GetMomentumZ();
+        m_mcParticleRecords.push_back(mcParticleRecord);
+    }
+
+    const SharedMemoryRing::WriteResult writeResult(m_pSharedMemoryRing->WriteEvent(m_eventNumber, m_seeds.back(), m_abortedEvents.back(),
+        m_cellRecords.data(), m_cellRecords.size(), m_mcParticleRecords.data(), m_mcParticleRecords.size()));
+
+    if (writeResult == SharedMemoryRing::TOO_LARGE)
+    {
+        Logger::Write(Logger::WARNING, "Event " + std::to_string(m_eventNumber) + " is too large for the shared memory ring, not written");
+    }
+    else if (writeResult == SharedMemoryRing::TIMED_OUT && m_pInputParameters->GetSharedMemoryDropOnTimeout())
+    {
+        Logger::Write(Logger::WARNING, "Shared memory ring reader did not release space in time, event " + std::to_string(m_eventNumber) + " dropped");
+    }
+    else if (writeResult == SharedMemoryRing::TIMED_OUT)
+    {
+        // ATTN : The run ends after this event, with the outputs written so far closed as normal
+        Logger::Write(Logger::ERROR, "Shared memory ring reader did not release space in time for event " + std::to_string(m_eventNumber) +
+            ", stopping the run");
+        G4RunManager::GetRunManager()->AbortRun(true);
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+void EventContainer::SampleOverlay()
+{
+    m_overlayBuffer.Clear();
+
+    // ATTN : The overlay has a generator of its own, seeded from the event, so it does not change the random numbers used to simulate the
+    //        event and a replayed event gets the same overlay
+    const std::uint64_t seed(static_cast<std::uint64_t>(m_seeds.back()));
+    std::seed_seq seedSequence{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32), static_cast<std::uint32_t>(m_eventNumber)};
+    std::mt19937_64 generator(seedSequence);
+    std::uniform_int_distribution<unsigned int> libraryIndex(0, m_pOverlayLibrary->GetNEvents() - 1);
+    std::uniform_real_distribution<float> uniform(-0.5f, 0.5f);
+
+    const float lowEdge[3] = {static_cast<float>(m_pInputParameters->GetCenterX() - 0.5 * m_pInputParameters->GetWidthX()),
+        static_cast<float>(m_pInputParameters->GetCenterY() - 0.5 * m_pInputParameters->GetWidthY()),
+        static_cast<float>(m_pInputParameters->GetCenterZ() - 0.5 * m_pInputParameters->GetWidthZ())};
+    const float highEdge[3] = {static_cast<float>(lowEdge[0] + m_pInputParameters->GetWidthX()),
+        static_cast<float>(lowEdge[1] + m_pInputParameters->GetWidthY()), static_cast<float>(lowEdge[2] + m_pInputParameters->GetWidthZ())};
+
+    OverlaidEventVector &overlaidEvents(m_overlaidEvents.back());
+
+    for (int overlay = 0; overlay < m_pInputParameters->GetOverlayNEvents(); overlay++)
     {
-        TiXmlElement *pEventTiXmlElement = new TiXmlElement("Event");
-        pRunTiXmlElement->LinkEndChild(pEventTiXmlElement);
+        const unsigned int index(libraryIndex(generator));
 
-        const CellList &cellList(m_cells.at(eventNumber));
-        const MCParticleList &mcParticleList(m_mcParticles.at(eventNumber));
+        // A background event arriving earlier or later than the event is displaced along the drift direction
+        OverlaidEvent overlaidEvent;
+        overlaidEvent.m_trackId = -(overlay + 1);
+        overlaidEvent.m_libraryEventNumber = m_pOverlayLibrary->GetEventNumber(index);
+        overlaidEvent.m_timeShift = m_pInputParameters->GetOverlayTimeWindow() * uniform(generator);
+        overlaidEvent.m_shiftX = m_pInputParameters->GetOverlayDriftVelocity() * overlaidEvent.m_timeShift;
+        overlaidEvent.m_shiftY = 2. * m_pInputParameters->GetOverlayMaxShiftY() * uniform(generator);
+        overlaidEvent.m_shiftZ = 2. * m_pInputParameters->GetOverlayMaxShiftZ() * uniform(generator);
+        overlaidEvents.push_back(overlaidEvent);
 
-        // Cells
-        for (const auto iter : cellList.m_idCellMap)
+        m_pOverlayLibrary->AddShiftedEvent(index, overlaidEvent.m_shiftX, overlaidEvent.m_shiftY, overlaidEvent.m_shiftZ, lowEdge, highEdge,
+            overlaidEvent.m_trackId, m_overlayBuffer);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------ 
+
+bool EventContainer::GetMainVisibleMCTrackId(const CellList &cellList, const Cell *pCell, const MCParticleList &mcParticleList,
+    int &mainVisibleMCTrackId)
+{
+    const IntFloatVector &trackIdToEnergy(cellList.m_mcComponents.at(pCell->GetIdx()));
+
+    // ATTN : Doesn't account for track ID offset, but not using for now
+    int mainMCTrackId(-1);
+    float largestEnergyContribution(0.f);
+    for (const auto contribution : trackIdToEnergy)
+    {
+        if (contribution.second > largestEnergyContribution)
         {
-            const Cell *pCell(iter.second);
-
-            IntFloatVector trackIdToEnergy(cellList.m_mcComponents.at(pCell->GetIdx()));
-
-            // ATTN : Doesn't account for track ID offset, but not using for now
-            int mainMCTrackId(-1);
-            float largestEnergyContribution(0.f);
-            for (const auto contribution : trackIdToEnergy)
-            {
-                if (contribution.second > largestEnergyContribution)
-                {
-                    largestEnergyContribution = contribution.second;
-                    mainMCTrackId = contribution.first;
-                }
-            }
-
-            if (largestEnergyContribution < std::numeric_limits<float>::epsilon())
-                continue;
-
-            int mainVisibleMCTrackId(mainMCTrackId);
-            while (!mcParticleList.KnownParticle(mainVisibleMCTrackId))
-            {
-                if (mcParticleList.m_trackIdParentMap.find(mainVisibleMCTrackId) != mcParticleList.m_trackIdParentMap.end())
-                {
-                    mainVisibleMCTrackId = mcParticleList.m_trackIdParentMap.at(mainVisibleMCTrackId);
-                }
-                else
-                {
-                    mainVisibleMCTrackId = 0;
-                    break;
-                }
-            }
-
-            TiXmlElement *pTiXmlElement = new TiXmlElement("Cell");
-            pTiXmlElement->SetAttribute("Id", pCell->GetIdx());
-            pTiXmlElement->SetAttribute("MCId", mainVisibleMCTrackId);
-            pTiXmlElement->SetDoubleAttribute("X", pCell->GetX());
-            pTiXmlElement->SetDoubleAttribute("Y", pCell->GetY());
-            pTiXmlElement->SetDoubleAttribute("Z", pCell->GetZ());
-            pTiXmlElement->SetDoubleAttribute("Energy", pCell->GetEnergy());
-            pEventTiXmlElement->LinkEndChild(pTiXmlElement);
+            largestEnergyContribution = contribution.second;
+            mainMCTrackId = contribution.first;
         }
+    }
+
+    if (largestEnergyContribution < std::numeric_limits<float>::epsilon())
+        return false;
+
+    // ATTN : Negative track ids label overlaid background events, which have no MC particles
+    mainVisibleMCTrackId = mainMCTrackId;
+
+    if (mainMCTrackId < 0)
+        return true;
 
-        // MCParticles
-        for (const auto iter : mcParticleList.m_mcParticles)
+    while (!mcParticleList.KnownParticle(mainVisibleMCTrackId))
+    {
+        if (mcParticleList.m_trackIdParentMap.find(mainVisibleMCTrackId) != mcParticleList.m_trackIdParentMap.end())
+        {
+            mainVisibleMCTrackId = mcParticleList.m_trackIdParentMap.at(mainVisibleMCTrackId);
+        }
+        else
         {
-            const MCParticle *pMCParticle(iter.second);
-
-            TiXmlElement *pTiXmlElement = new TiXmlElement("MCParticle");
-            pTiXmlElement->SetAttribute("Id", pMCParticle->GetTrackId());
-            pTiXmlElement->SetAttribute("PDG", pMCParticle->GetPDGCode());
-            pTiXmlElement->SetAttribute("ParentId", pMCParticle->GetParent());
-            pTiXmlElement->SetDoubleAttribute("Mass", pMCParticle->GetMass());
-            pTiXmlElement->SetDoubleAttribute("Energy", pMCParticle->GetEnergy());
-            pTiXmlElement->SetDoubleAttribute("StartX", pMCParticle->GetPositionX());
-            pTiXmlElement->SetDoubleAttribute("StartY", pMCParticle->GetPositionY());
-            pTiXmlElement->SetDoubleAttribute("StartZ", pMCParticle->GetPositionZ());
-            pTiXmlElement->SetDoubleAttribute("EndX", pMCParticle->GetEndPositionX());
-            pTiXmlElement->SetDoubleAttribute("EndY", pMCParticle->GetEndPositionY());
-            pTiXmlElement->SetDoubleAttribute("EndZ", pMCParticle->GetEndPositionZ());
-            pTiXmlElement->SetDoubleAttribute("MomentumX", pMCParticle->GetMomentumX());
-            pTiXmlElement->SetDoubleAttribute("MomentumY", pMCParticle->GetMomentumY());
-            pTiXmlElement->SetDoubleAttribute("MomentumZ", pMCParticle->GetMomentumZ());
-            pEventTiXmlElement->LinkEndChild(pTiXmlElement);
+            mainVisibleMCTrackId = 0;
+            break;
         }
     }
 
-    tiXmlDocument.SaveFile(m_pInputParameters->GetOutputXmlFileName());
-    tiXmlDocument.Clear();
+    return true;
 }
-
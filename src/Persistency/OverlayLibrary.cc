@@ -0,0 +1,76 @@
+/**
+ *  @file   src/Persistency/OverlayLibrary.cc
+ *
+ *  @brief  Implementation of the OverlayLibrary class.
+ *
+ *  $Log: $
+ */
+
+#include <iostream>
+
+#include "Persistency/DepositArchive.hh"
+#include "Persistency/OverlayLibrary.hh"
+
+OverlayLibrary::OverlayLibrary(const std::string &fileName) :
+    m_isValid(false)
+{
+    DepositArchiveReader depositArchiveReader(fileName);
+
+    if (!depositArchiveReader.IsValid())
+        return;
+
+    m_events.resize(depositArchiveReader.GetNEvents());
+    m_eventNumbers.resize(depositArchiveReader.GetNEvents());
+
+    // ATTN : The parent links and kept particles are not needed, every overlay deposit is labelled with the overlay track id
+    IntIntMap trackIdParentMap;
+    IntVector knownParticles;
+
+    for (unsigned int index = 0; index < depositArchiveReader.GetNEvents(); ++index)
+    {
+        if (!depositArchiveReader.ReadEvent(index, m_eventNumbers.at(index), m_events.at(index), trackIdParentMap, knownParticles))
+        {
+            std::cout << "Unable to read overlay library event " << index << " from " << fileName << std::endl;
+            m_events.clear();
+            m_eventNumbers.clear();
+            return;
+        }
+    }
+
+    if (m_events.empty())
+    {
+        std::cout << "Overlay library has no events : " << fileName << std::endl;
+        return;
+    }
+
+    m_isValid = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::size_t OverlayLibrary::AddShiftedEvent(const unsigned int index, const float shiftX, const float shiftY, const float shiftZ,
+    const float lowEdge[3], const float highEdge[3], const int trackId, DepositBuffer &depositBuffer) const
+{
+    const DepositBuffer &libraryEvent(m_events.at(index));
+    const std::vector<float> &x(libraryEvent.GetX()), &y(libraryEvent.GetY()), &z(libraryEvent.GetZ());
+    const std::vector<float> &postX(libraryEvent.GetPostX()), &postY(libraryEvent.GetPostY()), &postZ(libraryEvent.GetPostZ());
+    const std::vector<float> &energy(libraryEvent.GetEnergy());
+    std::size_t nAdded(0);
+
+    for (std::size_t deposit = 0; deposit < libraryEvent.Size(); ++deposit)
+    {
+        const float shiftedX(x[deposit] + shiftX), shiftedY(y[deposit] + shiftY), shiftedZ(z[deposit] + shiftZ);
+
+        if (shiftedX < lowEdge[0] || shiftedX >= highEdge[0] || shiftedY < lowEdge[1] || shiftedY >= highEdge[1] || shiftedZ < lowEdge[2] ||
+            shiftedZ >= highEdge[2])
+        {
+            continue;
+        }
+
+        depositBuffer.Add(shiftedX, shiftedY, shiftedZ, postX[deposit] + shiftX, postY[deposit] + shiftY, postZ[deposit] + shiftZ,
+            energy[deposit], trackId);
+        ++nAdded;
+    }
+
+    return nAdded;
+}
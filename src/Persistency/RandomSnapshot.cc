@@ -0,0 +1,115 @@
+/**
+ *  @file   src/Persistency/RandomSnapshot.cc
+ *
+ *  @brief  Implementation of the RandomSnapshotWriter and RandomSnapshotReader classes.
+ *
+ *  $Log: $
+ */
+
+#include <cstring>
+#include <iostream>
+
+#include "Persistency/RandomSnapshot.hh"
+
+#include "Randomize.hh"
+
+RandomSnapshotWriter::RandomSnapshotWriter(const std::string &fileName) :
+    m_file(fileName, std::ios::binary | std::ios::trunc)
+{
+    if (!m_file.is_open())
+    {
+        std::cout << "Unable to open random snapshot file for writing : " << fileName << std::endl;
+        return;
+    }
+
+    m_file.write(RandomSnapshot::MAGIC, sizeof(RandomSnapshot::MAGIC));
+    m_file.write(reinterpret_cast<const char*>(&RandomSnapshot::VERSION), sizeof(RandomSnapshot::VERSION));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+RandomSnapshotWriter::~RandomSnapshotWriter()
+{
+    m_file.close();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void RandomSnapshotWriter::WriteEvent(const int eventNumber, const long seed)
+{
+    if (!m_file.is_open())
+        return;
+
+    const std::vector<unsigned long> engineStatus(G4Random::getTheEngine()->put());
+    const std::vector<std::uint64_t> words(engineStatus.begin(), engineStatus.end());
+
+    RandomSnapshot::EventHeader eventHeader;
+    eventHeader.m_eventNumber = eventNumber;
+    eventHeader.m_nWords = words.size();
+    eventHeader.m_seed = seed;
+
+    m_file.write(reinterpret_cast<const char*>(&eventHeader), sizeof(eventHeader));
+    m_file.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(std::uint64_t));
+
+    // ATTN : Flushed every event, as the event most worth replaying is often the one that stopped the job
+    m_file.flush();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+RandomSnapshotReader::RandomSnapshotReader(const std::string &fileName) :
+    m_isValid(false)
+{
+    std::ifstream file(fileName, std::ios::binary);
+
+    if (!file.is_open())
+    {
+        std::cout << "Unable to open random snapshot file for reading : " << fileName << std::endl;
+        return;
+    }
+
+    char magic[sizeof(RandomSnapshot::MAGIC)];
+    std::uint32_t version(0);
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+
+    if (!file || std::memcmp(magic, RandomSnapshot::MAGIC, sizeof(magic)) != 0 || version != RandomSnapshot::VERSION)
+    {
+        std::cout << "Not a random snapshot file, or unsupported version : " << fileName << std::endl;
+        return;
+    }
+
+    RandomSnapshot::EventHeader eventHeader;
+    std::vector<std::uint64_t> words;
+
+    while (file.read(reinterpret_cast<char*>(&eventHeader), sizeof(eventHeader)))
+    {
+        words.resize(eventHeader.m_nWords);
+
+        // ATTN : A record cut short by a job stopped while writing it is dropped, the records before it are still usable
+        if (!file.read(reinterpret_cast<char*>(words.data()), words.size() * sizeof(std::uint64_t)))
+            break;
+
+        m_snapshots[eventHeader.m_eventNumber] = Snapshot(eventHeader.m_seed, EngineStatus(words.begin(), words.end()));
+    }
+
+    m_isValid = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool RandomSnapshotReader::RestoreEngineStatus(const int eventNumber, long &seed) const
+{
+    const IntSnapshotMap::const_iterator iter(m_snapshots.find(eventNumber));
+
+    if (iter == m_snapshots.end())
+        return false;
+
+    // ATTN : The engine rejects a status written by a different engine type
+    if (!G4Random::getTheEngine()->get(iter->second.second))
+        return false;
+
+    seed = iter->second.first;
+    return true;
+}
@@ -0,0 +1,385 @@
+/**
+ *  @file   src/Persistency/SharedMemoryRing.cc
+ *
+ *  @brief  Implementation of the SharedMemoryRingWriter and SharedMemoryRingReader classes.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "Persistency/SharedMemoryRing.hh"
+
+namespace
+{
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "Futex words must be plain 32 bit integers");
+
+/**
+ *  @brief  Wait on a futex word in shared memory while it holds the expected value
+ *
+ *  @param  pWord the futex word
+ *  @param  expected the value the word held when the caller last looked
+ *  @param  timeout longest time to wait (ms), negative to wait until woken
+ *
+ *  @return whether the wait ended before the timeout
+ */
+bool FutexWait(std::atomic<std::uint32_t> *pWord, const std::uint32_t expected, const int timeout)
+{
+    timespec timeSpec;
+    timeSpec.tv_sec = timeout / 1000;
+    timeSpec.tv_nsec = (timeout % 1000) * 1000000L;
+
+    // ATTN : Not FUTEX_WAIT_PRIVATE, as the writer and reader are different processes
+    const long result(syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(pWord), FUTEX_WAIT, expected, timeout < 0 ? nullptr : &timeSpec,
+        nullptr, 0));
+
+    return (result == 0 || errno != ETIMEDOUT);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Increment a futex word in shared memory and wake everything waiting on it
+ *
+ *  @param  pWord the futex word
+ */
+void FutexNotify(std::atomic<std::uint32_t> *pWord)
+{
+    pWord->fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(pWord), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+SharedMemoryRingWriter::SharedMemoryRingWriter(const std::string &name, const std::uint64_t capacity, const int timeout) :
+    m_name(name),
+    m_pControlBlock(nullptr),
+    m_pRing(nullptr),
+    m_mappedSize(0),
+    m_sequence(0),
+    m_timeout(timeout),
+    m_timedOut(false)
+{
+    // ATTN : Records are 8 byte aligned, so the ring is too
+    const std::uint64_t ringCapacity((capacity + 7) & ~static_cast<std::uint64_t>(7));
+    const std::size_t mappedSize(sizeof(SharedMemoryRing::ControlBlock) + ringCapacity);
+
+    shm_unlink(m_name.c_str());
+    const int fileDescriptor(shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600));
+
+    if (fileDescriptor < 0 || ftruncate(fileDescriptor, mappedSize) != 0)
+    {
+        std::cout << "Unable to create shared memory ring " << m_name << " : " << std::strerror(errno) << std::endl;
+
+        if (fileDescriptor >= 0)
+            close(fileDescriptor);
+
+        return;
+    }
+
+    void *pMapping(mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0));
+    close(fileDescriptor);
+
+    if (pMapping == MAP_FAILED)
+    {
+        std::cout << "Unable to map shared memory ring " << m_name << " : " << std::strerror(errno) << std::endl;
+        shm_unlink(m_name.c_str());
+        return;
+    }
+
+    // ATTN : The new object is zero filled, which is the initial state of the positions and counters.  The magic string is written last, so
+    //        a reader never sees a partly initialized control block.
+    m_pControlBlock = static_cast<SharedMemoryRing::ControlBlock*>(pMapping);
+    m_pRing = static_cast<char*>(pMapping) + sizeof(SharedMemoryRing::ControlBlock);
+    m_mappedSize = mappedSize;
+    m_pControlBlock->m_version = SharedMemoryRing::VERSION;
+    m_pControlBlock->m_capacity = ringCapacity;
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(m_pControlBlock->m_magic, SharedMemoryRing::MAGIC, sizeof(SharedMemoryRing::MAGIC));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+SharedMemoryRingWriter::~SharedMemoryRingWriter()
+{
+    if (!m_pControlBlock)
+        return;
+
+    m_pControlBlock->m_closed.store(1, std::memory_order_release);
+    FutexNotify(&m_pControlBlock->m_writeNotify);
+
+    // ATTN : A reader that has the ring open keeps its mapping, and so can still read the events left in the ring
+    munmap(m_pControlBlock, m_mappedSize);
+    shm_unlink(m_name.c_str());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+SharedMemoryRing::WriteResult SharedMemoryRingWriter::WriteEvent(const int eventNumber, const long seed, const bool aborted,
+    const SharedMemoryRing::CellRecord *pCells, const std::size_t nCells, const SharedMemoryRing::MCParticleRecord *pMCParticles,
+    const std::size_t nMCParticles)
+{
+    if (!m_pControlBlock)
+        return SharedMemoryRing::TOO_LARGE;
+
+    const std::uint64_t capacity(m_pControlBlock->m_capacity);
+    const std::uint64_t cellsSize(nCells * sizeof(SharedMemoryRing::CellRecord));
+    const std::uint64_t mcParticlesSize(nMCParticles * sizeof(SharedMemoryRing::MCParticleRecord));
+    const std::uint64_t recordSize(sizeof(SharedMemoryRing::RecordHeader) + cellsSize + mcParticlesSize);
+
+    if (recordSize > capacity)
+        return SharedMemoryRing::TOO_LARGE;
+
+    // Records are contiguous, so a record that would run past the end of the ring starts again at its beginning.  The padding is published
+    // on its own, as the padding and the record together may not fit in the ring.
+    std::uint64_t writePosition(m_pControlBlock->m_writePosition.load(std::memory_order_relaxed));
+    const std::uint64_t offset(writePosition % capacity);
+
+    if (offset + recordSize > capacity)
+    {
+        const std::uint64_t nPaddingBytes(capacity - offset);
+
+        if (!this->WaitForSpace(nPaddingBytes))
+            return SharedMemoryRing::TIMED_OUT;
+
+        if (nPaddingBytes >= sizeof(SharedMemoryRing::RecordHeader))
+        {
+            SharedMemoryRing::RecordHeader paddingHeader;
+            std::memset(&paddingHeader, 0, sizeof(paddingHeader));
+            paddingHeader.m_type = SharedMemoryRing::PADDING;
+            paddingHeader.m_size = nPaddingBytes;
+            std::memcpy(m_pRing + offset, &paddingHeader, sizeof(paddingHeader));
+        }
+
+        writePosition += nPaddingBytes;
+        m_pControlBlock->m_writePosition.store(writePosition, std::memory_order_release);
+        FutexNotify(&m_pControlBlock->m_writeNotify);
+    }
+
+    // ATTN : Any padding stays published, so a later event starts at the beginning of the ring
+    if (!this->WaitForSpace(recordSize))
+        return SharedMemoryRing::TIMED_OUT;
+
+    SharedMemoryRing::RecordHeader recordHeader;
+    recordHeader.m_type = SharedMemoryRing::EVENT;
+    recordHeader.m_size = recordSize;
+    recordHeader.m_sequence = m_sequence++;
+    recordHeader.m_eventNumber = eventNumber;
+    recordHeader.m_aborted = aborted ? 1 : 0;
+    recordHeader.m_nCells = nCells;
+    recordHeader.m_nMCParticles = nMCParticles;
+    recordHeader.m_seed = seed;
+
+    char *pRecord(m_pRing + writePosition % capacity);
+    std::memcpy(pRecord, &recordHeader, sizeof(recordHeader));
+
+    if (cellsSize > 0)
+        std::memcpy(pRecord + sizeof(recordHeader), pCells, cellsSize);
+
+    if (mcParticlesSize > 0)
+        std::memcpy(pRecord + sizeof(recordHeader) + cellsSize, pMCParticles, mcParticlesSize);
+
+    m_pControlBlock->m_writePosition.store(writePosition + recordSize, std::memory_order_release);
+    FutexNotify(&m_pControlBlock->m_writeNotify);
+
+    return SharedMemoryRing::WRITTEN;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SharedMemoryRingWriter::WaitForSpace(const std::uint64_t nBytes)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const std::uint64_t capacity(m_pControlBlock->m_capacity);
+    const std::uint64_t writePosition(m_pControlBlock->m_writePosition.load(std::memory_order_relaxed));
+    const int timeout(m_timedOut ? 0 : m_timeout);
+    const Clock::time_point deadline(Clock::now() + std::chrono::milliseconds(std::max(timeout, 0)));
+    bool reported(false);
+
+    while (true)
+    {
+        const std::uint32_t readNotify(m_pControlBlock->m_readNotify.load(std::memory_order_acquire));
+        const std::uint64_t readPosition(m_pControlBlock->m_readPosition.load(std::memory_order_acquire));
+
+        if (capacity - (writePosition - readPosition) >= nBytes)
+        {
+            m_timedOut = false;
+            return true;
+        }
+
+        // ATTN : Waits are at most the report interval, so that a reader falling behind is reported before any timeout
+        const long reportInterval(10000);
+        long waitTime(reportInterval);
+
+        if (timeout >= 0)
+        {
+            const long remainingTime(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count());
+
+            if (remainingTime <= 0)
+            {
+                m_timedOut = true;
+                return false;
+            }
+
+            waitTime = std::min(waitTime, remainingTime);
+        }
+
+        if (!FutexWait(&m_pControlBlock->m_readNotify, readNotify, static_cast<int>(waitTime)) && waitTime == reportInterval && !reported)
+        {
+            std::cout << "Shared memory ring " << m_name << " is full, waiting for the reader" << std::endl;
+            reported = true;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+SharedMemoryRingReader::SharedMemoryRingReader(const std::string &name) :
+    m_pControlBlock(nullptr),
+    m_pRing(nullptr),
+    m_mappedSize(0),
+    m_currentSize(0)
+{
+    const int fileDescriptor(shm_open(name.c_str(), O_RDWR, 0));
+    struct stat fileStatus;
+
+    if (fileDescriptor < 0 || fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size < static_cast<off_t>(sizeof(SharedMemoryRing::ControlBlock)))
+    {
+        std::cout << "Unable to open shared memory ring " << name << std::endl;
+
+        if (fileDescriptor >= 0)
+            close(fileDescriptor);
+
+        return;
+    }
+
+    // ATTN : Mapped read write, as the reader publishes its position in the control block
+    void *pMapping(mmap(nullptr, fileStatus.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0));
+    close(fileDescriptor);
+
+    if (pMapping == MAP_FAILED)
+    {
+        std::cout << "Unable to map shared memory ring " << name << " : " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    SharedMemoryRing::ControlBlock *pControlBlock(static_cast<SharedMemoryRing::ControlBlock*>(pMapping));
+
+    if (std::memcmp(pControlBlock->m_magic, SharedMemoryRing::MAGIC, sizeof(SharedMemoryRing::MAGIC)) != 0 ||
+        pControlBlock->m_version != SharedMemoryRing::VERSION ||
+        sizeof(SharedMemoryRing::ControlBlock) + pControlBlock->m_capacity != static_cast<std::uint64_t>(fileStatus.st_size))
+    {
+        std::cout << "Not a shared memory ring, unsupported version, or not yet initialized : " << name << std::endl;
+        munmap(pMapping, fileStatus.st_size);
+        return;
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    m_pControlBlock = pControlBlock;
+    m_pRing = static_cast<char*>(pMapping) + sizeof(SharedMemoryRing::ControlBlock);
+    m_mappedSize = fileStatus.st_size;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+SharedMemoryRingReader::~SharedMemoryRingReader()
+{
+    if (m_pControlBlock)
+        munmap(m_pControlBlock, m_mappedSize);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SharedMemoryRingReader::NextEvent(SharedMemoryRing::EventView &eventView, const int timeout)
+{
+    if (!m_pControlBlock)
+        return false;
+
+    this->Release();
+
+    const std::uint64_t capacity(m_pControlBlock->m_capacity);
+    std::uint64_t readPosition(m_pControlBlock->m_readPosition.load(std::memory_order_relaxed));
+
+    while (true)
+    {
+        const std::uint32_t writeNotify(m_pControlBlock->m_writeNotify.load(std::memory_order_acquire));
+        const bool closed(m_pControlBlock->m_closed.load(std::memory_order_acquire) != 0);
+        const std::uint64_t writePosition(m_pControlBlock->m_writePosition.load(std::memory_order_acquire));
+
+        if (readPosition == writePosition)
+        {
+            // ATTN : The writer closes the ring after its last record, so a closed ring with nothing left to read is finished
+            if (closed || timeout == 0)
+                return false;
+
+            if (!FutexWait(&m_pControlBlock->m_writeNotify, writeNotify, timeout))
+                return false;
+
+            continue;
+        }
+
+        // Skip the end of the ring when the writer started its next record again at the beginning
+        const std::uint64_t offset(readPosition % capacity);
+        const SharedMemoryRing::RecordHeader *pHeader(reinterpret_cast<const SharedMemoryRing::RecordHeader*>(m_pRing + offset));
+
+        if (capacity - offset < sizeof(SharedMemoryRing::RecordHeader) || pHeader->m_type == SharedMemoryRing::PADDING)
+        {
+            readPosition += capacity - offset;
+            m_pControlBlock->m_readPosition.store(readPosition, std::memory_order_release);
+            FutexNotify(&m_pControlBlock->m_readNotify);
+            continue;
+        }
+
+        const char *pRecord(m_pRing + offset + sizeof(SharedMemoryRing::RecordHeader));
+        eventView.m_pHeader = pHeader;
+        eventView.m_pCells = reinterpret_cast<const SharedMemoryRing::CellRecord*>(pRecord);
+        eventView.m_pMCParticles = reinterpret_cast<const SharedMemoryRing::MCParticleRecord*>(pRecord +
+            pHeader->m_nCells * sizeof(SharedMemoryRing::CellRecord));
+        m_currentSize = pHeader->m_size;
+
+        return true;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SharedMemoryRingReader::Release()
+{
+    if (!m_pControlBlock || m_currentSize == 0)
+        return;
+
+    const std::uint64_t readPosition(m_pControlBlock->m_readPosition.load(std::memory_order_relaxed));
+    m_pControlBlock->m_readPosition.store(readPosition + m_currentSize, std::memory_order_release);
+    m_currentSize = 0;
+
+    FutexNotify(&m_pControlBlock->m_readNotify);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SharedMemoryRingReader::IsFinished() const
+{
+    if (!m_pControlBlock)
+        return true;
+
+    return (m_pControlBlock->m_closed.load(std::memory_order_acquire) != 0 && m_currentSize == 0 &&
+        m_pControlBlock->m_readPosition.load(std::memory_order_relaxed) == m_pControlBlock->m_writePosition.load(std::memory_order_acquire));
+}
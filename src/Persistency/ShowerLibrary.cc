@@ -0,0 +1,189 @@
+/**
+ *  @file   src/Persistency/ShowerLibrary.cc
+ *
+ *  @brief  Implementation of the ShowerLibraryWriter and ShowerLibraryReader classes.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Persistency/ShowerLibrary.hh"
+
+ShowerLibraryWriter::ShowerLibraryWriter()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+ShowerLibraryWriter::~ShowerLibraryWriter()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ShowerLibraryWriter::AddBin(const int pdg, const float minEnergy, const float maxEnergy)
+{
+    ShowerLibrary::Bin bin;
+    bin.m_pdg = pdg;
+    bin.m_minEnergy = minEnergy;
+    bin.m_maxEnergy = maxEnergy;
+    bin.m_firstShower = m_showers.size();
+    bin.m_nShowers = 0;
+    bin.m_padding = 0;
+    m_bins.push_back(bin);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ShowerLibraryWriter::AddShower(const float energy, const ShowerLibrary::SpotVector &spots)
+{
+    if (m_bins.empty())
+    {
+        std::cout << "ShowerLibraryWriter::AddShower - no energy bin to add shower to" << std::endl;
+        return;
+    }
+
+    ShowerLibrary::Shower shower;
+    shower.m_energy = energy;
+    shower.m_nSpots = spots.size();
+    shower.m_firstSpot = m_spots.size();
+    m_showers.push_back(shower);
+    m_spots.insert(m_spots.end(), spots.begin(), spots.end());
+    m_bins.back().m_nShowers++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ShowerLibraryWriter::Write(const std::string &fileName) const
+{
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        std::cout << "Unable to open shower library for writing : " << fileName << std::endl;
+        return false;
+    }
+
+    ShowerLibrary::FileHeader fileHeader;
+    std::memcpy(fileHeader.m_magic, ShowerLibrary::MAGIC, sizeof(fileHeader.m_magic));
+    fileHeader.m_version = ShowerLibrary::VERSION;
+    fileHeader.m_nBins = m_bins.size();
+    fileHeader.m_nShowers = m_showers.size();
+    fileHeader.m_padding = 0;
+    fileHeader.m_nSpots = m_spots.size();
+
+    file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+    file.write(reinterpret_cast<const char*>(m_bins.data()), m_bins.size() * sizeof(ShowerLibrary::Bin));
+    file.write(reinterpret_cast<const char*>(m_showers.data()), m_showers.size() * sizeof(ShowerLibrary::Shower));
+    file.write(reinterpret_cast<const char*>(m_spots.data()), m_spots.size() * sizeof(ShowerLibrary::Spot));
+
+    return file.good();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+ShowerLibraryReader::ShowerLibraryReader(const std::string &fileName) :
+    m_pMapping(nullptr),
+    m_mappingSize(0),
+    m_pBins(nullptr),
+    m_pShowers(nullptr),
+    m_pSpots(nullptr),
+    m_nBins(0)
+{
+    const int fileDescriptor(open(fileName.c_str(), O_RDONLY));
+
+    if (fileDescriptor < 0)
+    {
+        std::cout << "Unable to open shower library for reading : " << fileName << std::endl;
+        return;
+    }
+
+    struct stat fileStatus;
+
+    if (fstat(fileDescriptor, &fileStatus) != 0 || static_cast<std::size_t>(fileStatus.st_size) < sizeof(ShowerLibrary::FileHeader))
+    {
+        std::cout << "Not a shower library : " << fileName << std::endl;
+        close(fileDescriptor);
+        return;
+    }
+
+    m_mappingSize = fileStatus.st_size;
+    void *pMapping(mmap(nullptr, m_mappingSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0));
+    close(fileDescriptor);
+
+    if (pMapping == MAP_FAILED)
+    {
+        std::cout << "Unable to map shower library : " << fileName << std::endl;
+        return;
+    }
+
+    const char *pBytes(static_cast<const char*>(pMapping));
+    const ShowerLibrary::FileHeader *pFileHeader(reinterpret_cast<const ShowerLibrary::FileHeader*>(pBytes));
+    const std::size_t expectedSize(sizeof(ShowerLibrary::FileHeader) + pFileHeader->m_nBins * sizeof(ShowerLibrary::Bin) +
+        pFileHeader->m_nShowers * sizeof(ShowerLibrary::Shower) + pFileHeader->m_nSpots * sizeof(ShowerLibrary::Spot));
+
+    if (std::memcmp(pFileHeader->m_magic, ShowerLibrary::MAGIC, sizeof(pFileHeader->m_magic)) != 0 || pFileHeader->m_version != ShowerLibrary::VERSION ||
+        expectedSize != m_mappingSize)
+    {
+        std::cout << "Not a shower library, or unsupported version : " << fileName << std::endl;
+        munmap(pMapping, m_mappingSize);
+        return;
+    }
+
+    // ATTN : Every record is a multiple of 8 bytes, so the arrays are aligned within the page aligned mapping
+    m_nBins = pFileHeader->m_nBins;
+    m_pBins = reinterpret_cast<const ShowerLibrary::Bin*>(pBytes + sizeof(ShowerLibrary::FileHeader));
+    m_pShowers = reinterpret_cast<const ShowerLibrary::Shower*>(m_pBins + m_nBins);
+    m_pSpots = reinterpret_cast<const ShowerLibrary::Spot*>(m_pShowers + pFileHeader->m_nShowers);
+    m_pMapping = pMapping;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+ShowerLibraryReader::~ShowerLibraryReader()
+{
+    if (m_pMapping)
+        munmap(m_pMapping, m_mappingSize);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const ShowerLibrary::Bin *ShowerLibraryReader::FindBin(const int pdg, const double energy) const
+{
+    if (!m_pMapping)
+        return nullptr;
+
+    // Bins are sorted by pdg code then energy, so find the last bin starting at or below the energy
+    const ShowerLibrary::Bin *pBinsEnd(m_pBins + m_nBins);
+    const ShowerLibrary::Bin *pBin(std::upper_bound(m_pBins, pBinsEnd, std::make_pair(pdg, energy),
+        [](const std::pair<int, double> &key, const ShowerLibrary::Bin &bin){ return (key.first < bin.m_pdg) ||
+        (key.first == bin.m_pdg && key.second < bin.m_minEnergy);}));
+
+    if (pBin == m_pBins)
+        return nullptr;
+
+    --pBin;
+
+    if (pBin->m_pdg != pdg || energy >= pBin->m_maxEnergy || pBin->m_nShowers == 0)
+        return nullptr;
+
+    return pBin;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const ShowerLibrary::Shower &ShowerLibraryReader::GetShower(const ShowerLibrary::Bin &bin, const double random) const
+{
+    const std::uint32_t index(std::min(static_cast<std::uint32_t>(random * bin.m_nShowers), bin.m_nShowers - 1));
+    return m_pShowers[bin.m_firstShower + index];
+}
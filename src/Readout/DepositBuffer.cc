@@ -0,0 +1,207 @@
+/**
+ *  @file   src/Readout/DepositBuffer.cc
+ *
+ *  @brief  Implementation of the DepositBuffer class.
+ *
+ *  $Log: $
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "Readout/DepositBuffer.hh"
+#include "Readout/VoxelGrid.hh"
+
+DepositBuffer::DepositBuffer()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+DepositBuffer::~DepositBuffer()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DepositBuffer::Clear()
+{
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_postX.clear();
+    m_postY.clear();
+    m_postZ.clear();
+    m_energy.clear();
+    m_trackId.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DepositBuffer::Resize(const std::size_t nDeposits)
+{
+    m_x.resize(nDeposits);
+    m_y.resize(nDeposits);
+    m_z.resize(nDeposits);
+    m_postX.resize(nDeposits);
+    m_postY.resize(nDeposits);
+    m_postZ.resize(nDeposits);
+    m_energy.resize(nDeposits);
+    m_trackId.resize(nDeposits);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DepositBuffer::Reduce(const VoxelGrid &voxelGrid, CellList &cellList) const
+{
+    const std::size_t nDeposits(this->Size());
+
+    if (nDeposits == 0)
+        return;
+
+    // Voxelize in fixed size batches so that each batch of positions and indices stays in cache
+    const std::size_t batchSize(4096);
+    CellIndexVector cellIndices(nDeposits);
+
+    for (std::size_t start = 0; start < nDeposits; start += batchSize)
+    {
+        const std::size_t count(std::min(batchSize, nDeposits - start));
+        voxelGrid.GetCellIndices(&m_x[start], &m_y[start], &m_z[start], count, &cellIndices[start]);
+    }
+
+    UIntVector order(nDeposits);
+
+    for (std::size_t i = 0; i < nDeposits; ++i)
+        order[i] = static_cast<unsigned int>(i);
+
+    DepositBuffer::RadixSort(cellIndices, order);
+
+    // Segmented reduction, each run of equal cell indices becomes one cell.  The sort is stable, so track contributions keep step order.
+    IntFloatVector mcComponents;
+    std::size_t segmentStart(0);
+
+    while (segmentStart < nDeposits)
+    {
+        const CellIndex cellIndex(cellIndices[segmentStart]);
+        std::size_t segmentEnd(segmentStart);
+        float cellEnergy(0.f);
+        mcComponents.clear();
+
+        while (segmentEnd < nDeposits && cellIndices[segmentEnd] == cellIndex)
+        {
+            const unsigned int deposit(order[segmentEnd]);
+            const float energy(m_energy[deposit]);
+            const int trackId(m_trackId[deposit]);
+            cellEnergy += energy;
+
+            if (!mcComponents.empty() && mcComponents.back().first == trackId)
+            {
+                mcComponents.back().second += energy;
+            }
+            else
+            {
+                auto it = std::find_if(mcComponents.begin(), mcComponents.end(), [&trackId](const IntFloatPair &iter){ return iter.first == trackId;} );
+
+                if (it == mcComponents.end())
+                {
+                    mcComponents.push_back(IntFloatPair(trackId, energy));
+                }
+                else
+                {
+                    (*it).second += energy;
+                }
+            }
+
+            ++segmentEnd;
+        }
+
+        float x(0.f), y(0.f), z(0.f);
+        voxelGrid.GetCellCentre(cellIndex, x, y, z);
+
+        // ATTN : Cell is deleted if only used to add energy to pre-existing cell, retained otherwise
+        Cell *pCell = new Cell(x, y, z, cellIndex);
+        pCell->AddEnergy(cellEnergy);
+        cellList.AddEnergyDepositions(pCell, mcComponents);
+
+        segmentStart = segmentEnd;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DepositBuffer::SplitSteps(const float maxStepLength, DepositBuffer &splitBuffer) const
+{
+    for (std::size_t i = 0; i < this->Size(); ++i)
+    {
+        const float dX(m_postX[i] - m_x[i]), dY(m_postY[i] - m_y[i]), dZ(m_postZ[i] - m_z[i]);
+        const float stepLength(std::sqrt(dX * dX + dY * dY + dZ * dZ));
+
+        // ATTN : Short steps keep the pre step position used by the simulation, so only steps that can span several cells are moved
+        if (!(stepLength > maxStepLength))
+        {
+            splitBuffer.Add(m_x[i], m_y[i], m_z[i], m_postX[i], m_postY[i], m_postZ[i], m_energy[i], m_trackId[i]);
+            continue;
+        }
+
+        const unsigned int nSegments(static_cast<unsigned int>(std::ceil(stepLength / maxStepLength)));
+        const float segmentEnergy(m_energy[i] / nSegments);
+
+        for (unsigned int segment = 0; segment < nSegments; ++segment)
+        {
+            const float mid((segment + 0.5f) / nSegments), high(static_cast<float>(segment + 1) / nSegments);
+            splitBuffer.Add(m_x[i] + mid * dX, m_y[i] + mid * dY, m_z[i] + mid * dZ, m_x[i] + high * dX, m_y[i] + high * dY, m_z[i] + high * dZ,
+                segmentEnergy, m_trackId[i]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DepositBuffer::RadixSort(CellIndexVector &cellIndices, UIntVector &order)
+{
+    const std::size_t nEntries(cellIndices.size());
+    const unsigned int nBuckets(256);
+
+    // Only sort on the bytes that are populated by the largest index
+    const CellIndex maxCellIndex(*std::max_element(cellIndices.begin(), cellIndices.end()));
+    unsigned int nPasses(0);
+
+    for (CellIndex remainder = maxCellIndex; remainder > 0; remainder >>= 8)
+        ++nPasses;
+
+    CellIndexVector sortedCellIndices(nEntries);
+    UIntVector sortedOrder(nEntries);
+    std::vector<std::size_t> offsets(nBuckets);
+
+    for (unsigned int pass = 0; pass < nPasses; ++pass)
+    {
+        const unsigned int shift(8 * pass);
+        std::fill(offsets.begin(), offsets.end(), 0);
+
+        for (std::size_t i = 0; i < nEntries; ++i)
+            ++offsets[(cellIndices[i] >> shift) & 0xff];
+
+        // Every entry shares this byte, so the pass would not change the order
+        if (std::find(offsets.begin(), offsets.end(), nEntries) != offsets.end())
+            continue;
+
+        std::size_t total(0);
+
+        for (unsigned int bucket = 0; bucket < nBuckets; ++bucket)
+        {
+            const std::size_t count(offsets[bucket]);
+            offsets[bucket] = total;
+            total += count;
+        }
+
+        for (std::size_t i = 0; i < nEntries; ++i)
+        {
+            const std::size_t destination(offsets[(cellIndices[i] >> shift) & 0xff]++);
+            sortedCellIndices[destination] = cellIndices[i];
+            sortedOrder[destination] = order[i];
+        }
+
+        cellIndices.swap(sortedCellIndices);
+        order.swap(sortedOrder);
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ *  @file   src/Readout/VoxelGrid.cc
+ *
+ *  @brief  Implementation of the VoxelGrid class.
+ *
+ *  $Log: $
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "Readout/VoxelGrid.hh"
+
+VoxelGrid::VoxelGrid(const double xLow, const double yLow, const double zLow, const double xWidth, const double yWidth, const double zWidth,
+        const unsigned int nBinsX, const unsigned int nBinsY, const unsigned int nBinsZ, const IndexScheme indexScheme) :
+    m_xLow(xLow),
+    m_yLow(yLow),
+    m_zLow(zLow),
+    m_xBinWidth(xWidth / nBinsX),
+    m_yBinWidth(yWidth / nBinsY),
+    m_zBinWidth(zWidth / nBinsZ),
+    m_xInverseBinWidth(nBinsX / xWidth),
+    m_yInverseBinWidth(nBinsY / yWidth),
+    m_zInverseBinWidth(nBinsZ / zWidth),
+    m_nBinsX(nBinsX),
+    m_nBinsY(nBinsY),
+    m_nBinsZ(nBinsZ),
+    m_strideY(static_cast<CellIndex>(nBinsX)),
+    m_strideZ(static_cast<CellIndex>(nBinsX) * static_cast<CellIndex>(nBinsY)),
+    m_indexScheme(indexScheme),
+    m_uniformCubic(false),
+    m_specialisation(LINEAR_GENERAL)
+{
+    const double binWidthTolerance(std::numeric_limits<float>::epsilon() * m_xBinWidth);
+
+    m_uniformCubic = (nBinsX == nBinsY && nBinsX == nBinsZ && std::fabs(m_xBinWidth - m_yBinWidth) < binWidthTolerance &&
+        std::fabs(m_xBinWidth - m_zBinWidth) < binWidthTolerance);
+
+    if (MORTON == m_indexScheme)
+    {
+        m_specialisation = m_uniformCubic ? MORTON_UNIFORM_CUBIC : MORTON_GENERAL;
+    }
+    else
+    {
+        m_specialisation = m_uniformCubic ? LINEAR_UNIFORM_CUBIC : LINEAR_GENERAL;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+VoxelGrid::~VoxelGrid()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+Cell VoxelGrid::GetCell(const double x, const double y, const double z) const
+{
+    const CellIndex cellIndex(this->GetCellIndex(x, y, z));
+
+    float xCell(0.f), yCell(0.f), zCell(0.f);
+    this->GetCellCentre(cellIndex, xCell, yCell, zCell);
+
+    return Cell(xCell, yCell, zCell, cellIndex);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void VoxelGrid::GetCellCentre(const CellIndex cellIndex, float &x, float &y, float &z) const
+{
+    unsigned int xBin(0), yBin(0), zBin(0);
+    this->GetBinIndices(cellIndex, xBin, yBin, zBin);
+
+    x = m_xLow + (xBin + 0.5) * m_xBinWidth;
+    y = m_yLow + (yBin + 0.5) * m_yBinWidth;
+    z = m_zLow + (zBin + 0.5) * m_zBinWidth;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void VoxelGrid::GetBinIndices(const CellIndex cellIndex, unsigned int &xBin, unsigned int &yBin, unsigned int &zBin) const
+{
+    if (MORTON == m_indexScheme)
+    {
+        xBin = CompactBits(cellIndex);
+        yBin = CompactBits(cellIndex >> 1);
+        zBin = CompactBits(cellIndex >> 2);
+    }
+    else
+    {
+        zBin = static_cast<unsigned int>(cellIndex / m_strideZ);
+        yBin = static_cast<unsigned int>((cellIndex - zBin * m_strideZ) / m_strideY);
+        xBin = static_cast<unsigned int>(cellIndex - zBin * m_strideZ - yBin * m_strideY);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool VoxelGrid::Contains(const double x, const double y, const double z) const
+{
+    const double xBin((x - m_xLow) * m_xInverseBinWidth);
+    const double yBin((y - m_yLow) * m_yInverseBinWidth);
+    const double zBin((z - m_zLow) * m_zInverseBinWidth);
+
+    return (xBin >= 0. && xBin < m_nBinsX && yBin >= 0. && yBin < m_nBinsY && zBin >= 0. && zBin < m_nBinsZ);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool VoxelGrid::IsRepresentable(const unsigned int nBinsX, const unsigned int nBinsY, const unsigned int nBinsZ, const IndexScheme indexScheme)
+{
+    if (nBinsX == 0 || nBinsY == 0 || nBinsZ == 0)
+        return false;
+
+    if (MORTON == indexScheme)
+        return (nBinsX <= MAX_MORTON_BINS_PER_AXIS && nBinsY <= MAX_MORTON_BINS_PER_AXIS && nBinsZ <= MAX_MORTON_BINS_PER_AXIS);
+
+    // ATTN : nBinsX * nBinsY cannot overflow 64 bits, so only the final multiplication needs checking
+    const CellIndex nBinsXY(static_cast<CellIndex>(nBinsX) * static_cast<CellIndex>(nBinsY));
+    return (nBinsXY <= std::numeric_limits<CellIndex>::max() / nBinsZ);
+}